@@ -0,0 +1,104 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/root/repo/clause_set/CMakeLists.txt"
+  "/root/repo/clause_set/cnf/CMakeLists.txt"
+  "/root/repo/clause_set/pfs/CMakeLists.txt"
+  "/root/repo/clause_set/symres/CMakeLists.txt"
+  "/root/repo/common/CMakeLists.txt"
+  "/root/repo/front_end/CMakeLists.txt"
+  "/root/repo/generators/CMakeLists.txt"
+  "/root/repo/generators/pigeon/CMakeLists.txt"
+  "/root/repo/generators/planning/CMakeLists.txt"
+  "/root/repo/generators/quasigroup/CMakeLists.txt"
+  "/root/repo/pbchaff/CMakeLists.txt"
+  "/root/repo/testing/CMakeLists.txt"
+  "/root/repo/zap/CMakeLists.txt"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFile.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  "generators/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "generators/pigeon/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "generators/planning/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "generators/quasigroup/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "common/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "clause_set/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "clause_set/cnf/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "clause_set/pfs/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "clause_set/symres/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "front_end/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "pbchaff/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "zap/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "testing/CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "generators/CMakeFiles/upbench_corpus.dir/DependInfo.cmake"
+  "generators/pigeon/CMakeFiles/pigeon.dir/DependInfo.cmake"
+  "generators/pigeon/CMakeFiles/pigeonCNF.dir/DependInfo.cmake"
+  "generators/planning/CMakeFiles/random_rockets_augmented.dir/DependInfo.cmake"
+  "generators/planning/CMakeFiles/random_rockets_nonext.dir/DependInfo.cmake"
+  "generators/planning/CMakeFiles/random_action.dir/DependInfo.cmake"
+  "generators/planning/CMakeFiles/rockets_augmented_nonext.dir/DependInfo.cmake"
+  "generators/planning/CMakeFiles/rockets_augmented.dir/DependInfo.cmake"
+  "generators/planning/CMakeFiles/rockets_nonext.dir/DependInfo.cmake"
+  "generators/planning/CMakeFiles/rockets_regular.dir/DependInfo.cmake"
+  "generators/planning/CMakeFiles/rockets_state.dir/DependInfo.cmake"
+  "generators/planning/CMakeFiles/satellite.dir/DependInfo.cmake"
+  "generators/planning/CMakeFiles/satellite_state.dir/DependInfo.cmake"
+  "generators/quasigroup/CMakeFiles/quasigroup.dir/DependInfo.cmake"
+  "common/CMakeFiles/common.dir/DependInfo.cmake"
+  "clause_set/CMakeFiles/clause_set.dir/DependInfo.cmake"
+  "clause_set/cnf/CMakeFiles/cnf.dir/DependInfo.cmake"
+  "clause_set/pfs/CMakeFiles/pfs.dir/DependInfo.cmake"
+  "clause_set/symres/CMakeFiles/symres.dir/DependInfo.cmake"
+  "front_end/CMakeFiles/front_end.dir/DependInfo.cmake"
+  "pbchaff/CMakeFiles/pbchaff_solver.dir/DependInfo.cmake"
+  "pbchaff/CMakeFiles/pbchaff.dir/DependInfo.cmake"
+  "zap/CMakeFiles/zap_solver.dir/DependInfo.cmake"
+  "zap/CMakeFiles/zapsat.dir/DependInfo.cmake"
+  "zap/CMakeFiles/upbench.dir/DependInfo.cmake"
+  )
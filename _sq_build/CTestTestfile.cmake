@@ -0,0 +1,13 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_sq_build
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("generators")
+subdirs("common")
+subdirs("clause_set")
+subdirs("front_end")
+subdirs("pbchaff")
+subdirs("zap")
+subdirs("testing")
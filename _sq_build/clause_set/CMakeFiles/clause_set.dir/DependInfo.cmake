@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/clause_set/src/Converter.cpp" "clause_set/CMakeFiles/clause_set.dir/src/Converter.cpp.o" "gcc" "clause_set/CMakeFiles/clause_set.dir/src/Converter.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_sq_build/common/CMakeFiles/common.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/clause_set/cnf/CMakeFiles/cnf.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/clause_set/pfs/CMakeFiles/pfs.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/clause_set/symres/CMakeFiles/symres.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/clause_set.dir/src/Converter.cpp.o"
+  "CMakeFiles/clause_set.dir/src/Converter.cpp.o.d"
+  "libclause_set.a"
+  "libclause_set.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/clause_set.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
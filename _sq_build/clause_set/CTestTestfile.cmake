@@ -0,0 +1,9 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/clause_set
+# Build directory: /root/repo/_sq_build/clause_set
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("cnf")
+subdirs("pfs")
+subdirs("symres")
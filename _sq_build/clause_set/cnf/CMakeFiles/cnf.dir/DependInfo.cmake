@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/clause_set/cnf/src/ClauseExchange.cpp" "clause_set/cnf/CMakeFiles/cnf.dir/src/ClauseExchange.cpp.o" "gcc" "clause_set/cnf/CMakeFiles/cnf.dir/src/ClauseExchange.cpp.o.d"
+  "/root/repo/clause_set/cnf/src/Cnf.cpp" "clause_set/cnf/CMakeFiles/cnf.dir/src/Cnf.cpp.o" "gcc" "clause_set/cnf/CMakeFiles/cnf.dir/src/Cnf.cpp.o.d"
+  "/root/repo/clause_set/cnf/src/CnfPreprocessor.cpp" "clause_set/cnf/CMakeFiles/cnf.dir/src/CnfPreprocessor.cpp.o" "gcc" "clause_set/cnf/CMakeFiles/cnf.dir/src/CnfPreprocessor.cpp.o.d"
+  "/root/repo/clause_set/cnf/src/CnfRenumbering.cpp" "clause_set/cnf/CMakeFiles/cnf.dir/src/CnfRenumbering.cpp.o" "gcc" "clause_set/cnf/CMakeFiles/cnf.dir/src/CnfRenumbering.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_sq_build/common/CMakeFiles/common.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
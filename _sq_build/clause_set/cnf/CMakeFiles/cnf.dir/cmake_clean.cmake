@@ -0,0 +1,17 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/cnf.dir/src/ClauseExchange.cpp.o"
+  "CMakeFiles/cnf.dir/src/ClauseExchange.cpp.o.d"
+  "CMakeFiles/cnf.dir/src/Cnf.cpp.o"
+  "CMakeFiles/cnf.dir/src/Cnf.cpp.o.d"
+  "CMakeFiles/cnf.dir/src/CnfPreprocessor.cpp.o"
+  "CMakeFiles/cnf.dir/src/CnfPreprocessor.cpp.o.d"
+  "CMakeFiles/cnf.dir/src/CnfRenumbering.cpp.o"
+  "CMakeFiles/cnf.dir/src/CnfRenumbering.cpp.o.d"
+  "libcnf.a"
+  "libcnf.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/cnf.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,28 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/clause_set/pfs/src/Action.cpp" "clause_set/pfs/CMakeFiles/pfs.dir/src/Action.cpp.o" "gcc" "clause_set/pfs/CMakeFiles/pfs.dir/src/Action.cpp.o.d"
+  "/root/repo/clause_set/pfs/src/FullSym.cpp" "clause_set/pfs/CMakeFiles/pfs.dir/src/FullSym.cpp.o" "gcc" "clause_set/pfs/CMakeFiles/pfs.dir/src/FullSym.cpp.o.d"
+  "/root/repo/clause_set/pfs/src/GlobalProductGroup.cpp" "clause_set/pfs/CMakeFiles/pfs.dir/src/GlobalProductGroup.cpp.o" "gcc" "clause_set/pfs/CMakeFiles/pfs.dir/src/GlobalProductGroup.cpp.o.d"
+  "/root/repo/clause_set/pfs/src/GroundCache.cpp" "clause_set/pfs/CMakeFiles/pfs.dir/src/GroundCache.cpp.o" "gcc" "clause_set/pfs/CMakeFiles/pfs.dir/src/GroundCache.cpp.o.d"
+  "/root/repo/clause_set/pfs/src/LocalSearch2.cpp" "clause_set/pfs/CMakeFiles/pfs.dir/src/LocalSearch2.cpp.o" "gcc" "clause_set/pfs/CMakeFiles/pfs.dir/src/LocalSearch2.cpp.o.d"
+  "/root/repo/clause_set/pfs/src/LocalSearch3.cpp" "clause_set/pfs/CMakeFiles/pfs.dir/src/LocalSearch3.cpp.o" "gcc" "clause_set/pfs/CMakeFiles/pfs.dir/src/LocalSearch3.cpp.o.d"
+  "/root/repo/clause_set/pfs/src/Pfs.cpp" "clause_set/pfs/CMakeFiles/pfs.dir/src/Pfs.cpp.o" "gcc" "clause_set/pfs/CMakeFiles/pfs.dir/src/Pfs.cpp.o.d"
+  "/root/repo/clause_set/pfs/src/ProductSubgroup.cpp" "clause_set/pfs/CMakeFiles/pfs.dir/src/ProductSubgroup.cpp.o" "gcc" "clause_set/pfs/CMakeFiles/pfs.dir/src/ProductSubgroup.cpp.o.d"
+  "/root/repo/clause_set/pfs/src/Transport.cpp" "clause_set/pfs/CMakeFiles/pfs.dir/src/Transport.cpp.o" "gcc" "clause_set/pfs/CMakeFiles/pfs.dir/src/Transport.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_sq_build/common/CMakeFiles/common.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,27 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pfs.dir/src/Action.cpp.o"
+  "CMakeFiles/pfs.dir/src/Action.cpp.o.d"
+  "CMakeFiles/pfs.dir/src/FullSym.cpp.o"
+  "CMakeFiles/pfs.dir/src/FullSym.cpp.o.d"
+  "CMakeFiles/pfs.dir/src/GlobalProductGroup.cpp.o"
+  "CMakeFiles/pfs.dir/src/GlobalProductGroup.cpp.o.d"
+  "CMakeFiles/pfs.dir/src/GroundCache.cpp.o"
+  "CMakeFiles/pfs.dir/src/GroundCache.cpp.o.d"
+  "CMakeFiles/pfs.dir/src/LocalSearch2.cpp.o"
+  "CMakeFiles/pfs.dir/src/LocalSearch2.cpp.o.d"
+  "CMakeFiles/pfs.dir/src/LocalSearch3.cpp.o"
+  "CMakeFiles/pfs.dir/src/LocalSearch3.cpp.o.d"
+  "CMakeFiles/pfs.dir/src/Pfs.cpp.o"
+  "CMakeFiles/pfs.dir/src/Pfs.cpp.o.d"
+  "CMakeFiles/pfs.dir/src/ProductSubgroup.cpp.o"
+  "CMakeFiles/pfs.dir/src/ProductSubgroup.cpp.o.d"
+  "CMakeFiles/pfs.dir/src/Transport.cpp.o"
+  "CMakeFiles/pfs.dir/src/Transport.cpp.o.d"
+  "libpfs.a"
+  "libpfs.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pfs.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,6 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/clause_set/pfs
+# Build directory: /root/repo/_sq_build/clause_set/pfs
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
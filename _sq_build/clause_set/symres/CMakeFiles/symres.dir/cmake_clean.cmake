@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/symres.dir/src/SymRes.cpp.o"
+  "CMakeFiles/symres.dir/src/SymRes.cpp.o.d"
+  "libsymres.a"
+  "libsymres.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/symres.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/common/src/Assignment.cpp" "common/CMakeFiles/common.dir/src/Assignment.cpp.o" "gcc" "common/CMakeFiles/common.dir/src/Assignment.cpp.o.d"
+  "/root/repo/common/src/InputTheory.cpp" "common/CMakeFiles/common.dir/src/InputTheory.cpp.o" "gcc" "common/CMakeFiles/common.dir/src/InputTheory.cpp.o.d"
+  "/root/repo/common/src/ProofWriter.cpp" "common/CMakeFiles/common.dir/src/ProofWriter.cpp.o" "gcc" "common/CMakeFiles/common.dir/src/ProofWriter.cpp.o.d"
+  "/root/repo/common/src/common.cpp" "common/CMakeFiles/common.dir/src/common.cpp.o" "gcc" "common/CMakeFiles/common.dir/src/common.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,17 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/common.dir/src/Assignment.cpp.o"
+  "CMakeFiles/common.dir/src/Assignment.cpp.o.d"
+  "CMakeFiles/common.dir/src/InputTheory.cpp.o"
+  "CMakeFiles/common.dir/src/InputTheory.cpp.o.d"
+  "CMakeFiles/common.dir/src/ProofWriter.cpp.o"
+  "CMakeFiles/common.dir/src/ProofWriter.cpp.o.d"
+  "CMakeFiles/common.dir/src/common.cpp.o"
+  "CMakeFiles/common.dir/src/common.cpp.o.d"
+  "libcommon.a"
+  "libcommon.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/common.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,29 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/front_end/src/DimacsReader.cpp" "front_end/CMakeFiles/front_end.dir/src/DimacsReader.cpp.o" "gcc" "front_end/CMakeFiles/front_end.dir/src/DimacsReader.cpp.o.d"
+  "/root/repo/front_end/src/PerfCounters.cpp" "front_end/CMakeFiles/front_end.dir/src/PerfCounters.cpp.o" "gcc" "front_end/CMakeFiles/front_end.dir/src/PerfCounters.cpp.o.d"
+  "/root/repo/front_end/src/UPTesting.cpp" "front_end/CMakeFiles/front_end.dir/src/UPTesting.cpp.o" "gcc" "front_end/CMakeFiles/front_end.dir/src/UPTesting.cpp.o.d"
+  "/root/repo/front_end/src/front_end.cpp" "front_end/CMakeFiles/front_end.dir/src/front_end.cpp.o" "gcc" "front_end/CMakeFiles/front_end.dir/src/front_end.cpp.o.d"
+  "/root/repo/front_end/src/grammar.cpp" "front_end/CMakeFiles/front_end.dir/src/grammar.cpp.o" "gcc" "front_end/CMakeFiles/front_end.dir/src/grammar.cpp.o.d"
+  "/root/repo/front_end/src/tokens.cpp" "front_end/CMakeFiles/front_end.dir/src/tokens.cpp.o" "gcc" "front_end/CMakeFiles/front_end.dir/src/tokens.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_sq_build/common/CMakeFiles/common.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/clause_set/CMakeFiles/clause_set.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/clause_set/symres/CMakeFiles/symres.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/clause_set/cnf/CMakeFiles/cnf.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/clause_set/pfs/CMakeFiles/pfs.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,21 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/front_end.dir/src/DimacsReader.cpp.o"
+  "CMakeFiles/front_end.dir/src/DimacsReader.cpp.o.d"
+  "CMakeFiles/front_end.dir/src/PerfCounters.cpp.o"
+  "CMakeFiles/front_end.dir/src/PerfCounters.cpp.o.d"
+  "CMakeFiles/front_end.dir/src/UPTesting.cpp.o"
+  "CMakeFiles/front_end.dir/src/UPTesting.cpp.o.d"
+  "CMakeFiles/front_end.dir/src/front_end.cpp.o"
+  "CMakeFiles/front_end.dir/src/front_end.cpp.o.d"
+  "CMakeFiles/front_end.dir/src/grammar.cpp.o"
+  "CMakeFiles/front_end.dir/src/grammar.cpp.o.d"
+  "CMakeFiles/front_end.dir/src/tokens.cpp.o"
+  "CMakeFiles/front_end.dir/src/tokens.cpp.o.d"
+  "libfront_end.a"
+  "libfront_end.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/front_end.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
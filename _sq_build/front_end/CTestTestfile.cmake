@@ -0,0 +1,6 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/front_end
+# Build directory: /root/repo/_sq_build/front_end
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/upbench_corpus"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/upbench_corpus.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,9 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/generators
+# Build directory: /root/repo/_sq_build/generators
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("pigeon")
+subdirs("planning")
+subdirs("quasigroup")
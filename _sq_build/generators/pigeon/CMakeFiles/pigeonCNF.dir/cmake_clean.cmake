@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pigeonCNF.dir/pigeonCNF.cpp.o"
+  "CMakeFiles/pigeonCNF.dir/pigeonCNF.cpp.o.d"
+  "pigeonCNF"
+  "pigeonCNF.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pigeonCNF.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/random_action.dir/rockets_action.cpp.o"
+  "CMakeFiles/random_action.dir/rockets_action.cpp.o.d"
+  "random_action"
+  "random_action.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/random_action.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
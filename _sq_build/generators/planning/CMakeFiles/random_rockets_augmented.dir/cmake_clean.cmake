@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/random_rockets_augmented.dir/random_rockets_augmented.cpp.o"
+  "CMakeFiles/random_rockets_augmented.dir/random_rockets_augmented.cpp.o.d"
+  "random_rockets_augmented"
+  "random_rockets_augmented.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/random_rockets_augmented.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
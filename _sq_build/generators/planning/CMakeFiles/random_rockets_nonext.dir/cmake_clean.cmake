@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/random_rockets_nonext.dir/random_rockets_nonext.cpp.o"
+  "CMakeFiles/random_rockets_nonext.dir/random_rockets_nonext.cpp.o.d"
+  "random_rockets_nonext"
+  "random_rockets_nonext.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/random_rockets_nonext.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/rockets_augmented.dir/rockets_augmented.cpp.o"
+  "CMakeFiles/rockets_augmented.dir/rockets_augmented.cpp.o.d"
+  "rockets_augmented"
+  "rockets_augmented.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/rockets_augmented.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/rockets_augmented_nonext.dir/rockets_augmented_nonext.cpp.o"
+  "CMakeFiles/rockets_augmented_nonext.dir/rockets_augmented_nonext.cpp.o.d"
+  "rockets_augmented_nonext"
+  "rockets_augmented_nonext.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/rockets_augmented_nonext.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
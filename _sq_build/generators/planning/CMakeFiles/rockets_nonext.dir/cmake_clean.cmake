@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/rockets_nonext.dir/rockets_nonext.cpp.o"
+  "CMakeFiles/rockets_nonext.dir/rockets_nonext.cpp.o.d"
+  "rockets_nonext"
+  "rockets_nonext.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/rockets_nonext.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
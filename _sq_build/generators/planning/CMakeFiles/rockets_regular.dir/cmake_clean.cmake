@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/rockets_regular.dir/rockets_regular.cpp.o"
+  "CMakeFiles/rockets_regular.dir/rockets_regular.cpp.o.d"
+  "rockets_regular"
+  "rockets_regular.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/rockets_regular.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
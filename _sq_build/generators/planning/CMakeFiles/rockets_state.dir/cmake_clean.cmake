@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/rockets_state.dir/rockets_state.cpp.o"
+  "CMakeFiles/rockets_state.dir/rockets_state.cpp.o.d"
+  "rockets_state"
+  "rockets_state.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/rockets_state.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
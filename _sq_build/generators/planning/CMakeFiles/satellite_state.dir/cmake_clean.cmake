@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/satellite_state.dir/satellite_state.cpp.o"
+  "CMakeFiles/satellite_state.dir/satellite_state.cpp.o.d"
+  "satellite_state"
+  "satellite_state.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/satellite_state.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/quasigroup.dir/quasigroup.cpp.o"
+  "CMakeFiles/quasigroup.dir/quasigroup.cpp.o.d"
+  "quasigroup"
+  "quasigroup.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/quasigroup.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pbchaff.dir/main.cpp.o"
+  "CMakeFiles/pbchaff.dir/main.cpp.o.d"
+  "pbchaff"
+  "pbchaff.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pbchaff.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
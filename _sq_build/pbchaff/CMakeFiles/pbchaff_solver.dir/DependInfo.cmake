@@ -0,0 +1,33 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/pbchaff/Clause.cpp" "pbchaff/CMakeFiles/pbchaff_solver.dir/Clause.cpp.o" "gcc" "pbchaff/CMakeFiles/pbchaff_solver.dir/Clause.cpp.o.d"
+  "/root/repo/pbchaff/FastClause.cpp" "pbchaff/CMakeFiles/pbchaff_solver.dir/FastClause.cpp.o" "gcc" "pbchaff/CMakeFiles/pbchaff_solver.dir/FastClause.cpp.o.d"
+  "/root/repo/pbchaff/LazyClauseSet.cpp" "pbchaff/CMakeFiles/pbchaff_solver.dir/LazyClauseSet.cpp.o" "gcc" "pbchaff/CMakeFiles/pbchaff_solver.dir/LazyClauseSet.cpp.o.d"
+  "/root/repo/pbchaff/Mod2ClauseSet.cpp" "pbchaff/CMakeFiles/pbchaff_solver.dir/Mod2ClauseSet.cpp.o" "gcc" "pbchaff/CMakeFiles/pbchaff_solver.dir/Mod2ClauseSet.cpp.o.d"
+  "/root/repo/pbchaff/PBClauseSet.cpp" "pbchaff/CMakeFiles/pbchaff_solver.dir/PBClauseSet.cpp.o" "gcc" "pbchaff/CMakeFiles/pbchaff_solver.dir/PBClauseSet.cpp.o.d"
+  "/root/repo/pbchaff/PartialAssignment.cpp" "pbchaff/CMakeFiles/pbchaff_solver.dir/PartialAssignment.cpp.o" "gcc" "pbchaff/CMakeFiles/pbchaff_solver.dir/PartialAssignment.cpp.o.d"
+  "/root/repo/pbchaff/Solver.cpp" "pbchaff/CMakeFiles/pbchaff_solver.dir/Solver.cpp.o" "gcc" "pbchaff/CMakeFiles/pbchaff_solver.dir/Solver.cpp.o.d"
+  "/root/repo/pbchaff/TimeTracker.cpp" "pbchaff/CMakeFiles/pbchaff_solver.dir/TimeTracker.cpp.o" "gcc" "pbchaff/CMakeFiles/pbchaff_solver.dir/TimeTracker.cpp.o.d"
+  "/root/repo/pbchaff/UPTestingPB.cpp" "pbchaff/CMakeFiles/pbchaff_solver.dir/UPTestingPB.cpp.o" "gcc" "pbchaff/CMakeFiles/pbchaff_solver.dir/UPTestingPB.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_sq_build/front_end/CMakeFiles/front_end.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/clause_set/CMakeFiles/clause_set.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/clause_set/symres/CMakeFiles/symres.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/clause_set/cnf/CMakeFiles/cnf.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/clause_set/pfs/CMakeFiles/pfs.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/common/CMakeFiles/common.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,27 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pbchaff_solver.dir/Clause.cpp.o"
+  "CMakeFiles/pbchaff_solver.dir/Clause.cpp.o.d"
+  "CMakeFiles/pbchaff_solver.dir/FastClause.cpp.o"
+  "CMakeFiles/pbchaff_solver.dir/FastClause.cpp.o.d"
+  "CMakeFiles/pbchaff_solver.dir/LazyClauseSet.cpp.o"
+  "CMakeFiles/pbchaff_solver.dir/LazyClauseSet.cpp.o.d"
+  "CMakeFiles/pbchaff_solver.dir/Mod2ClauseSet.cpp.o"
+  "CMakeFiles/pbchaff_solver.dir/Mod2ClauseSet.cpp.o.d"
+  "CMakeFiles/pbchaff_solver.dir/PBClauseSet.cpp.o"
+  "CMakeFiles/pbchaff_solver.dir/PBClauseSet.cpp.o.d"
+  "CMakeFiles/pbchaff_solver.dir/PartialAssignment.cpp.o"
+  "CMakeFiles/pbchaff_solver.dir/PartialAssignment.cpp.o.d"
+  "CMakeFiles/pbchaff_solver.dir/Solver.cpp.o"
+  "CMakeFiles/pbchaff_solver.dir/Solver.cpp.o.d"
+  "CMakeFiles/pbchaff_solver.dir/TimeTracker.cpp.o"
+  "CMakeFiles/pbchaff_solver.dir/TimeTracker.cpp.o.d"
+  "CMakeFiles/pbchaff_solver.dir/UPTestingPB.cpp.o"
+  "CMakeFiles/pbchaff_solver.dir/UPTestingPB.cpp.o.d"
+  "libpbchaff_solver.a"
+  "libpbchaff_solver.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pbchaff_solver.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
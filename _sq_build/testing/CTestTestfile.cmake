@@ -0,0 +1,86 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/testing
+# Build directory: /root/repo/_sq_build/testing
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(duplicate_literals_P0 "/root/repo/_sq_build/zap/zapsat" "/root/repo/testing/cnf/duplicate_literals.cnf" "-P" "0")
+set_tests_properties(duplicate_literals_P0 PROPERTIES  PASS_REGULAR_EXPRESSION "Result:  SAT
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;6;add_test;/root/repo/testing/CMakeLists.txt;12;add_dimacs_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(duplicate_literals_P1 "/root/repo/_sq_build/zap/zapsat" "/root/repo/testing/cnf/duplicate_literals.cnf" "-P" "1")
+set_tests_properties(duplicate_literals_P1 PROPERTIES  PASS_REGULAR_EXPRESSION "Result:  SAT
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;6;add_test;/root/repo/testing/CMakeLists.txt;12;add_dimacs_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(contradictory_units_P0 "/root/repo/_sq_build/zap/zapsat" "/root/repo/testing/cnf/contradictory_units.cnf" "-P" "0")
+set_tests_properties(contradictory_units_P0 PROPERTIES  PASS_REGULAR_EXPRESSION "Result:  UNSAT
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;6;add_test;/root/repo/testing/CMakeLists.txt;13;add_dimacs_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(contradictory_units_P1 "/root/repo/_sq_build/zap/zapsat" "/root/repo/testing/cnf/contradictory_units.cnf" "-P" "1")
+set_tests_properties(contradictory_units_P1 PROPERTIES  PASS_REGULAR_EXPRESSION "Result:  UNSAT
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;6;add_test;/root/repo/testing/CMakeLists.txt;13;add_dimacs_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(tautologies_sat_P0 "/root/repo/_sq_build/zap/zapsat" "/root/repo/testing/cnf/tautologies_sat.cnf" "-P" "0")
+set_tests_properties(tautologies_sat_P0 PROPERTIES  PASS_REGULAR_EXPRESSION "Result:  SAT
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;6;add_test;/root/repo/testing/CMakeLists.txt;14;add_dimacs_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(tautologies_sat_P1 "/root/repo/_sq_build/zap/zapsat" "/root/repo/testing/cnf/tautologies_sat.cnf" "-P" "1")
+set_tests_properties(tautologies_sat_P1 PROPERTIES  PASS_REGULAR_EXPRESSION "Result:  SAT
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;6;add_test;/root/repo/testing/CMakeLists.txt;14;add_dimacs_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(tautologies_unsat_P0 "/root/repo/_sq_build/zap/zapsat" "/root/repo/testing/cnf/tautologies_unsat.cnf" "-P" "0")
+set_tests_properties(tautologies_unsat_P0 PROPERTIES  PASS_REGULAR_EXPRESSION "Result:  UNSAT
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;6;add_test;/root/repo/testing/CMakeLists.txt;15;add_dimacs_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(tautologies_unsat_P1 "/root/repo/_sq_build/zap/zapsat" "/root/repo/testing/cnf/tautologies_unsat.cnf" "-P" "1")
+set_tests_properties(tautologies_unsat_P1 PROPERTIES  PASS_REGULAR_EXPRESSION "Result:  UNSAT
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;6;add_test;/root/repo/testing/CMakeLists.txt;15;add_dimacs_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(empty_clause_P0 "/root/repo/_sq_build/zap/zapsat" "/root/repo/testing/cnf/empty_clause.cnf" "-P" "0")
+set_tests_properties(empty_clause_P0 PROPERTIES  PASS_REGULAR_EXPRESSION "Result:  UNSAT
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;6;add_test;/root/repo/testing/CMakeLists.txt;16;add_dimacs_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(empty_clause_P1 "/root/repo/_sq_build/zap/zapsat" "/root/repo/testing/cnf/empty_clause.cnf" "-P" "1")
+set_tests_properties(empty_clause_P1 PROPERTIES  PASS_REGULAR_EXPRESSION "Result:  UNSAT
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;6;add_test;/root/repo/testing/CMakeLists.txt;16;add_dimacs_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(portfolio_model "/root/repo/_sq_build/zap/zapsat" "/root/repo/testing/cnf/duplicate_literals.cnf" "-j" "2" "-P" "1" "-R" "1")
+set_tests_properties(portfolio_model PROPERTIES  PASS_REGULAR_EXPRESSION "model checked against the input clauses" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;20;add_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(cubes_model "/root/repo/_sq_build/zap/zapsat" "/root/repo/testing/cnf/duplicate_literals.cnf" "-k" "4" "-j" "2" "-P" "1" "-R" "1")
+set_tests_properties(cubes_model PROPERTIES  PASS_REGULAR_EXPRESSION "model checked against the input clauses" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;21;add_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(strengthened_sat "/root/repo/_sq_build/pbchaff/pbchaff" "/root/repo/testing/opb/strengthened_sat.opb")
+set_tests_properties(strengthened_sat PROPERTIES  PASS_REGULAR_EXPRESSION "model checked against the input constraints
+s SATISFIABLE
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;30;add_test;/root/repo/testing/CMakeLists.txt;41;add_opb_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(strengthened_unsat "/root/repo/_sq_build/pbchaff/pbchaff" "/root/repo/testing/opb/strengthened_unsat.opb")
+set_tests_properties(strengthened_unsat PROPERTIES  PASS_REGULAR_EXPRESSION "s UNSATISFIABLE
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;30;add_test;/root/repo/testing/CMakeLists.txt;42;add_opb_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(optimum_after_cores "/root/repo/_sq_build/pbchaff/pbchaff" "/root/repo/testing/opb/optimum_after_cores.opb")
+set_tests_properties(optimum_after_cores PROPERTIES  PASS_REGULAR_EXPRESSION "
+o 4
+c  Solution Statistics.*model checked against the input constraints
+s OPTIMUM FOUND
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;30;add_test;/root/repo/testing/CMakeLists.txt;43;add_opb_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(optimum_1 "/root/repo/_sq_build/pbchaff/pbchaff" "/root/repo/testing/opb/optimum_1.opb")
+set_tests_properties(optimum_1 PROPERTIES  PASS_REGULAR_EXPRESSION "
+o 1
+c  Solution Statistics.*model checked against the input constraints
+s OPTIMUM FOUND
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;30;add_test;/root/repo/testing/CMakeLists.txt;44;add_opb_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(optimum_6 "/root/repo/_sq_build/pbchaff/pbchaff" "/root/repo/testing/opb/optimum_6.opb")
+set_tests_properties(optimum_6 PROPERTIES  PASS_REGULAR_EXPRESSION "
+o 6
+c  Solution Statistics.*model checked against the input constraints
+s OPTIMUM FOUND
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;30;add_test;/root/repo/testing/CMakeLists.txt;45;add_opb_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(optimum_8 "/root/repo/_sq_build/pbchaff/pbchaff" "/root/repo/testing/opb/optimum_8.opb")
+set_tests_properties(optimum_8 PROPERTIES  PASS_REGULAR_EXPRESSION "
+o 8
+c  Solution Statistics.*model checked against the input constraints
+s OPTIMUM FOUND
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;30;add_test;/root/repo/testing/CMakeLists.txt;46;add_opb_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(optimum_negative "/root/repo/_sq_build/pbchaff/pbchaff" "/root/repo/testing/opb/optimum_negative.opb")
+set_tests_properties(optimum_negative PROPERTIES  PASS_REGULAR_EXPRESSION "
+o -3
+c  Solution Statistics.*model checked against the input constraints
+s OPTIMUM FOUND
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;30;add_test;/root/repo/testing/CMakeLists.txt;47;add_opb_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(constant_objective "/root/repo/_sq_build/pbchaff/pbchaff" "/root/repo/testing/opb/constant_objective.opb")
+set_tests_properties(constant_objective PROPERTIES  PASS_REGULAR_EXPRESSION "
+o 0
+c  Solution Statistics.*model checked against the input constraints
+s OPTIMUM FOUND
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;30;add_test;/root/repo/testing/CMakeLists.txt;48;add_opb_test;/root/repo/testing/CMakeLists.txt;0;")
+add_test(objective_unsat "/root/repo/_sq_build/pbchaff/pbchaff" "/root/repo/testing/opb/objective_unsat.opb")
+set_tests_properties(objective_unsat PROPERTIES  PASS_REGULAR_EXPRESSION "s UNSATISFIABLE
+" _BACKTRACE_TRIPLES "/root/repo/testing/CMakeLists.txt;30;add_test;/root/repo/testing/CMakeLists.txt;49;add_opb_test;/root/repo/testing/CMakeLists.txt;0;")
@@ -0,0 +1,27 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/zap/upbench.cpp" "zap/CMakeFiles/upbench.dir/upbench.cpp.o" "gcc" "zap/CMakeFiles/upbench.dir/upbench.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_sq_build/zap/CMakeFiles/zap_solver.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/pbchaff/CMakeFiles/pbchaff_solver.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/front_end/CMakeFiles/front_end.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/clause_set/CMakeFiles/clause_set.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/clause_set/symres/CMakeFiles/symres.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/clause_set/cnf/CMakeFiles/cnf.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/clause_set/pfs/CMakeFiles/pfs.dir/DependInfo.cmake"
+  "/root/repo/_sq_build/common/CMakeFiles/common.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
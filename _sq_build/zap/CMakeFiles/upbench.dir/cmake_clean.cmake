@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/upbench.dir/upbench.cpp.o"
+  "CMakeFiles/upbench.dir/upbench.cpp.o.d"
+  "upbench"
+  "upbench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/upbench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,17 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/zap_solver.dir/UPTestingLocal.cpp.o"
+  "CMakeFiles/zap_solver.dir/UPTestingLocal.cpp.o.d"
+  "CMakeFiles/zap_solver.dir/cubes.cpp.o"
+  "CMakeFiles/zap_solver.dir/cubes.cpp.o.d"
+  "CMakeFiles/zap_solver.dir/portfolio.cpp.o"
+  "CMakeFiles/zap_solver.dir/portfolio.cpp.o.d"
+  "CMakeFiles/zap_solver.dir/solver.cpp.o"
+  "CMakeFiles/zap_solver.dir/solver.cpp.o.d"
+  "libzap_solver.a"
+  "libzap_solver.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/zap_solver.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/zapsat.dir/main.cpp.o"
+  "CMakeFiles/zapsat.dir/main.cpp.o.d"
+  "zapsat"
+  "zapsat.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/zapsat.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
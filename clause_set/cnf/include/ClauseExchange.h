@@ -0,0 +1,58 @@
+#ifndef __CLAUSE_EXCHANGE__
+#define __CLAUSE_EXCHANGE__
+
+#include <atomic>
+#include <vector>
+#include "common.h"
+using namespace std;
+
+namespace zap
+{
+
+#define EXCHANGE_CAPACITY   4096   // number of slots in the ring
+#define EXCHANGE_MAX_SIZE   32     // longest clause a slot can hold
+
+
+/*  A ClauseExchange is how solvers running on different threads pass learned clauses to each
+    other.  It's a fixed size ring of slots.  Writers grab the next position with an atomic
+    counter and copy the clause into the slot at that position.  Nobody ever waits.  If the ring
+    wraps around before a reader gets to a clause, the reader just misses it, and if two writers
+    land on the same slot at the same time one of them drops its clause.  Losing the odd clause
+    costs us nothing but a little lost information.
+
+    Each slot has a sequence number that says which position it currently holds and whether it's
+    finished being written (2*position+2) or is still being written (2*position+1).  Readers check
+    the sequence number before and after copying a clause out and throw the copy away if it
+    changed underneath them.  Everything in a slot is atomic so this is all well defined.
+
+    Each reader keeps its own cursor, the next position it wants to read.  Clauses are tagged with
+    the worker that wrote them so nobody imports their own clauses.
+ */
+
+class ExchangeSlot {
+public:
+  atomic<size_t>  sequence;
+  atomic<size_t>  worker;
+  atomic<size_t>  size;
+  atomic<int>     lits[EXCHANGE_MAX_SIZE];
+
+  ExchangeSlot() : sequence(0), worker(0), size(0) {
+    for (size_t i=0; i < EXCHANGE_MAX_SIZE; i++) lits[i] = 0;
+  }
+};
+
+
+class ClauseExchange {
+  vector<ExchangeSlot>  m_slots;
+  atomic<size_t>        m_head;      // next position to be written
+  
+public:
+  ClauseExchange(size_t capacity = EXCHANGE_CAPACITY) : m_slots(capacity), m_head(0) { }
+
+  bool    publish(const vector<Literal>& c, size_t worker);    // false if the clause was dropped
+  size_t  collect(size_t& cursor, size_t worker, vector<Clause>& clauses) const;
+};
+
+
+} // end namespace zap
+#endif
@@ -4,6 +4,8 @@
 #include <vector>
 #include "ClauseSet.h"
 #include "FastSet.h"
+#include "ClauseExchange.h"
+#include "ProofWriter.h"
 using namespace std;
 
 namespace zap
@@ -13,12 +15,77 @@ namespace zap
 
 /////////////////////////////   CNF CLAUSE   ///////////////////////////////////
 
+/*  A CnfClause is a light weight view of a clause stored in the Cnf literal arena.  It's
+    just a pointer to the first literal and a size.  It behaves like a read/write array of literals
+    so code that walks clauses doesn't care where the literals live.  A view is invalidated
+    when clauses are added to the arena (the arena may reallocate), so don't hang on to one
+    across calls that add clauses.
+ */
+
+class CnfClause {
+  Literal*   m_lits;
+  size_t     m_size;
+public:
+  CnfClause(Literal* lits = NULL, size_t sz = 0) : m_lits(lits), m_size(sz) { }
+
+  size_t          size()                 const { return m_size; }
+  bool            empty()                const { return m_size == 0; }
+  Literal&        operator[](size_t i)         { return m_lits[i]; }
+  const Literal&  operator[](size_t i)   const { return m_lits[i]; }
+  Literal*        begin()                      { return m_lits; }
+  Literal*        end()                        { return m_lits + m_size; }
+  const Literal*  begin()                const { return m_lits; }
+  const Literal*  end()                  const { return m_lits + m_size; }
+};
+
+
+/*  Everything else we know about a stored clause.  The literals live in the arena starting at
+    offset.  group is an index into the Cnf's table of group names (used by SymRes).  imported
+    marks a clause learned by another solver that hasn't been used in conflict analysis yet.
+    Learned clauses also have their lbd, the tier of the clause database they're in and whether
+    conflict analysis has used them since the last time we reduced the database.  */
+
+enum ClauseTier { TIER_CORE, TIER_2, TIER_LOCAL };
+
+#define CORE_LBD     2    // learned clauses with an lbd this small are kept for good
+#define TIER_2_LBD   6    // and these are kept as long as they're being used
+
+inline unsigned char clause_tier(size_t lbd)
+{
+  return (lbd <= CORE_LBD ? TIER_CORE : (lbd <= TIER_2_LBD ? TIER_2 : TIER_LOCAL));
+}
+
+class CnfClauseHeader {
+public:
+  size_t          offset;
+  size_t          size;
+  double          score;
+  size_t          group;
+  bool            imported;
+  bool            used;
+  unsigned char   tier;
+  unsigned        lbd;
+  CnfClauseHeader(size_t o = 0, size_t sz = 0, size_t g = 0)
+	: offset(o), size(sz), score(0), group(g), imported(false), used(false), tier(TIER_LOCAL), lbd(0) { }
+};
+
 
-class CnfClause : public Clause {
+/*  A watcher is the clauseID of a watched clause together with a blocking literal from that
+    clause.  If the blocker is satisfied the clause is too and we can skip it without looking
+    at the clause at all.  Binary clauses aren't watched, they go in binary_list, and there
+    the blocker is the other literal of the clause, the one that gets implied.  */
+
+class CnfWatcher {
 public:
-  CnfClause() { }
-  CnfClause(const Clause& c) : Clause(c) { }
-  friend ostream& operator<<(ostream& os, const Clause& c);
+  ClauseID   id;
+  Literal    blocker;
+  CnfWatcher(ClauseID i = NULL_ID, Literal b = Literal()) : id(i), blocker(b) { }
+};
+
+class CnfVariableWatch {
+public:
+  vector<CnfWatcher>  watch_list[2];
+  vector<CnfWatcher>  binary_list[2];
 };
 
 
@@ -29,34 +96,45 @@ public:
     the ClauseSet interface so we can hide as much as possible the details of working with
     this type of constraint set from the high-level solver code.  
     
-    We store all the clauses in one big vector. Since a clause is implemented as a vector<size_t>,
-    the whole thing is a vector<vector<size_t> >.  The original set of input clauses are at
-    the beginning of the vector and learned clauses come after that.  This is different from
-    what I've seen in most other solvers that either do their own memory management for clauses
-    or allocate clauses on the heap.  The major benefit of doing it this way is that it makes for
-    simple easily readable code.  Watchers are just clauseIDs (ints) instead of pointers.
-    It has an additional advantage: because we sort learned clauses by how often they are used
-    and delete those that are less frequently used, highly used clauses are grouped together in
-    the vector and this appears to improve cache performance.  The down sides to this approach
-    are 1) performance and 2) Watchers become invalid when we shuffle the order of the clauses
-    in the vector.  I was happy to find that experimentally the overall performance degradation
-    is insignificant when compared to rsat.  The code to update the watchers after shuffling the
-    list of clauses is the price paid, but I grouped it seperately so you don't have to look at
-    it if you don't want to.  
-
-    We keep an extra clause at the end of the vector after all the learned clauses.  This is
-    temporary storage for the learning process.  We generate numerous clauses during learning
-    and we don't always add them to the clause set.  The extra clause allows us a temporary
-    storage space for these clauses that can be accesses in the high-level solver code just like
-    any other clause.  If we decide we want to keep a clause we call add_clause.  This commits
-    it to the clause database.
+    We store the literals of all the clauses one after another in one big vector (the arena) and
+    keep a second vector of clause headers indexed by clauseID that says where each clause starts,
+    how long it is and what its score is.  The original set of input clauses are at the beginning
+    of both vectors and learned clauses come after that.  There are no per-clause heap allocations
+    so walking the clauses during unit propagation stays in one contiguous block of memory.
+    Watchers are just clauseIDs (ints) instead of pointers.  Because we sort learned clauses by how
+    often they are used and delete those that are less frequently used, highly used clauses are
+    grouped together in the arena and this appears to improve cache performance.  The down side to
+    this approach is that Watchers become invalid when we shuffle the order of the clauses.  The code
+    to update the watchers after shuffling the list of clauses is the price paid, but I grouped it
+    seperately so you don't have to look at it if you don't want to.  
+
+    We keep an extra clause after all the learned clauses.  This is temporary storage for the
+    learning process.  We generate numerous clauses during learning and we don't always add them
+    to the clause set.  The extra clause allows us a temporary storage space for these clauses that
+    can be accesses in the high-level solver code just like any other clause.  Its clauseID is
+    always number_clauses().  If we decide we want to keep a clause we call add_learned_clause.  This
+    commits it to the clause database.
+
+    Conflict analysis doesn't allocate.  resolve is called once per resolution step, but it only
+    marks the variables of the new reason in m_seen and walks the assignment stack down from
+    where the last step stopped.  The literals from earlier decision levels go straight into the
+    temporary clause, and the ones at the current level are never written out, since all we need
+    is how many are left.  Each conflict gets a new m_seen_stamp so nothing has to be cleared.
 
     
-    Clauses are indexed by the watched literal method.   A Watcher for a literal l in a clause c is
-    a clauseID (int) that gives the index position of the clause in the main vector.  The first two
-    lits every clause are always the two watched lits, so l will be in one of these positions.  Every
-    clause gets two Watchers and all Watchers are stored in m_watchers.  This allows us in the
-    get_implications function to walk all clauses that have a watcher on a particular literal l.
+    Binary clauses get special treatment.  Instead of watching them, every literal keeps a list
+    of the binary clauses it appears in along with the other literal in each clause.  When a literal
+    is falsified get_implications runs through its binary list first and extends the assignment
+    with the other literals directly, never looking at the clauses themselves.  Since binary clauses
+    are never reordered, a binary reason doesn't necessarily have the implied literal first, so
+    conflict analysis skips the resolved variable rather than position 0.
+
+    All other clauses are indexed by the watched literal method.   A Watcher for a literal l in a clause c is
+    a clauseID (int) that gives the index position of the clause in the header vector plus a blocking
+    literal.  The first two lits every clause are always the two watched lits, so l will be in one of
+    these positions.  Every clause gets two Watchers and all Watchers are stored in m_watchers.  This
+    allows us in the get_implications function to walk all clauses that have a watcher on a particular
+    literal l.
 
     There are a bunch of data structures for maintaining scores.  We keep scores for every variable
     (vsids scores) and for every clause.  The variable scores are sort of statisticalish counts of
@@ -65,22 +143,45 @@ public:
     unit propagation (see solver/Assignment.h).  The clause scores are statisticalish counts of
     how often clauses are used during learning.  We use them to sort the learned clause list and
     decide which clauses to delete when the number of learned clauses gets to big.  The score
-    for a particular clause c is stored in the actual clause.  
-
-    When the number of clauses gets to be too big we delete a whole bunch of learned clauses.
-    This code is all modelled on the rsat code.  I've copied their heuristic choices as closely as
-    possible.
+    for a particular clause c is stored in its header.  
+
+    Before a learned clause is stored we minimize it.  A literal can go if every other literal in
+    its reason is already in the clause, false at level 0, or can go itself for the same reason
+    (MiniSat's recursive minimization).  We compute its lbd, the number of decision levels among
+    its literals, at the same time.
+
+    When the number of clauses gets to be too big we reduce the learned clauses.  They're kept
+    in three tiers by lbd, like the glucose family of solvers do.  Core clauses (lbd <= 2) are
+    never deleted.  Tier 2 clauses (lbd <= 6) are kept as long as conflict analysis keeps using
+    them and drop to the local tier after going a whole reduction without being used.  The local
+    tier is sorted by score and the worse half is deleted, apart from reasons and binary clauses.
+    Each time a learned clause takes part in conflict analysis its score goes up and its lbd is
+    recomputed, and if the lbd got smaller the clause can move up a tier.
+    
+    When several solvers work on the same problem (see zap/portfolio.h) each one has its own Cnf
+    and they pass learned clauses to each other through a ClauseExchange.  Short learned clauses
+    that span only a few decision levels (and all unit and binary ones) are published as we learn
+    them.  The ones the other solvers published are imported when we're back at decision level 0,
+    where we can simplify them against the level 0 assignments before adding them.
+
+    Given a ProofWriter (log_proof) we write every clause we learn or import to it as a DRAT
+    lemma and every learned clause we throw away as a deletion.  The solver adds the empty
+    clause at the end when it finds the problem is UNSAT.
  */
 
 
 
-class Cnf : public vector<CnfClause>, public virtual ClauseSet
+class Cnf : public virtual ClauseSet
 {
  protected:
-  size_t                 m_num_vars;
-  size_t                 m_num_clauses;
-  size_t                 m_end_original_clauses; // marks end of original input and beginning of learned clauses
-  vector<VariableWatch>  m_watchers;
+  size_t                   m_num_vars;
+  size_t                   m_end_original_clauses; // marks end of original input and beginning of learned clauses
+  vector<Literal>          m_literals;             // the arena
+  vector<CnfClauseHeader>  m_clauses;              // indexed by clauseID
+  Clause                   m_learned_clause;       // temporary storage for learning, clauseID is number_clauses()
+  vector<string>           m_group_names;
+  size_t                   m_input_group;          // group of the clauses added by append_input_clause
+  vector<CnfVariableWatch> m_watchers;
 
   // this stuff is all for maintaining vsids scores and clause scores
   vector<double >        m_vsids_counts;
@@ -88,30 +189,78 @@ class Cnf : public vector<CnfClause>, public virtual ClauseSet
   double                 m_clause_score_inc;
   FastSet                m_score_set;  // used in incrementing vsids scores
   double                 m_max_clauseset_size;
-  vector<bool>           seen;
+  vector<unsigned>       m_seen;                 // m_seen[v] == m_seen_stamp if v is marked in this analysis
+  unsigned               m_seen_stamp;
+  vector<Variable>       m_minimize_stack;       // for minimize_learned_clause
+  vector<Variable>       m_minimize_marked;      // variables it marked seen, to undo a failure
+  bool                   m_minimize;             // SymRes turns minimization off
   bool                   first_round;
-  CnfClause              resolve_clause;
+  int                    top;                    // where resolve is in the assignment stack
+  size_t                 local_lits_this_level;
+
+  // sharing learned clauses with other solvers
+  ClauseExchange*        m_exchange;
+  size_t                 m_worker;
+  size_t                 m_exchange_cursor;
+  vector<size_t>         m_level_stamp;          // for counting decision levels in lbd
+  size_t                 m_stamp;
+
+  ProofWriter*           m_proof;                // NULL unless we're writing a DRAT proof
   
   void      increment_variable_score(size_t v);
   void      rescale_variable_scores();
   void      rescale_clause_scores();
   void      increment_clause_score(ClauseID id);
 
+  // adding clauses to the arena
+  ClauseID  append_clause(const vector<Literal>& c, size_t group = 0);
+  void      watch_clause(ClauseID id);
+  size_t    intern_group(const string& name);
+
   // these functions are all for bounding/reducing the size of the learned clause set
-  void      remove_permanently_sat_clauses(const Assignment& P);
-  void      remove_irrelevant_clauses(const Assignment& P);
-  void      update_pointers(Assignment& P, size_t max_id);
+  void      remove_permanently_sat_clauses(const Assignment& P, vector<int>& indexes);
+  void      remove_irrelevant_clauses(const Assignment& P, vector<int>& indexes);
+  void      rebuild_arena(const vector<ClauseID>& order, vector<int>& indexes);
+  void      update_pointers(Assignment& P, const vector<int>& indexes);
   bool      satisfied_at_level_0(const Assignment& P, ClauseID id);
   bool      is_a_reason(const Assignment& P, ClauseID id) const;
-
-  size_t    add_to_analysis(const CnfClause& c, const Assignment& P);
+  void      log_deletion(ClauseID id);
+
+  void      start_analysis();
+  bool      seen(Variable v) const { return m_seen[v] == m_seen_stamp; }
+  void      mark_seen(Variable v)    { m_seen[v] = m_seen_stamp; }
+  void      unmark_seen(Variable v)  { m_seen[v] = 0; }
+  size_t    add_to_analysis(const CnfClause& c, const Assignment& P, Variable pivot);
+  void      note_clause_use(ClauseID id, const Assignment& P);
+  void      minimize_learned_clause(const Assignment& P);
+  bool      redundant(Literal l, const Assignment& P, unsigned levels);
+
+  // sharing
+  size_t    lbd(const Literal* lits, size_t size, const Assignment& P);
+  void      export_learned_clause(const Clause& c, size_t glue);
+  Result    import_clause(const Clause& c, Assignment& P);
   
 public:
-  Cnf() : m_num_vars(0), m_num_clauses(0) { }
+  Cnf() : m_num_vars(0), m_end_original_clauses(0), m_input_group(0), m_seen_stamp(0), m_minimize(true), first_round(true), m_exchange(NULL), m_worker(0),
+		  m_exchange_cursor(0), m_stamp(0), m_proof(NULL) { }
   Cnf(const InputTheory& intput);
   Cnf(const vector<Clause>& clauses);
   void initialize_clause_set(const vector<Clause>& clauses);
-  size_t    number_clauses()                           const { return m_num_clauses; }
+
+  // building the original clauses one at a time without a vector<Clause> in between (see
+  // front_end/DimacsReader.h).  All the atoms must be in global_vars.atom_name_map before finish_input.
+  void      begin_input(size_t number_clauses, size_t number_lits);
+  ClauseID  append_input_clause(const Literal* lits, size_t size);
+  void      finish_input();
+
+  size_t    number_clauses()                           const { return m_clauses.size(); }
+  ClauseID  learned_clause_id()                        const { return m_clauses.size(); }
+
+  CnfClause        operator[](ClauseID id);
+  const CnfClause  operator[](ClauseID id) const;
+  const string&    group_name(ClauseID id) const;
+  void             share_clauses(ClauseExchange* exchange, size_t worker);
+  void             log_proof(ProofWriter* proof) { m_proof = proof; }
 
   // the ClauseSet interface functions
   size_t    number_variables()                         const { return m_num_vars; }
@@ -122,8 +271,9 @@ public:
   void      add_learned_clause(ClauseID c_id, const Assignment& P);
   Result    load_unit_literals(Assignment& P);
   void      reduce_knowledge_base(Assignment& P);
+  Result    import_shared_clauses(Assignment& P);
   
-  const Clause&          clause(ClauseID c) const { return operator[](c); }
+  const Clause&          clause(ClauseID c) const;
   const vector<double>&  VSIDS_counts()        const { return m_vsids_counts; }
   
   // invariant properties we may want to test for
@@ -140,6 +290,31 @@ public:
 
 
 
+inline CnfClause Cnf::operator[](ClauseID id)
+{
+  if (id == learned_clause_id()) return CnfClause(m_learned_clause.data(),m_learned_clause.size());
+  return CnfClause(m_literals.data() + m_clauses[id].offset, m_clauses[id].size);
+}
+
+inline const CnfClause Cnf::operator[](ClauseID id) const
+{
+  return const_cast<Cnf*>(this)->operator[](id);
+}
+
+inline const string& Cnf::group_name(ClauseID id) const
+{
+  if (id == learned_clause_id()) return m_learned_clause.group_identifier;
+  return m_group_names[m_clauses[id].group];
+}
+
+// the solver only asks for the clause it just learned.  Stored clauses live in the arena, see
+// operator[] for those.
+inline const Clause& Cnf::clause(ClauseID id) const
+{
+  if (id != learned_clause_id()) quit("Cnf::clause only has the learned clause, use operator[]");
+  return m_learned_clause;
+}
+
 inline ostream& operator<<(ostream& os, const CnfClause& c) {
   for (size_t i=0; i < c.size(); i++)
     os << c[i] << ' ' << flush;
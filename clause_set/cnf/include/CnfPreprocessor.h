@@ -0,0 +1,110 @@
+#ifndef __CNF_PREPROCESSOR__
+#define __CNF_PREPROCESSOR__
+
+#include <vector>
+#include "Cnf.h"
+#include "ProofWriter.h"
+using namespace std;
+
+namespace zap
+{
+
+#define RESOLVENT_LENGTH_LIMIT     20          // variable elimination won't make a resolvent longer than this
+#define ELIMINATION_CLAUSE_LIMIT   200         // or try variables that are in more clauses than this
+#define ELIMINATION_ROUNDS         5
+#define PREPROCESS_STEP_LIMIT      100000000   // literals each technique may look at before it gives up
+
+
+/*  A CnfPreprocessor simplifies a plain CNF before the solver sees it.  It has its own copy of the
+    clauses with occurrence lists, which the solver's Cnf doesn't need, and when it's done it builds a
+    new Cnf with what's left.  In order it does
+
+      1. unit propagation at level 0.  Satisfied clauses go and false literals come out.
+      2. equivalent literal substitution.  Literals in the same strongly connected component of the
+         binary implication graph are equivalent, so we replace each one with the literal of the
+         component that has the smallest variable.  A component with x and -x means UNSAT.
+      3. subsumption and self subsuming resolution.  If C is a subset of D we delete D, and if C is
+         a subset of D except that C has l and D has -l we take -l out of D.  Each clause is checked
+         against the occurrence list of its least frequent variable, and 64 bit signatures of the
+         variables throw out most candidates without looking at the clauses.
+      4. bounded variable elimination (SatELite).  We replace the clauses of a variable with all
+         their non tautological resolvents if that doesn't make more clauses and no resolvent gets
+         longer than RESOLVENT_LENGTH_LIMIT.  The cheapest variables go first and we go around
+         again on the variables whose clauses changed.  Then we run subsumption again.
+
+    Eliminated and substituted variables don't appear in the new Cnf but they keep their numbers, so
+    the solver's models still cover them with some value.  extend_model fixes those values.  Every
+    clause we take out for an eliminated variable is saved with the variable's literal first, and
+    going back through the saved clauses in reverse, any one that the model falsifies gets its first
+    literal made true.  Substitution saves x = r as the two clauses (x -r) and (-x r).
+
+    With a ProofWriter everything we add is written as a DRAT lemma before the clauses it came
+    from are deleted.  Resolvents, strengthened clauses and rewritten clauses are all RUP.  Each
+    technique gives up after looking at PREPROCESS_STEP_LIMIT literals, so huge inputs don't spend
+    longer here than they would searching.  */
+
+class CnfPreprocessor
+{
+  size_t                      m_num_vars;
+  vector<vector<Literal> >    m_clause;         // sorted, no duplicate literals
+  vector<unsigned long long>  m_signature;
+  vector<bool>                m_removed;
+  vector<vector<size_t> >     m_occurs;         // clauses by literal index, removed ones linger
+  vector<unsigned char>       m_value;          // UNKNOWN or the value unit propagation gave it
+  vector<bool>                m_eliminated;     // eliminated or substituted
+  vector<Literal>             m_units;          // waiting to be propagated
+  vector<size_t>              m_mark;           // literal index -> m_stamp when marked
+  size_t                      m_stamp;
+  vector<size_t>              m_queue;          // clauses to check for subsumption
+  vector<bool>                m_queued;
+  vector<Literal>             m_saved;          // clauses saved for extend_model, pivot first
+  vector<size_t>              m_saved_sizes;
+  ProofWriter*                m_proof;
+  long long unsigned          m_steps;
+  bool                        m_unsat;
+
+  // statistics
+  size_t                      m_input_clauses;
+  size_t                      m_number_fixed;
+  size_t                      m_number_substituted;
+  size_t                      m_number_eliminated;
+  size_t                      m_number_subsumed;
+  size_t                      m_number_strengthened;
+
+  static size_t   index(Literal l)       { return 2*l.variable() + (l.sign() ? 0 : 1); }
+  static Literal  literal(size_t index)  { return Literal(index/2,index % 2 == 0); }
+  static bool     normalize(vector<Literal>& lits);   // false for a tautology
+
+  size_t    store_clause(const vector<Literal>& lits);
+  void      remove_clause(size_t id);
+  void      strengthen(size_t id, Literal l);
+  void      enqueue(Literal l);
+  void      queue_for_subsumption(size_t id);
+  void      save_clause(const vector<Literal>& lits, Literal pivot);
+  void      log_add(const vector<Literal>& lits);
+  void      log_remove(const vector<Literal>& lits);
+  void      clean_occurrences(Literal l);
+  bool      resolve(const vector<Literal>& p, const vector<Literal>& n, Variable v, vector<Literal>& resolvent);
+
+  void      propagate();
+  void      substitute_equivalences();
+  void      subsume();
+  bool      try_elimination(Variable v, vector<Variable>& touched);
+  void      eliminate();
+
+public:
+  CnfPreprocessor(size_t number_variables, ProofWriter* proof = NULL);
+
+  void      add_clause(const Literal* lits, size_t size);
+  void      add_clauses(const Cnf& cnf);   // the input clauses of a Cnf that hasn't been solved yet
+  Result    simplify();                    // CONTRADICTION if we found the clauses are UNSAT
+  void      build(Cnf& cnf) const;         // the clauses that are left as a new Cnf
+
+  // model is indexed by variable.  Fills in the eliminated and substituted variables.
+  void      extend_model(vector<bool>& model) const;
+
+  void      print_statistics(ostream& os) const;
+};
+
+} // end namespace zap
+#endif
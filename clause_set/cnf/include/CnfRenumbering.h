@@ -0,0 +1,69 @@
+#ifndef __CNF_RENUMBERING__
+#define __CNF_RENUMBERING__
+
+#include <vector>
+#include "Cnf.h"
+using namespace std;
+
+namespace zap
+{
+
+/*  A CnfRenumbering gives the variables of a plain CNF new numbers so that variables that share
+    clauses get numbers close together, and builds a new Cnf with the clauses in an order to
+    match.  The parser numbers atoms in the order it first sees them, so on big generated
+    instances the variables of one clause can be millions apart.  The solver's per variable
+    arrays (the Cnf's watchers and VSIDS counts, the Assignment's values and reasons) are all
+    indexed by variable, so propagating through one clause then touches cache lines all over
+    memory.
+
+    The numbering is Cuthill-McKee.  We go breadth first over the variable interaction graph
+    (two variables are adjacent if they share a clause), starting each connected component from
+    its lowest degree variable and numbering the neighbours of each variable in increasing
+    degree.  Rather than build the graph we go through the clauses of each variable, and each
+    clause is only looked at once, so it's linear in the size of the clauses.  Variables that
+    don't appear in any clause (the preprocessor eliminated them, say) go last.
+
+    The new Cnf has the literals of each clause sorted by their new variable, so a clause is
+    first watched on its two lowest variables, and the clauses sorted (stably) by their first
+    variable.  The watch lists of neighbouring variables then point at neighbouring clauses.
+
+    Some instances come numbered well already, and on very symmetric ones (pigeonhole, say)
+    breadth first spreads the clauses out more than the parser did.  We measure the average
+    clause span both ways, and if the new numbering isn't better improves() says so and the
+    caller keeps the old one.
+
+    Everything outside the solver keeps talking about the old numbers.  restore_model maps a model
+    back, the ProofWriter writes lemmas with the old numbers (see ProofWriter::map_variables) and
+    rename_atoms makes global_vars.atom_name_map follow the new numbers so names still print
+    right.  */
+
+class CnfRenumbering
+{
+  size_t            m_num_vars;
+  vector<Variable>  m_new;          // old variable -> new variable
+  vector<Variable>  m_old;          // new variable -> old variable
+  size_t            m_components;
+  double            m_span_before;  // average distance between the lowest and highest variable of a clause
+  double            m_span_after;
+
+  static double     average_span(const Cnf& cnf, const vector<Variable>* number);
+
+public:
+  CnfRenumbering(const Cnf& cnf);
+
+  void      build(const Cnf& input, Cnf& cnf) const;   // input renumbered
+  void      rename_atoms() const;
+
+  Variable  new_variable(Variable v) const { return m_new[v]; }
+  Variable  old_variable(Variable v) const { return m_old[v]; }
+  const vector<Variable>&  old_variables() const { return m_old; }
+  bool      improves() const { return m_span_after < m_span_before; }
+
+  // model is indexed by new variable, and afterwards by old variable
+  void      restore_model(vector<bool>& model) const;
+
+  void      print_statistics(ostream& os) const;
+};
+
+} // end namespace zap
+#endif
@@ -0,0 +1,63 @@
+#include "ClauseExchange.h"
+
+namespace zap
+{
+
+
+bool ClauseExchange::publish(const vector<Literal>& c, size_t worker)
+{
+  if (c.size() > EXCHANGE_MAX_SIZE) return false;
+  
+  size_t position = m_head.fetch_add(1,memory_order_relaxed);
+  ExchangeSlot& s = m_slots[position % m_slots.size()];
+
+  // claim the slot, unless someone is writing it right now or has already put something newer there
+  size_t sequence = s.sequence.load(memory_order_acquire);
+  if ((sequence & 1) || sequence > 2*position) return false;
+  if (!s.sequence.compare_exchange_strong(sequence,2*position+1,memory_order_acq_rel)) return false;
+  atomic_thread_fence(memory_order_release);
+
+  s.worker.store(worker,memory_order_relaxed);
+  s.size.store(c.size(),memory_order_relaxed);
+  for (size_t i=0; i < c.size(); i++)
+    s.lits[i].store(c[i].int_lit(),memory_order_relaxed);
+
+  s.sequence.store(2*position+2,memory_order_release);
+  return true;
+}
+
+
+
+// Append to clauses everything published by other workers since position cursor and move
+// cursor forward.  Returns the number of clauses added.
+size_t ClauseExchange::collect(size_t& cursor, size_t worker, vector<Clause>& clauses) const
+{
+  size_t head = m_head.load(memory_order_acquire);
+  if (head > cursor + m_slots.size()) cursor = head - m_slots.size();  // we missed the ones overwritten
+
+  size_t found = 0;
+  for ( ; cursor < head; cursor++) {
+    const ExchangeSlot& s = m_slots[cursor % m_slots.size()];
+    size_t sequence = s.sequence.load(memory_order_acquire);
+    if (sequence == 2*cursor+1) break;       // still being written, pick it up next time
+    if (sequence != 2*cursor+2) continue;    // dropped or already overwritten
+
+    size_t from = s.worker.load(memory_order_relaxed);
+    size_t size = s.size.load(memory_order_relaxed);
+    Clause c;
+    for (size_t i=0; i < size; i++) {
+      int l = s.lits[i].load(memory_order_relaxed);
+      c.push_back(Literal(abs(l),l > 0));
+    }
+    
+    atomic_thread_fence(memory_order_acquire);
+    if (s.sequence.load(memory_order_relaxed) != sequence) continue;  // overwritten while we copied it
+    if (from == worker) continue;
+    clauses.push_back(c);
+    ++found;
+  }
+  return found;
+}
+
+
+} // end namespace zap
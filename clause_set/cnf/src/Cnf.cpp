@@ -1,17 +1,16 @@
 #include "Cnf.h"
+#include "TouchCounter.h"
 
 namespace zap
 {
 
-Cnf::Cnf(const InputTheory& input) : m_num_clauses(0),
-									 m_score_inc(1),
-									 m_clause_score_inc(1)
+Cnf::Cnf(const InputTheory& input) : m_num_vars(0), m_end_original_clauses(0), m_input_group(0), m_seen_stamp(0), m_minimize(true), first_round(true), m_exchange(NULL), m_worker(0),
+									 m_exchange_cursor(0), m_stamp(0), m_proof(NULL)
 {
   string error("Cnf constructor called on structured input");
- 
-  size_t number_unit_lits = 0;
+
+  vector<Clause> clauses(input.m_clauses.size());
   for (size_t i=0; i < input.m_clauses.size(); i++) {
-    CnfClause c;
 	const InputClause& ic = input.m_clauses[i];
 
 	if (ic.gid().size() || ic.universal().size()) quit(error);
@@ -19,117 +18,109 @@ Cnf::Cnf(const InputTheory& input) : m_num_clauses(0),
     for (size_t j=0; j < ic.lits().size(); j++) {
 	  const InputLiteral& il = ic.lit(j);
 	  size_t atom_id = global_vars.atom_name_map.lookup(il.to_string());
-	  c.push_back(Literal(atom_id,il.sign()));
+	  clauses[i].push_back(Literal(atom_id,il.sign()));
 	}
-	
-    if (c.size() == 1 && size() > number_unit_lits) { // keep all the unit lits at the front of the vector
-      push_back(operator[](number_unit_lits)); 
-      operator[](number_unit_lits) = c;
-    }
-    else push_back(c);
-	if (c.size() == 1) number_unit_lits++;
-    m_num_clauses++;
   }
+  initialize_clause_set(clauses);
+}
 
-  m_num_vars = global_vars.atom_name_map.size();
-  m_vsids_counts.insert(m_vsids_counts.end(),m_num_vars+1,0);
-  m_score_set = FastSet(m_num_vars+1);
-  m_watchers.insert(m_watchers.end(),number_variables()+1,VariableWatch());
 
-  for (size_t i=0; i < size(); i++) operator[](i).id = i;  // set the internal clause ids
 
-  m_end_original_clauses = m_num_clauses;
-  m_max_clauseset_size = m_num_clauses + (m_num_clauses/3);
-    
-  // set up the watched literal indexes
-  for (size_t i=0; i < size(); i++) {
-    if (operator[](i).size() > 1) {  // watch the first two literals
-      for (size_t j=0; j < 2; j++)
-	m_watchers[operator[](i)[j].variable()].watch_list[operator[](i)[j].sign()].push_back(i);
-    }
-  }
-  push_back(CnfClause()); // temporary storage for learned clause
-  back().id = size()-1;
+Cnf::Cnf(const vector<Clause>& clauses) : m_num_vars(0), m_end_original_clauses(0), m_input_group(0), m_seen_stamp(0), m_minimize(true), first_round(true), m_exchange(NULL), m_worker(0),
+										  m_exchange_cursor(0), m_stamp(0), m_proof(NULL)
+{
+  initialize_clause_set(clauses);
+}
+   
+
+void Cnf::initialize_clause_set(const vector<Clause>& clauses)
+{
+   size_t number_lits = 0;
+   for (size_t i=0; i < clauses.size(); i++) number_lits += clauses[i].size();
+
+   begin_input(clauses.size(),number_lits);
+   for (size_t i=0; i < clauses.size(); i++) 
+      append_clause(clauses[i],intern_group(clauses[i].group_identifier));
+   finish_input();
 }
 
 
 
-Cnf::Cnf(const vector<Clause>& clauses) : m_num_clauses(0),
-									 m_score_inc(1),
-									 m_clause_score_inc(1)
+void Cnf::begin_input(size_t number_clauses, size_t number_lits)
 {
-  size_t number_unit_lits = 0;
-  for (size_t i=0; i < clauses.size(); i++) {
-    CnfClause c(clauses[i]);
- 
-    if (c.size() == 1 && size() > number_unit_lits) { // keep all the unit lits at the front of the vector
-      push_back(operator[](number_unit_lits)); 
-      operator[](number_unit_lits) = c;
-    }
-    else push_back(c);
-	if (c.size() == 1) number_unit_lits++;
-    m_num_clauses++;
-  }
+   m_literals.clear();
+   m_clauses.clear();
+   m_literals.reserve(number_lits);
+   m_clauses.reserve(number_clauses);
+   m_input_group = intern_group("empty");  // plain clauses all get the default group name
+}
 
-  m_num_vars = global_vars.atom_name_map.size();
-  m_vsids_counts.insert(m_vsids_counts.end(),m_num_vars+1,0);
-  m_score_set = FastSet(m_num_vars+1);
-  m_watchers.insert(m_watchers.end(),number_variables()+1,VariableWatch());
 
-  for (size_t i=0; i < size(); i++) operator[](i).id = i;  // set the internal clause ids
 
-  m_end_original_clauses = m_num_clauses;
-  m_max_clauseset_size = m_num_clauses + (m_num_clauses/3);
-    
-  // set up the watched literal indexes
-  for (size_t i=0; i < size(); i++) {
-    if (operator[](i).size() > 1) {  // watch the first two literals
-      for (size_t j=0; j < 2; j++)
-	m_watchers[operator[](i)[j].variable()].watch_list[operator[](i)[j].sign()].push_back(i);
-    }
-  }
-  push_back(CnfClause()); // temporary storage for learned clause
-  back().id = size()-1;
+ClauseID Cnf::append_input_clause(const Literal* lits, size_t size)
+{
+  m_clauses.push_back(CnfClauseHeader(m_literals.size(),size,m_input_group));
+  m_literals.insert(m_literals.end(),lits,lits + size);
+  return m_clauses.size()-1;
 }
-   
 
-void Cnf::initialize_clause_set(const vector<Clause>& clauses)
+
+
+void Cnf::finish_input()
 {
-   m_num_clauses = 0;
    m_score_inc = 1;
    m_clause_score_inc = 1;
+
+   // keep all the unit clauses at the front.  Only the headers move, the literals stay put.
    size_t number_unit_lits = 0;
-   for (size_t i=0; i < clauses.size(); i++) {
-      CnfClause c(clauses[i]);
- 
-      if (c.size() == 1 && size() > number_unit_lits) { // keep all the unit lits at the front of the vector
-         push_back(operator[](number_unit_lits)); 
-         operator[](number_unit_lits) = c;
-      }
-      else push_back(c);
-      if (c.size() == 1) number_unit_lits++;
-      m_num_clauses++;
-   }
+   for (size_t i=0; i < m_clauses.size(); i++) 
+      if (m_clauses[i].size == 1) swap(m_clauses[i],m_clauses[number_unit_lits++]);
    
    m_num_vars = global_vars.atom_name_map.size();
-   m_vsids_counts.insert(m_vsids_counts.end(),m_num_vars+1,0);
+   m_vsids_counts.assign(m_num_vars+1,0);
    m_score_set = FastSet(m_num_vars+1);
-   m_watchers.insert(m_watchers.end(),number_variables()+1,VariableWatch());
+   m_watchers.assign(number_variables()+1,CnfVariableWatch());
    
-   for (size_t i=0; i < size(); i++) operator[](i).id = i;  // set the internal clause ids
-   
-   m_end_original_clauses = m_num_clauses;
-   m_max_clauseset_size = m_num_clauses + (m_num_clauses/3);
+   m_end_original_clauses = number_clauses();
+   m_max_clauseset_size = number_clauses() + (number_clauses()/3);
    
    // set up the watched literal indexes
-   for (size_t i=0; i < size(); i++) {
-      if (operator[](i).size() > 1) {  // watch the first two literals
-         for (size_t j=0; j < 2; j++)
-            m_watchers[operator[](i)[j].variable()].watch_list[operator[](i)[j].sign()].push_back(i);
-      }
-   }
-   push_back(CnfClause()); // temporary storage for learned clause
-   back().id = size()-1;
+   for (size_t i=0; i < number_clauses(); i++) 
+      if (m_clauses[i].size > 1) watch_clause(i);  // watch the first two literals
+
+   m_learned_clause = Clause(); // temporary storage for learned clause
+}
+
+
+
+ClauseID Cnf::append_clause(const vector<Literal>& c, size_t group)
+{
+  m_clauses.push_back(CnfClauseHeader(m_literals.size(),c.size(),group));
+  m_literals.insert(m_literals.end(),c.begin(),c.end());
+  return m_clauses.size()-1;
+}
+
+
+// the first two literals are watched, and each watcher uses the other watched literal as its blocker
+void Cnf::watch_clause(ClauseID id)
+{
+  CnfClause c = operator[](id);
+  if (c.size() == 2) {
+    m_watchers[c[0].variable()].binary_list[c[0].sign()].push_back(CnfWatcher(id,c[1]));
+    m_watchers[c[1].variable()].binary_list[c[1].sign()].push_back(CnfWatcher(id,c[0]));
+    return;
+  }
+  m_watchers[c[0].variable()].watch_list[c[0].sign()].push_back(CnfWatcher(id,c[1]));
+  m_watchers[c[1].variable()].watch_list[c[1].sign()].push_back(CnfWatcher(id,c[0]));
+}
+
+
+size_t Cnf::intern_group(const string& name)
+{
+  for (size_t i=0; i < m_group_names.size(); i++)
+    if (m_group_names[i] == name) return i;
+  m_group_names.push_back(name);
+  return m_group_names.size()-1;
 }
    
 
@@ -137,22 +128,38 @@ void Cnf::initialize_clause_set(const vector<Clause>& clauses)
 //  This is the major computational loop of the solver.  80-90% of execution time will be spent here.
 Result Cnf::get_implications(Assignment& P, Literal a)
 {
-  vector<Watcher>& w = m_watchers[a.variable()].watch_list[!a.sign()]; 
+  TouchCounter touched;
+  const vector<CnfWatcher>& b = m_watchers[a.variable()].binary_list[!a.sign()];
+  for (size_t i=0; i < b.size(); i++) {
+    Literal other = b[i].blocker;
+    if (P.value(other.variable()) == other.sign()) continue;
+	touched.clause();
+    if (!P.extend(AnnotatedLiteral(other, Reason(b[i].id)))) 
+      return CONTRADICTION; 
+  }
+  
+  vector<CnfWatcher>& w = m_watchers[a.variable()].watch_list[!a.sign()]; 
   for (size_t i=0; i < w.size(); i++) {
-	global_vars.clauses_touched++; 
-    CnfClause& c = operator[](w[i]);
-    if (c.begin()->variable() == a.variable()) { Literal tmp = c[0]; c[0] = c[1]; c[1] = tmp; }  // swap
+    if (P.value(w[i].blocker.variable()) == w[i].blocker.sign())  // the clause is sat, don't look at it
+      continue;
+    
+	touched.clause();
+    CnfClauseHeader& h = m_clauses[w[i].id];
+    Literal* c = &m_literals[h.offset];
+    if (c[0].variable() == a.variable()) { Literal tmp = c[0]; c[0] = c[1]; c[1] = tmp; }  // swap
     Literal& watcher = c[1];
     Literal& other_watcher = c[0];
 
-    if (P.value(other_watcher.variable()) == other_watcher.sign())  // check if the other watcher is sat
+    if (P.value(other_watcher.variable()) == other_watcher.sign()) { // check if the other watcher is sat
+      w[i].blocker = other_watcher;
       continue;
+    }
      
     bool found_new_watcher = false;
-    for (size_t j = 2; j < c.size(); j++)  { // try to replace this watcher
-      global_vars.literals_touched++;
+    for (size_t j = 2; j < h.size; j++)  { // try to replace this watcher
+      touched.literal();
       if (P.watchable(c[j])) {
-	m_watchers[c[j].variable()].watch_list[c[j].sign()].push_back(w[i]);  // add the new watcher to watch list
+	m_watchers[c[j].variable()].watch_list[c[j].sign()].push_back(CnfWatcher(w[i].id,other_watcher));
 	
 	Literal tmp = watcher;  // swap with the old watcher
 	watcher = c[j];
@@ -168,8 +175,8 @@ Result Cnf::get_implications(Assignment& P, Literal a)
 
     if (found_new_watcher) continue;
 
-	c.score++;
-    if (!P.extend(AnnotatedLiteral(other_watcher, Reason(w[i])))) 
+	h.score++;
+    if (!P.extend(AnnotatedLiteral(other_watcher, Reason(w[i].id)))) 
       return CONTRADICTION; 
   }
   return SUCCESS;
@@ -194,24 +201,32 @@ void Cnf::rescale_variable_scores()
 
 void Cnf::increment_clause_score(ClauseID id)
 {
-  operator[](id).score += m_clause_score_inc;
-  if (operator[](id).score > CLAUSE_SCORE_LIMIT)
+  m_clauses[id].score += m_clause_score_inc;
+  if (m_clauses[id].score > CLAUSE_SCORE_LIMIT)
     rescale_clause_scores();
 }
 
 
 void Cnf::rescale_clause_scores()
 {
-  for (size_t i=m_end_original_clauses; i < m_num_clauses; i++)
-    operator[](i).score *= CLAUSE_SCORE_DIVIDER;
+  for (size_t i=m_end_original_clauses; i < number_clauses(); i++)
+    m_clauses[i].score *= CLAUSE_SCORE_DIVIDER;
   m_clause_score_inc *= CLAUSE_SCORE_DIVIDER;
 }
 
 
+// The input unit clauses are all at the front.  Learned ones are mixed in with the other
+// learned clauses, and we only get here with learned clauses around when a Cnf is solved more
+// than once (see zap/cubes.h).
 Result Cnf::load_unit_literals(Assignment& P)
 {
-  for (size_t i=0; i < size(); i++) {
-    if (operator[](i).size() > 1) break;
+  for (size_t i=0; i < m_end_original_clauses; i++) {
+    if (m_clauses[i].size > 1) break;
+    if (!P.extend(AnnotatedLiteral(operator[](i)[0],Reason(i))))
+      return CONTRADICTION;
+  }
+  for (size_t i=m_end_original_clauses; i < number_clauses(); i++) {
+    if (m_clauses[i].size != 1) continue;
     if (!P.extend(AnnotatedLiteral(operator[](i)[0],Reason(i))))
       return CONTRADICTION;
   }
@@ -228,74 +243,135 @@ bool Cnf::get_symmetric_unit_lits(Assignment& P, ClauseID c_id, Literal unit_lit
 
 
 
-int top;
-size_t local_lits_this_level;
-
-
-size_t Cnf::add_to_analysis(const CnfClause& c, const Assignment& P) {
+// pivot is the variable we are resolving on.  It's usually c[0] but binary clauses
+// aren't kept in any particular order.
+size_t Cnf::add_to_analysis(const CnfClause& c, const Assignment& P, Variable pivot) {
 
   size_t lits_this_level = 0;
-  for (size_t i=1; i < c.size(); i++) {
+  for (size_t i=0; i < c.size(); i++) {
+    if (c[i].variable() == pivot) continue;
 	int  level = P.decision_level(c[i].variable());
-	if (!seen[c[i].variable()] && (level >= 0)) {
-	  seen[c[i].variable()] = true;
+	if (!seen(c[i].variable()) && (level >= 0)) {
+	  mark_seen(c[i].variable());
 	  increment_variable_score(c[i].variable());
       if (level == P.current_level()) ++lits_this_level;
       if (level < P.current_level())
-         back().push_back(c[i]);
+         m_learned_clause.push_back(c[i]);
 	}
   }
   return lits_this_level;
 }
 
 
-ClauseID Cnf::resolve(const Reason& r1, const Reason& r2, const Assignment& P, size_t& lits_this_level, Literal& unit_lit)
+// a new stamp unmarks every variable at once
+void Cnf::start_analysis()
 {
-  if (seen.size() == 0) {
-	seen.insert(seen.end(),number_variables() + 1, false);
-	first_round = true;
+  if (m_seen.size() < number_variables() + 1) m_seen.resize(number_variables() + 1,0);
+  if (++m_seen_stamp == 0) {       // wrapped around, so old marks could look current
+	fill(m_seen.begin(),m_seen.end(),0);
+	m_seen_stamp = 1;
   }
-  
-  CnfClause& c1 = operator[](r1.id());
-  CnfClause& c2 = operator[](r2.id());
+}
+
+
+ClauseID Cnf::resolve(const Reason& r1, const Reason& r2, const Assignment& P, size_t& lits_this_level, Literal& unit_lit)
+{
+  const CnfClause c1 = operator[](r1.id());
+  const CnfClause c2 = operator[](r2.id());
+  Variable pivot = P.contradiction_variable();
+  note_clause_use(r1.id(),P);
+  note_clause_use(r2.id(),P);
   
   if (first_round) {
-     back().push_back(Literal());
+	start_analysis();
+    m_learned_clause.push_back(Literal());
 	first_round = false;
 	top = P.size()-1;
-	local_lits_this_level = 0;
-	local_lits_this_level = add_to_analysis(c1,P);
-	local_lits_this_level += add_to_analysis(c2,P);
-    resolve_clause = boolean_resolve(c1,c2);
+	local_lits_this_level = add_to_analysis(c1,P,pivot);
+	local_lits_this_level += add_to_analysis(c2,P,pivot);
   }
-  else {
-     local_lits_this_level += add_to_analysis((r1.id() < (int)(size()-1) ? c1 : c2),P);
-     resolve_clause = boolean_resolve(resolve_clause,(r1.id() < (int)(size()-1) ? c1 : c2));
+  else {  // one of the two is the learned clause, resolve with the other
+     const CnfClause& c = (r1.id() < learned_clause_id() ? c1 : c2);
+     local_lits_this_level += add_to_analysis(c,P,pivot);
   }                       
 
   // now calculate the next unit lit
   for ( ; top >= 0; top--) {
-	if (seen[P[top].variable()]) {
+	if (seen(P[top].variable())) {
 	  unit_lit = P[top].negate();
 	  break;
 	}
   }
   
   if (top == -1 ) {
-	back().clear();
-	return size()-1;
+	m_learned_clause.clear();
+	return learned_clause_id();
   }
  
 
-  seen[unit_lit.variable()] = false;
+  unmark_seen(unit_lit.variable());
   local_lits_this_level--;
   
   if (local_lits_this_level == 0) {
-	back()[0] = unit_lit;
+	m_learned_clause[0] = unit_lit;
+	if (m_minimize) minimize_learned_clause(P);
   }
 
   lits_this_level = local_lits_this_level + 1;
-  return size()-1;
+  return learned_clause_id();
+}
+
+
+
+// a bit for each decision level, hashed into 32.  If a literal's level isn't in the learned
+// clause at all, neither is some literal of its reason, so it can't be redundant.
+inline unsigned abstract_level(int level) { return 1u << (level & 31); }
+
+
+// The literals of the learned clause from lower levels (everything but the UIP in position 0)
+// are marked seen.  redundant marks the ones it proves redundant too, so we don't prove them twice.
+void Cnf::minimize_learned_clause(const Assignment& P)
+{
+  Clause& c = m_learned_clause;
+  unsigned levels = 0;
+  for (size_t i=1; i < c.size(); i++) levels |= abstract_level(P.decision_level(c[i].variable()));
+
+  size_t j = 1;
+  for (size_t i=1; i < c.size(); i++)
+	if (!redundant(c[i],P,levels)) c[j++] = c[i];
+  c.resize(j);
+}
+
+
+// l is false and in the learned clause.  It's redundant if every other literal in its reason is
+// in the clause, is false at level 0 or is redundant itself.  We walk the reasons depth first and
+// if we hit a decision, or a level that isn't in the clause, we give up and unmark what we marked.
+bool Cnf::redundant(Literal l, const Assignment& P, unsigned levels)
+{
+  if (!P.get_reason(l.negate()).good_reason()) return false;
+  m_minimize_stack.assign(1,l.variable());
+  m_minimize_marked.clear();
+
+  while (!m_minimize_stack.empty()) {
+	Variable v = m_minimize_stack.back();
+	m_minimize_stack.pop_back();
+	const CnfClause r = operator[](P.get_reason(Literal(v,P.value(v))).id());
+	for (size_t i=0; i < r.size(); i++) {
+	  Variable u = r[i].variable();
+	  if (u == v || seen(u)) continue;
+	  int level = P.decision_level(u);
+	  if (level == 0) continue;
+	  if (P.get_reason(r[i].negate()).good_reason() && (abstract_level(level) & levels)) {
+		mark_seen(u);
+		m_minimize_stack.push_back(u);
+		m_minimize_marked.push_back(u);
+		continue;
+	  }
+	  for (size_t j=0; j < m_minimize_marked.size(); j++) unmark_seen(m_minimize_marked[j]);
+	  return false;
+	}
+  }
+  return true;
 }
 
 
@@ -303,136 +379,285 @@ ClauseID Cnf::resolve(const Reason& r1, const Reason& r2, const Assignment& P, s
 void Cnf::add_learned_clause(ClauseID c_id, const Assignment& P)
 {
   first_round = true; // reset this backup flag
-  seen.clear();
   
-  if (c_id != (int)(size()-1)) quit(string("adding clause that isn't temp clause"));
-  m_num_clauses++;
-  push_back(CnfClause());
-  back().id = size()-1;
-  CnfClause& c = operator[](c_id);
-
-  if (c.size() <= 1) return;
+  if (c_id != learned_clause_id()) quit(string("adding clause that isn't temp clause"));
+  Clause& c = m_learned_clause;
 
-  size_t deepest = 0;
-  for (size_t i=0; i < c.size(); i++) // find the most recently valued literal to be first watcher
-	if (P.position(c[i].variable()) > P.position(c[deepest].variable())) deepest = i;
+  if (c.size() > 1) {
+    size_t deepest = 0;
+    for (size_t i=0; i < c.size(); i++) // find the most recently valued literal to be first watcher
+      if (P.position(c[i].variable()) > P.position(c[deepest].variable())) deepest = i;
   
-  Literal temp = c[0]; c[0] = c[deepest]; c[deepest] = temp; // put it in the first array position
+    Literal temp = c[0]; c[0] = c[deepest]; c[deepest] = temp; // put it in the first array position
   
-  deepest = 1;
-  for (size_t i=1; i < c.size(); i++)  // 
-	if (P.decision_level(c[i].variable()) > P.decision_level(c[deepest].variable())) deepest = i;
+    deepest = 1;
+    for (size_t i=1; i < c.size(); i++)  // 
+      if (P.decision_level(c[i].variable()) > P.decision_level(c[deepest].variable())) deepest = i;
   
-  temp = c[1]; c[1] = c[deepest]; c[deepest] = temp;
+    temp = c[1]; c[1] = c[deepest]; c[deepest] = temp;
+  }
+
+  size_t glue = lbd(c.data(),c.size(),P);
+  export_learned_clause(c,glue);
+  if (m_proof) m_proof->add(c.data(),c.size());
+  append_clause(c,intern_group(c.group_identifier));  // commit it to the arena, it keeps the id c_id
+  m_clauses[c_id].lbd = glue;
+  m_clauses[c_id].tier = clause_tier(glue);
+  bool is_unit = c.size() <= 1;
+  c.clear();                                           // and reset the temporary storage
+  c.merge_size = 0;
+  c.group_identifier = "empty";
+  if (is_unit) return;
   
-  // now we can watch the first two literals
-  for (size_t j=0; j < 2; j++)
-	m_watchers[c[j].variable()].watch_list[c[j].sign()].push_back(c_id);
+  watch_clause(c_id);  // now we can watch the first two literals
   
   increment_clause_score(c_id);
   m_clause_score_inc *= CLAUSE_SCORE_INC_FACTOR;
 }
 
 
-/////////////////////////////////////  REDUCING LEARNED CLAUSE SET  ////////////////////////////////////
+// Conflict analysis used clause id.  The first time an imported clause helps us learn something
+// it counts as useful.  A learned clause gets a higher score and, if its literals are spread over
+// fewer levels than when we learned it, maybe a better tier.
+void Cnf::note_clause_use(ClauseID id, const Assignment& P)
+{
+  if (id < (ClauseID)m_end_original_clauses || id >= (ClauseID)number_clauses()) return;
+  CnfClauseHeader& h = m_clauses[id];
+  if (h.imported) {
+	h.imported = false;
+	global_vars.shared_useful++;
+  }
+  h.used = true;
+  increment_clause_score(id);
+  if (h.tier == TIER_CORE) return;
+  size_t glue = lbd(m_literals.data() + h.offset,h.size,P);
+  if (glue < h.lbd) {
+	h.lbd = glue;
+	h.tier = min(h.tier,clause_tier(glue));
+  }
+}
+
+
+
+/////////////////////////////////////  SHARING LEARNED CLAUSES  ////////////////////////////////////////
+
+void Cnf::share_clauses(ClauseExchange* exchange, size_t worker)
+{
+  m_exchange = exchange;
+  m_worker = worker;
+  m_exchange_cursor = 0;
+}
+
+
+
+// the number of different decision levels in c (its lbd or glue).  Clauses with a low lbd
+// tie together only a few decisions and tend to be the ones worth keeping.
+size_t Cnf::lbd(const Literal* c, size_t size, const Assignment& P)
+{
+  if (m_level_stamp.size() < number_variables() + 2) m_level_stamp.assign(number_variables() + 2,0);
+  ++m_stamp;
+  size_t levels = 0;
+  for (size_t i=0; i < size; i++) {
+	int level = P.decision_level(c[i].variable());
+	if (level < 0 || m_level_stamp[level] == m_stamp) continue;
+	m_level_stamp[level] = m_stamp;
+	++levels;
+  }
+  return levels;
+}
+
+
+
+void Cnf::export_learned_clause(const Clause& c, size_t glue)
+{
+  if (m_exchange == NULL) return;
+  if (c.size() > 2 &&
+	  (c.size() > global_vars.share_size_bound || glue > global_vars.share_lbd_bound)) return;
+  if (m_exchange->publish(c,m_worker)) global_vars.shared_exported++;
+}
+
+
+
+// Only called at decision level 0 once P is closed.  Returns CONTRADICTION if one of the imported
+// clauses is false at level 0, which means the problem is UNSAT.
+Result Cnf::import_shared_clauses(Assignment& P)
+{
+  if (m_exchange == NULL || P.current_level() != 0 || !P.closed()) return SUCCESS;
+
+  vector<Clause> clauses;
+  if (m_exchange->collect(m_exchange_cursor,m_worker,clauses) == 0) return SUCCESS;
+  for (size_t i=0; i < clauses.size(); i++)
+	if (import_clause(clauses[i],P) == CONTRADICTION) return CONTRADICTION;
+  return SUCCESS;
+}
+
+
+
+// We drop the literals that are false at level 0 and skip the clause entirely if it's already
+// satisfied.  What's left is either a unit we can add to P right away or a clause whose first two
+// literals are unvalued and can be watched.  (is_on_unit_list is true for any literal P makes
+// true, whether or not it's been popped off the unit list yet.)
+Result Cnf::import_clause(const Clause& c, Assignment& P)
+{
+  Clause reduced;
+  for (size_t i=0; i < c.size(); i++) {
+	if (c[i].variable() == 0 || c[i].variable() > number_variables()) return SUCCESS;  // not one of ours
+	if (P.is_on_unit_list(c[i])) return SUCCESS;
+	if (!P.is_on_unit_list(c[i].negate())) reduced.push_back(c[i]);
+  }
+  if (reduced.empty()) return CONTRADICTION;
+
+  if (m_proof) m_proof->add(reduced.data(),reduced.size());
+  ClauseID id = append_clause(reduced,intern_group(reduced.group_identifier));
+  m_clauses[id].imported = true;
+  m_clauses[id].lbd = reduced.size();   // we can't tell at level 0, so assume the worst
+  m_clauses[id].tier = clause_tier(reduced.size());
+  global_vars.shared_imported++;
+
+  if (reduced.size() == 1)
+	return P.extend(AnnotatedLiteral(reduced[0],Reason(id))) ? SUCCESS : CONTRADICTION;
+  
+  watch_clause(id);
+  increment_clause_score(id);
+  return SUCCESS;
+}
+
 
 
+/////////////////////////////////////  REDUCING LEARNED CLAUSE SET  ////////////////////////////////////
+
+/*  Deleting clauses is done by building a list of the clauseIDs we want to keep in the order we want
+    to keep them and then rebuilding the arena in that order.  indexes maps old clauseIDs to new ones
+    (-1 if the clause was deleted) and update_pointers uses it to fix up the watchers and the reasons
+    in the assignment.
+*/
 
 void Cnf::reduce_knowledge_base(Assignment& P)
 {
-  size_t old_clauseset_size = size();
-  bool pointers_need_update = false;
+  vector<int> indexes;
   if (false && P.current_level() == 0) {
-    pointers_need_update = true;
-    remove_permanently_sat_clauses(P);
+    remove_permanently_sat_clauses(P,indexes);
+    update_pointers(P,indexes);
   }
   
   if (global_vars.number_branch_decisions >= m_max_clauseset_size) {
-    pointers_need_update = true;
-    remove_irrelevant_clauses(P);
+    remove_irrelevant_clauses(P,indexes);
+    update_pointers(P,indexes);
   }
-
-  if (pointers_need_update) update_pointers(P,old_clauseset_size);
 }
 
 
 
-void Cnf::remove_permanently_sat_clauses(const Assignment& P)
+void Cnf::remove_permanently_sat_clauses(const Assignment& P, vector<int>& indexes)
 {
-  size_t j = 0;
+  vector<ClauseID> order;
   size_t original_clauses_removed = 0;
-  for (size_t i=0; i < size(); i++) {
-    if (satisfied_at_level_0(P,i) && operator[](i).size() > 1) {
+  for (size_t i=0; i < number_clauses(); i++) {
+    if (satisfied_at_level_0(P,i) && m_clauses[i].size > 1) {
       if (i < m_end_original_clauses) ++original_clauses_removed;
-      m_num_clauses--;
+      log_deletion(i);
     }
     else 
-      operator[](j++) = operator[](i);
+      order.push_back(i);
   }
 
-  while (size() > m_num_clauses + 1) pop_back();
-  
+  rebuild_arena(order,indexes);
   m_end_original_clauses -= original_clauses_removed;
 }
 
 
 
-void Cnf::remove_irrelevant_clauses(const Assignment& P)
+class HigherScore {
+  const vector<CnfClauseHeader>& m_clauses;
+public:
+  HigherScore(const vector<CnfClauseHeader>& c) : m_clauses(c) { }
+  bool operator()(ClauseID a, ClauseID b) const { return m_clauses[a].score > m_clauses[b].score; }
+};
+
+
+void Cnf::remove_irrelevant_clauses(const Assignment& P, vector<int>& indexes)
 {
-  double score_req = (double)(m_clause_score_inc)/(size()-m_end_original_clauses);
-  // first we sort clauses by their hit rates
-  vector<CnfClause>::iterator start_learned_clauses = begin() + m_end_original_clauses;
-  vector<CnfClause>::iterator end_learned_clauses = end() - 1;
-  sort(start_learned_clauses,end_learned_clauses);
-  
-  // in the first half we keep binary clauses, high score clauses and those used as reasons
-  size_t mid_point = m_end_original_clauses + (size() - m_end_original_clauses)/2;
-  size_t j = m_end_original_clauses;
-  for (size_t i=m_end_original_clauses; i < mid_point; i++) {
-    CnfClause& c = operator[](i);
-    if ((c.size() > 2) && (c.score < score_req) && !is_a_reason(P,i)) {
-      m_num_clauses--;
-    }
-    else 
-      operator[](j++) = operator[](i);
+  vector<ClauseID> order;
+  order.reserve(number_clauses());
+  for (size_t i=0; i < m_end_original_clauses; i++) order.push_back(i);
+
+  // core clauses stay and so do tier 2 clauses, but those nobody used since last time drop a tier
+  vector<ClauseID> local;
+  for (size_t i=m_end_original_clauses; i < number_clauses(); i++) {
+	CnfClauseHeader& c = m_clauses[i];
+	if (c.tier == TIER_LOCAL) local.push_back(i);
+	else {
+	  if (c.tier == TIER_2 && !c.used) c.tier = TIER_LOCAL;
+	  order.push_back(i);
+	}
+	c.used = false;
   }
-  
-  // in the second half we keep those used as reasons and binary clauses
-  for (size_t i=mid_point; i < size(); i++) {
-    CnfClause& c = operator[](i);
-    if ((c.size() > 2) && !is_a_reason(P,i)) {
-      m_num_clauses--;
-    }
-    else 
-      operator[](j++) = operator[](i);
+
+  // the better half of the local tier stays, and from the worse half only reasons and binary clauses
+  sort(local.begin(),local.end(),HigherScore(m_clauses));
+  size_t mid_point = (local.size()+1)/2;
+  for (size_t i=0; i < local.size(); i++) {
+	const CnfClauseHeader& c = m_clauses[local[i]];
+	if (i >= mid_point && c.size > 2 && !is_a_reason(P,local[i])) {
+	  log_deletion(local[i]);
+	  continue;
+	}
+	order.push_back(local[i]);
   }
-  
-  while (size() > m_num_clauses + 1) pop_back();
+
+  // keeping the survivors in their old order leaves the front of the arena where it is
+  sort(order.begin() + m_end_original_clauses,order.end());
+  rebuild_arena(order,indexes);
   m_max_clauseset_size *= CLAUSESET_SIZE_MULTIPLIER;
 }
 
 
 
-void Cnf::update_pointers(Assignment& P, size_t max_id)
+// Clauses at the front of order that haven't moved are left where they are in the arena.
+// Everything after that gets copied down in the new order.
+void Cnf::rebuild_arena(const vector<ClauseID>& order, vector<int>& indexes)
 {
-  // leave a forwarding address
-  vector<int> indexes(max_id,-1);
-  for (size_t i=0; i < size(); i++) {
-    indexes[operator[](i).id] = i;
-    operator[](i).id = i;
+  indexes.assign(number_clauses()+1,-1);
+  size_t keep = 0;
+  while (keep < order.size() && order[keep] == (ClauseID)keep) {
+    indexes[keep] = keep;
+    ++keep;
   }
+  size_t arena_end = (keep < number_clauses() ? m_clauses[keep].offset : m_literals.size());
+  
+  vector<Literal> literals;
+  vector<CnfClauseHeader> clauses;
+  for (size_t i=keep; i < order.size(); i++) {
+    CnfClauseHeader h = m_clauses[order[i]];
+    const CnfClause c = operator[](order[i]);
+    h.offset = arena_end + literals.size();
+    literals.insert(literals.end(),c.begin(),c.end());
+    indexes[order[i]] = keep + clauses.size();
+    clauses.push_back(h);
+  }
+  indexes[learned_clause_id()] = order.size();  // the temporary clause moves too
+
+  m_literals.resize(arena_end);
+  m_literals.insert(m_literals.end(),literals.begin(),literals.end());
+  m_clauses.resize(keep);
+  m_clauses.insert(m_clauses.end(),clauses.begin(),clauses.end());
+}
+
 
+
+void Cnf::update_pointers(Assignment& P, const vector<int>& indexes)
+{
   // update the watched literal pointers
   for (size_t i=1; i < m_watchers.size(); i++) {
-	for (size_t j=0; j < 2; j++) {
-	  vector<Watcher>& w = m_watchers[i].watch_list[j];
+	for (size_t j=0; j < 4; j++) {
+	  vector<CnfWatcher>& w = (j < 2 ? m_watchers[i].watch_list[j] : m_watchers[i].binary_list[j-2]);
 	  for (size_t k=0; k < w.size(); k++) {
-		if (indexes[w[k]] == -1) { // we deleted this clause
+		if (indexes[w[k].id] == -1) { // we deleted this clause
 		  w[k--] = w.back();
 		  w.pop_back();
 		}
 		else 
-		  w[k] = indexes[w[k]];
+		  w[k].id = indexes[w[k].id];
 	  }
 	}
   }
@@ -441,9 +666,18 @@ void Cnf::update_pointers(Assignment& P, size_t max_id)
 
 
 
+void Cnf::log_deletion(ClauseID id)
+{
+  if (m_proof == NULL) return;
+  const CnfClause c = operator[](id);
+  m_proof->remove(c.begin(),c.size());
+}
+
+
+
 bool Cnf::satisfied_at_level_0(const Assignment& P, ClauseID id)
 {
-  CnfClause& c = operator[](id);
+  const CnfClause c = operator[](id);
   for (size_t i=0; i < c.size(); i++) {
     if (P.value(c[i].variable()) != UNKNOWN &&
 	P.decision_level(c[i].variable()) == 0 &&
@@ -456,26 +690,13 @@ bool Cnf::satisfied_at_level_0(const Assignment& P, ClauseID id)
 
 
 
-// this is really counter intuitive.  It needs to be fixed
+// a clause can only be the reason for one of its two watched literals
 bool Cnf::is_a_reason(const Assignment& P,ClauseID id) const
 {
-  const CnfClause& c = operator[](id);
-  ClauseID real_id = c.id;
+  const CnfClause c = operator[](id);
   Reason r1 = P.get_reason(c[0]);
   Reason r2 = P.get_reason(c[1]);
-  bool old = (r1.id() == real_id || r2.id() == real_id);
-
-//   bool thorough = false;
-//   for (size_t i=0; i < c.size(); i++) {
-//     Reason r = P.get_reason(c[i]);
-//     if (r.id() == real_id) {
-//       thorough = true;
-//       break;
-//     }
-//   }
-
-//   if (old != thorough) cout << "id " << real_id << " old method " << old << " different from " << thorough << endl;
-  return old;
+  return (r1.id() == id || r2.id() == id);
 }
 
 
@@ -487,12 +708,13 @@ bool Cnf::is_a_reason(const Assignment& P,ClauseID id) const
 bool Cnf::valid(const Assignment& P) const
 {
   for (size_t i=0; i < number_clauses(); i++) {
+    const CnfClause c = operator[](i);
     size_t j=0;
-    for ( ; j < operator[](i).size(); j++)
-      if (P.watchable(operator[](i)[j])) break;
+    for ( ; j < c.size(); j++)
+      if (P.watchable(c[j])) break;
 
-    if (j >= operator[](i).size()) {
-      cerr << "unsatisfied clause: " << operator[](i) << endl;
+    if (j >= c.size()) {
+      cerr << "unsatisfied clause: " << c << endl;
       return false;
     }
   }
@@ -504,7 +726,7 @@ bool Cnf::valid(const Assignment& P) const
 bool Cnf::closed(const Assignment& P) const
 {
   for (size_t i=0; i < number_clauses(); i++) {
-    const CnfClause& c = operator[](i);
+    const CnfClause c = operator[](i);
     size_t number_unvalued = 0;
     size_t j=0;
     for ( ; j < c.size(); j++) {
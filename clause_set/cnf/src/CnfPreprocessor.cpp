@@ -0,0 +1,544 @@
+#include <algorithm>
+#include <climits>
+#include "CnfPreprocessor.h"
+
+namespace zap
+{
+
+CnfPreprocessor::CnfPreprocessor(size_t number_variables, ProofWriter* proof)
+  : m_num_vars(number_variables), m_occurs(2*number_variables + 2), m_value(number_variables + 1,UNKNOWN),
+	m_eliminated(number_variables + 1,false), m_mark(2*number_variables + 2,0), m_stamp(0), m_proof(proof),
+	m_steps(0), m_unsat(false), m_input_clauses(0), m_number_fixed(0), m_number_substituted(0),
+	m_number_eliminated(0), m_number_subsumed(0), m_number_strengthened(0)
+{ }
+
+
+
+//////////////////////////////////////   BOOK KEEPING   ////////////////////////////////////////////
+
+
+// sort and drop duplicate literals.  Complementary literals end up next to each other.
+bool CnfPreprocessor::normalize(vector<Literal>& lits)
+{
+  sort(lits.begin(),lits.end());
+  lits.erase(unique(lits.begin(),lits.end()),lits.end());
+  for (size_t i=1; i < lits.size(); i++)
+	if (lits[i].variable() == lits[i-1].variable()) return false;
+  return true;
+}
+
+
+void CnfPreprocessor::add_clause(const Literal* lits, size_t size)
+{
+  m_input_clauses++;
+  vector<Literal> c(lits,lits + size);
+  if (!normalize(c)) return;
+  if (c.empty()) m_unsat = true;
+  else store_clause(c);
+}
+
+
+void CnfPreprocessor::add_clauses(const Cnf& cnf)
+{
+  for (size_t i=0; i < cnf.number_clauses(); i++) {
+	const CnfClause c = cnf[i];
+	add_clause(c.begin(),c.size());
+  }
+}
+
+
+size_t CnfPreprocessor::store_clause(const vector<Literal>& lits)
+{
+  size_t id = m_clause.size();
+  unsigned long long signature = 0;
+  for (size_t i=0; i < lits.size(); i++) {
+	signature |= 1ULL << (lits[i].variable() % 64);
+	m_occurs[index(lits[i])].push_back(id);
+  }
+  m_clause.push_back(lits);
+  m_signature.push_back(signature);
+  m_removed.push_back(false);
+  m_queued.push_back(false);
+  if (lits.size() == 1) enqueue(lits[0]);
+  return id;
+}
+
+
+// the occurrence lists are cleaned up lazily
+void CnfPreprocessor::remove_clause(size_t id)
+{
+  m_removed[id] = true;
+  if (m_clause[id].size() > 1) log_remove(m_clause[id]);  // drat-trim ignores unit deletions anyway
+  vector<Literal>().swap(m_clause[id]);
+}
+
+
+// take l out of clause id.  Whatever made it redundant is still in the clause set.
+void CnfPreprocessor::strengthen(size_t id, Literal l)
+{
+  vector<Literal>& c = m_clause[id];
+  vector<Literal> old;
+  if (m_proof) old = c;
+  c.erase(find(c.begin(),c.end(),l));
+  log_add(c);
+  if (m_proof && old.size() > 1) log_remove(old);
+
+  vector<size_t>& occurs = m_occurs[index(l)];
+  vector<size_t>::iterator p = find(occurs.begin(),occurs.end(),id);
+  if (p != occurs.end()) occurs.erase(p);
+
+  m_signature[id] = 0;
+  for (size_t i=0; i < c.size(); i++) m_signature[id] |= 1ULL << (c[i].variable() % 64);
+  if (c.empty()) m_unsat = true;
+  else if (c.size() == 1) enqueue(c[0]);
+  queue_for_subsumption(id);
+}
+
+
+void CnfPreprocessor::enqueue(Literal l)
+{
+  unsigned char& value = m_value[l.variable()];
+  if (value == UNKNOWN) {
+	value = l.sign();
+	m_units.push_back(l);
+	m_number_fixed++;
+  }
+  else if (value != l.sign()) m_unsat = true;
+}
+
+
+void CnfPreprocessor::queue_for_subsumption(size_t id)
+{
+  if (m_queued[id]) return;
+  m_queued[id] = true;
+  m_queue.push_back(id);
+}
+
+
+void CnfPreprocessor::save_clause(const vector<Literal>& lits, Literal pivot)
+{
+  m_saved.push_back(pivot);
+  for (size_t i=0; i < lits.size(); i++)
+	if (lits[i] != pivot) m_saved.push_back(lits[i]);
+  m_saved_sizes.push_back(lits.size());
+}
+
+
+void CnfPreprocessor::log_add(const vector<Literal>& lits)
+{
+  if (m_proof) m_proof->add(lits.data(),lits.size());
+}
+
+
+void CnfPreprocessor::log_remove(const vector<Literal>& lits)
+{
+  if (m_proof) m_proof->remove(lits.data(),lits.size());
+}
+
+
+void CnfPreprocessor::clean_occurrences(Literal l)
+{
+  vector<size_t>& occurs = m_occurs[index(l)];
+  size_t j = 0;
+  for (size_t i=0; i < occurs.size(); i++)
+	if (!m_removed[occurs[i]]) occurs[j++] = occurs[i];
+  occurs.resize(j);
+}
+
+
+
+//////////////////////////////////////   UNIT PROPAGATION   ////////////////////////////////////////
+
+
+void CnfPreprocessor::propagate()
+{
+  while (!m_units.empty() && !m_unsat) {
+	Literal l = m_units.back();
+	m_units.pop_back();
+
+	vector<size_t> satisfied;
+	satisfied.swap(m_occurs[index(l)]);
+	for (size_t i=0; i < satisfied.size(); i++)
+	  if (!m_removed[satisfied[i]]) remove_clause(satisfied[i]);
+
+	vector<size_t> falsified;
+	falsified.swap(m_occurs[index(l.negate())]);
+	for (size_t i=0; i < falsified.size() && !m_unsat; i++)
+	  if (!m_removed[falsified[i]]) strengthen(falsified[i],l.negate());
+  }
+}
+
+
+
+//////////////////////////////////////   EQUIVALENT LITERALS   /////////////////////////////////////
+
+
+/*  Tarjan's algorithm on the binary implication graph, without recursion since the graph can be
+    deep.  A clause (a b) gives the edges -a -> b and -b -> a.  The components come in pairs, the
+    component of -x has the negations of the literals in the component of x, so picking the literal
+    with the smallest index in each component picks the negated representative for the mirror.  */
+
+void CnfPreprocessor::substitute_equivalences()
+{
+  size_t n = 2*m_num_vars + 2;
+  vector<size_t> start(n + 1,0);
+  for (size_t id=0; id < m_clause.size(); id++) {
+	if (m_removed[id] || m_clause[id].size() != 2) continue;
+	start[index(m_clause[id][0].negate()) + 1]++;
+	start[index(m_clause[id][1].negate()) + 1]++;
+  }
+  for (size_t i=0; i < n; i++) start[i+1] += start[i];
+  if (start[n] == 0) return;
+  vector<size_t> edges(start[n]);
+  vector<size_t> fill(start.begin(),start.end() - 1);
+  for (size_t id=0; id < m_clause.size(); id++) {
+	if (m_removed[id] || m_clause[id].size() != 2) continue;
+	const vector<Literal>& c = m_clause[id];
+	edges[fill[index(c[0].negate())]++] = index(c[1]);
+	edges[fill[index(c[1].negate())]++] = index(c[0]);
+  }
+
+  const size_t NONE = (size_t)-1;
+  vector<size_t> order(n,NONE), low(n,0), component(n,NONE), stack, calls, next_edge;
+  vector<bool> on_stack(n,false);
+  size_t counter = 0, number_components = 0;
+  vector<size_t> representative;            // by component, the literal index we substitute
+
+  for (size_t root=2; root < n; root++) {
+	if (order[root] != NONE) continue;
+	order[root] = low[root] = counter++;
+	stack.push_back(root);
+	on_stack[root] = true;
+	calls.push_back(root);
+	next_edge.push_back(start[root]);
+
+	while (!calls.empty()) {
+	  size_t u = calls.back();
+	  if (next_edge.back() < start[u+1]) {
+		size_t w = edges[next_edge.back()++];
+		if (order[w] == NONE) {
+		  order[w] = low[w] = counter++;
+		  stack.push_back(w);
+		  on_stack[w] = true;
+		  calls.push_back(w);
+		  next_edge.push_back(start[w]);
+		}
+		else if (on_stack[w]) low[u] = min(low[u],order[w]);
+		continue;
+	  }
+	  calls.pop_back();
+	  next_edge.pop_back();
+	  if (!calls.empty()) low[calls.back()] = min(low[calls.back()],low[u]);
+	  if (low[u] != order[u]) continue;
+
+	  size_t smallest = u, w;      // u is the root of a component
+	  size_t first = stack.size();
+	  do {
+		w = stack[--first];
+		smallest = min(smallest,w);
+	  } while (w != u);
+	  for (size_t i=first; i < stack.size(); i++) {
+		on_stack[stack[i]] = false;
+		component[stack[i]] = number_components;
+	  }
+	  stack.resize(first);
+	  representative.push_back(smallest);
+	  number_components++;
+	}
+  }
+
+  vector<Literal> substitute(m_num_vars + 1);   // for the positive literal, Literal() if none
+  bool any = false;
+  for (Variable v=1; v <= m_num_vars; v++) {
+	size_t positive = index(Literal(v,true));
+	if (component[positive] == component[positive ^ 1]) {
+	  // x and -x are equivalent.  -x is RUP (x implies -x), and then so is the empty clause.
+	  vector<Literal> unit(1,Literal(v,false));
+	  log_add(unit);
+	  m_unsat = true;
+	  return;
+	}
+	size_t r = representative[component[positive]];
+	if (r / 2 == v) continue;
+	substitute[v] = literal(r);
+	m_eliminated[v] = true;
+	m_number_substituted++;
+	any = true;
+	vector<Literal> c(2);
+	c[0] = Literal(v,true);  c[1] = literal(r).negate();   save_clause(c,c[0]);
+	c[0] = Literal(v,false); c[1] = literal(r);            save_clause(c,c[0]);
+  }
+  if (!any) return;
+
+  // all the rewritten clauses go in the proof before the binary clauses they need are deleted
+  vector<size_t> changed;
+  vector<vector<Literal> > rewritten;
+  vector<bool> keep;
+  for (size_t id=0; id < m_clause.size(); id++) {
+	if (m_removed[id]) continue;
+	const vector<Literal>& c = m_clause[id];
+	bool touches = false;
+	for (size_t i=0; i < c.size() && !touches; i++) touches = (substitute[c[i].variable()] != Literal());
+	if (!touches) continue;
+	vector<Literal> lits(c);
+	for (size_t i=0; i < lits.size(); i++) {
+	  Literal r = substitute[lits[i].variable()];
+	  if (r != Literal()) lits[i] = (lits[i].sign() ? r : r.negate());
+	}
+	changed.push_back(id);
+	keep.push_back(normalize(lits));
+	if (keep.back()) log_add(lits);
+	rewritten.push_back(lits);
+  }
+  for (size_t i=0; i < changed.size(); i++) {
+	remove_clause(changed[i]);
+	if (keep[i]) queue_for_subsumption(store_clause(rewritten[i]));
+  }
+  for (Variable v=1; v <= m_num_vars; v++)
+	if (substitute[v] != Literal()) {
+	  m_occurs[index(Literal(v,true))].clear();
+	  m_occurs[index(Literal(v,false))].clear();
+	}
+}
+
+
+
+//////////////////////////////////////   SUBSUMPTION   /////////////////////////////////////////////
+
+
+struct ShorterClause {
+  const vector<vector<Literal> >& clauses;
+  ShorterClause(const vector<vector<Literal> >& c) : clauses(c) { }
+  bool operator()(size_t a, size_t b) const { return clauses[a].size() < clauses[b].size(); }
+};
+
+
+void CnfPreprocessor::subsume()
+{
+  m_steps = 0;
+  stable_sort(m_queue.begin(),m_queue.end(),ShorterClause(m_clause));
+
+  for (size_t q=0; q < m_queue.size() && !m_unsat; q++) {
+	size_t id = m_queue[q];
+	m_queued[id] = false;
+	if (m_removed[id]) continue;
+	if (m_steps > PREPROCESS_STEP_LIMIT) continue;   // just empty the queue
+
+	// the variable of this clause in the fewest clauses
+	Literal best = m_clause[id][0];
+	size_t best_count = (size_t)-1;
+	for (size_t i=0; i < m_clause[id].size(); i++) {
+	  Literal l = m_clause[id][i];
+	  size_t count = m_occurs[index(l)].size() + m_occurs[index(l.negate())].size();
+	  if (count < best_count) { best = l; best_count = count; }
+	}
+
+	for (size_t side=0; side < 2; side++) {
+	  vector<size_t> candidates(m_occurs[index(side ? best.negate() : best)]);
+	  for (size_t k=0; k < candidates.size() && !m_unsat && !m_removed[id]; k++) {
+		size_t d = candidates[k];
+		const vector<Literal>& c = m_clause[id];
+		if (d == id || m_removed[d] || m_clause[d].size() < c.size()) continue;
+		if ((m_signature[id] & ~m_signature[d]) != 0) continue;
+
+		const vector<Literal>& dl = m_clause[d];
+		m_steps += dl.size() + c.size();
+		m_stamp++;
+		for (size_t i=0; i < dl.size(); i++) m_mark[index(dl[i])] = m_stamp;
+		Literal flipped;
+		bool subset = true;
+		for (size_t i=0; i < c.size() && subset; i++) {
+		  if (m_mark[index(c[i])] == m_stamp) continue;
+		  if (m_mark[index(c[i].negate())] == m_stamp && flipped == Literal()) flipped = c[i];
+		  else subset = false;
+		}
+		if (!subset) continue;
+		if (flipped == Literal()) {
+		  remove_clause(d);
+		  m_number_subsumed++;
+		}
+		else {
+		  strengthen(d,flipped.negate());
+		  m_number_strengthened++;
+		}
+	  }
+	}
+	if (!m_units.empty()) propagate();
+  }
+  m_queue.clear();
+}
+
+
+
+//////////////////////////////////////   VARIABLE ELIMINATION   ////////////////////////////////////
+
+
+// false if the resolvent on v is a tautology
+bool CnfPreprocessor::resolve(const vector<Literal>& p, const vector<Literal>& n, Variable v,
+							  vector<Literal>& resolvent)
+{
+  resolvent.clear();
+  m_stamp++;
+  for (size_t i=0; i < p.size(); i++) {
+	if (p[i].variable() == v) continue;
+	m_mark[index(p[i])] = m_stamp;
+	resolvent.push_back(p[i]);
+  }
+  m_steps += p.size() + n.size();
+  for (size_t i=0; i < n.size(); i++) {
+	if (n[i].variable() == v || m_mark[index(n[i])] == m_stamp) continue;
+	if (m_mark[index(n[i].negate())] == m_stamp) return false;
+	resolvent.push_back(n[i]);
+  }
+  return true;
+}
+
+
+bool CnfPreprocessor::try_elimination(Variable v, vector<Variable>& touched)
+{
+  if (m_value[v] != UNKNOWN || m_eliminated[v]) return false;
+  Literal positive(v,true), negative(v,false);
+  clean_occurrences(positive);
+  clean_occurrences(negative);
+  const vector<size_t>& pos = m_occurs[index(positive)];
+  const vector<size_t>& neg = m_occurs[index(negative)];
+  size_t before = pos.size() + neg.size();
+  if (before == 0 || before > ELIMINATION_CLAUSE_LIMIT) return false;
+
+  vector<vector<Literal> > resolvents;
+  vector<Literal> resolvent;
+  for (size_t i=0; i < pos.size(); i++)
+	for (size_t j=0; j < neg.size(); j++) {
+	  if (!resolve(m_clause[pos[i]],m_clause[neg[j]],v,resolvent)) continue;
+	  if (resolvent.size() > RESOLVENT_LENGTH_LIMIT || resolvents.size() == before) return false;
+	  resolvents.push_back(resolvent);
+	}
+
+  for (size_t i=0; i < resolvents.size(); i++) {
+	normalize(resolvents[i]);
+	log_add(resolvents[i]);
+  }
+  for (size_t side=0; side < 2; side++) {
+	const vector<size_t>& occurs = (side ? neg : pos);
+	Literal pivot = (side ? negative : positive);
+	for (size_t i=0; i < occurs.size(); i++) {
+	  const vector<Literal>& c = m_clause[occurs[i]];
+	  for (size_t j=0; j < c.size(); j++) touched.push_back(c[j].variable());
+	  save_clause(c,pivot);
+	  remove_clause(occurs[i]);
+	}
+  }
+  m_occurs[index(positive)].clear();
+  m_occurs[index(negative)].clear();
+  m_eliminated[v] = true;
+  m_number_eliminated++;
+
+  for (size_t i=0; i < resolvents.size(); i++) {
+	if (resolvents[i].empty()) { m_unsat = true; break; }
+	queue_for_subsumption(store_clause(resolvents[i]));
+  }
+  propagate();
+  return true;
+}
+
+
+struct CheaperElimination {
+  const vector<vector<size_t> >& occurs;
+  CheaperElimination(const vector<vector<size_t> >& o) : occurs(o) { }
+  size_t cost(Variable v) const { return occurs[2*v].size() * occurs[2*v+1].size(); }
+  bool operator()(Variable a, Variable b) const { return cost(a) < cost(b); }
+};
+
+
+void CnfPreprocessor::eliminate()
+{
+  m_steps = 0;
+  vector<Variable> candidates, touched;
+  for (Variable v=1; v <= m_num_vars; v++) candidates.push_back(v);
+
+  for (size_t round=0; round < ELIMINATION_ROUNDS && !candidates.empty() && !m_unsat; round++) {
+	stable_sort(candidates.begin(),candidates.end(),CheaperElimination(m_occurs));
+	touched.clear();
+	for (size_t i=0; i < candidates.size() && !m_unsat; i++) {
+	  if (m_steps > PREPROCESS_STEP_LIMIT) return;
+	  try_elimination(candidates[i],touched);
+	}
+	sort(touched.begin(),touched.end());
+	touched.erase(unique(touched.begin(),touched.end()),touched.end());
+	candidates.swap(touched);
+  }
+}
+
+
+
+//////////////////////////////////////   PUBLIC   ////////////////////////////////////////////////////
+
+
+Result CnfPreprocessor::simplify()
+{
+  PhaseTimer timer(global_vars.phase_time[PHASE_PREPROCESS]);
+  if (!m_unsat) propagate();
+  if (!m_unsat) substitute_equivalences();
+  if (!m_unsat) propagate();
+  if (!m_unsat) {
+	for (size_t id=0; id < m_clause.size(); id++)
+	  if (!m_removed[id]) queue_for_subsumption(id);
+	subsume();
+  }
+  if (!m_unsat) eliminate();
+  if (!m_unsat) subsume();
+  return m_unsat ? CONTRADICTION : SUCCESS;
+}
+
+
+// the fixed variables go in as unit clauses so the solver's model has them right
+void CnfPreprocessor::build(Cnf& cnf) const
+{
+  size_t number_clauses = 0, number_lits = 0;
+  for (size_t id=0; id < m_clause.size(); id++)
+	if (!m_removed[id]) {
+	  number_clauses++;
+	  number_lits += m_clause[id].size();
+	}
+  cnf.begin_input(number_clauses + m_number_fixed,number_lits + m_number_fixed);
+  for (Variable v=1; v <= m_num_vars; v++)
+	if (m_value[v] != UNKNOWN) {
+	  Literal unit(v,m_value[v]);
+	  cnf.append_input_clause(&unit,1);
+	}
+  for (size_t id=0; id < m_clause.size(); id++)
+	if (!m_removed[id] && m_clause[id].size() > 1)
+	  cnf.append_input_clause(m_clause[id].data(),m_clause[id].size());
+  cnf.finish_input();
+}
+
+
+void CnfPreprocessor::extend_model(vector<bool>& model) const
+{
+  model.resize(m_num_vars + 1,false);
+  for (Variable v=1; v <= m_num_vars; v++)
+	if (m_value[v] != UNKNOWN) model[v] = m_value[v];
+
+  size_t end = m_saved.size();
+  for (size_t k = m_saved_sizes.size(); k > 0; k--) {
+	size_t begin = end - m_saved_sizes[k-1];
+	bool satisfied = false;
+	for (size_t i=begin; i < end && !satisfied; i++)
+	  satisfied = (model[m_saved[i].variable()] == m_saved[i].sign());
+	if (!satisfied) model[m_saved[begin].variable()] = m_saved[begin].sign();
+	end = begin;
+  }
+}
+
+
+void CnfPreprocessor::print_statistics(ostream& os) const
+{
+  size_t left = 0;
+  for (size_t id=0; id < m_clause.size(); id++) if (!m_removed[id]) left++;
+  os << "// preprocessing: " << left << " of " << m_input_clauses << " clauses left, "
+	 << m_number_fixed << " variables fixed, " << m_number_substituted << " substituted, "
+	 << m_number_eliminated << " eliminated, " << m_number_subsumed << " clauses subsumed, "
+	 << m_number_strengthened << " strengthened" << endl;
+}
+
+} // end namespace zap
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include "CnfRenumbering.h"
+
+namespace zap
+{
+
+// orders variables by the number of clauses they're in.  occurs_start is the index into the packed
+// occurrence lists, so the clauses of v are the ones from occurs_start[v] to occurs_start[v+1].
+struct LowerDegree
+{
+  const vector<size_t>& m_start;
+  LowerDegree(const vector<size_t>& occurs_start) : m_start(occurs_start) { }
+  size_t degree(Variable v) const { return m_start[v+1] - m_start[v]; }
+  bool operator()(Variable a, Variable b) const { return degree(a) < degree(b); }
+};
+
+
+
+CnfRenumbering::CnfRenumbering(const Cnf& cnf)
+  : m_num_vars(cnf.number_variables()), m_new(m_num_vars + 1,0), m_old(1,0), m_components(0)
+{
+  PhaseTimer timer(global_vars.phase_time[PHASE_RENUMBER]);
+  size_t number_clauses = cnf.number_clauses();
+
+  // occurrence lists packed into one array, which matters with 10 million variables
+  vector<size_t> start(m_num_vars + 2,0);
+  for (size_t i=0; i < number_clauses; i++) {
+	const CnfClause c = cnf[i];
+	for (size_t j=0; j < c.size(); j++) start[c[j].variable() + 1]++;
+  }
+  for (size_t v=1; v < start.size(); v++) start[v] += start[v-1];
+  vector<size_t> occurs(start.back());
+  vector<size_t> next(start.begin(),start.end() - 1);
+  for (size_t i=0; i < number_clauses; i++) {
+	const CnfClause c = cnf[i];
+	for (size_t j=0; j < c.size(); j++) occurs[next[c[j].variable()]++] = i;
+  }
+
+  LowerDegree lower_degree(start);
+  vector<Variable> roots;
+  for (Variable v=1; v <= m_num_vars; v++)
+	if (lower_degree.degree(v)) roots.push_back(v);
+  stable_sort(roots.begin(),roots.end(),lower_degree);
+
+  // breadth first, with m_old as the queue
+  vector<bool> scanned(number_clauses,false);
+  m_old.reserve(m_num_vars + 1);
+  for (size_t r=0; r < roots.size(); r++) {
+	if (m_new[roots[r]]) continue;
+	m_components++;
+	m_new[roots[r]] = m_old.size();
+	m_old.push_back(roots[r]);
+
+	for (size_t head = m_old.size() - 1; head < m_old.size(); head++) {
+	  Variable v = m_old[head];
+	  size_t first = m_old.size();
+	  for (size_t o = start[v]; o < start[v+1]; o++) {
+		if (scanned[occurs[o]]) continue;
+		scanned[occurs[o]] = true;
+		const CnfClause c = cnf[occurs[o]];
+		for (size_t j=0; j < c.size(); j++) {
+		  Variable u = c[j].variable();
+		  if (m_new[u]) continue;
+		  m_new[u] = m_old.size();
+		  m_old.push_back(u);
+		}
+	  }
+	  stable_sort(m_old.begin() + first,m_old.end(),lower_degree);
+	  for (size_t i=first; i < m_old.size(); i++) m_new[m_old[i]] = i;
+	}
+  }
+
+  for (Variable v=1; v <= m_num_vars; v++)   // in no clause at all
+	if (!m_new[v]) {
+	  m_new[v] = m_old.size();
+	  m_old.push_back(v);
+	}
+
+  m_span_before = average_span(cnf,NULL);
+  m_span_after = average_span(cnf,&m_new);
+}
+
+
+
+// number is NULL for the numbering the clauses already have
+double CnfRenumbering::average_span(const Cnf& cnf, const vector<Variable>* number)
+{
+  if (cnf.number_clauses() == 0) return 0;
+  double total = 0;
+  for (size_t i=0; i < cnf.number_clauses(); i++) {
+	const CnfClause c = cnf[i];
+	Variable low = (Variable)-1, high = 0;
+	for (size_t j=0; j < c.size(); j++) {
+	  Variable v = number ? (*number)[c[j].variable()] : c[j].variable();
+	  low = min(low,v);
+	  high = max(high,v);
+	}
+	if (high) total += high - low;
+  }
+  return total / cnf.number_clauses();
+}
+
+
+
+void CnfRenumbering::build(const Cnf& input, Cnf& cnf) const
+{
+  PhaseTimer timer(global_vars.phase_time[PHASE_RENUMBER]);
+  size_t number_clauses = input.number_clauses();
+
+  // counting sort on the lowest new variable of each clause.  Units go first like finish_input
+  // wants them, so it doesn't need to move anything.
+  vector<size_t> start(m_num_vars + 2,0);
+  vector<Variable> key(number_clauses,0);
+  size_t number_lits = 0;
+  for (size_t i=0; i < number_clauses; i++) {
+	const CnfClause c = input[i];
+	number_lits += c.size();
+	if (c.size() > 1) {
+	  key[i] = m_num_vars;
+	  for (size_t j=0; j < c.size(); j++) key[i] = min(key[i],m_new[c[j].variable()]);
+	}
+	start[key[i] + 1]++;
+  }
+  for (size_t k=1; k < start.size(); k++) start[k] += start[k-1];
+  vector<size_t> order(number_clauses);
+  for (size_t i=0; i < number_clauses; i++) order[start[key[i]]++] = i;
+
+  cnf.begin_input(number_clauses,number_lits);
+  vector<Literal> lits;
+  for (size_t k=0; k < number_clauses; k++) {
+	const CnfClause c = input[order[k]];
+	lits.clear();
+	for (size_t j=0; j < c.size(); j++) lits.push_back(Literal(m_new[c[j].variable()],c[j].sign()));
+	sort(lits.begin(),lits.end());
+	cnf.append_input_clause(lits.data(),lits.size());
+  }
+  cnf.finish_input();
+}
+
+
+
+void CnfRenumbering::rename_atoms() const
+{
+  if (global_vars.atom_name_map.size() != m_num_vars) quit("renumbering needs a name for every variable");
+  global_vars.atom_name_map.renumber(m_new);
+}
+
+
+
+void CnfRenumbering::restore_model(vector<bool>& model) const
+{
+  vector<bool> renumbered(model);
+  model.assign(m_num_vars + 1,false);
+  for (Variable v=1; v <= m_num_vars && v < renumbered.size(); v++) model[m_old[v]] = renumbered[v];
+}
+
+
+
+void CnfRenumbering::print_statistics(ostream& os) const
+{
+  os << "// renumbering: " << m_num_vars << " variables in " << m_components
+	 << " components, average clause span " << m_span_before << " -> " << m_span_after
+	 << (improves() ? "" : ", keeping the old numbering") << endl;
+}
+
+} // end namespace zap
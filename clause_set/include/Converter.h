@@ -49,6 +49,7 @@ class PfsConverter : public Converter {
   vector<PfsClause> build_augmented_from_group(InputClause& ic);
   ClauseSet* convert_to_cnf();
   ClauseSet* convert_to_pfs() { return &m_theory; }
+  ClauseSet* convert_to_hybrid();
   ClauseSet* convert_to_symres();
 
  public:
@@ -90,6 +91,8 @@ inline ClauseSet* PfsConverter::convert(ClauseSetType t) {
       return convert_to_symres();
     case PFS:
       return convert_to_pfs();
+    case HYBRID:
+      return convert_to_hybrid();
     case GROUP_BASED:
       quit("can't convert PFS to GROUP_BASED yet");
       break;
@@ -0,0 +1,60 @@
+#ifndef _GROUND_CACHE_H
+#define _GROUND_CACHE_H
+#include "common.h"
+#include "Assignment.h"
+#include "Transport.h"
+
+namespace zap
+{
+
+////////////////////////////////////////   GROUND CACHE   ////////////////////////////////////////
+/*
+  The ground instances of some of the first-order clauses of a Pfs, kept as plain watched
+  literal clauses.  Pfs decides which first-order clauses go in here (see Pfs::refresh_ground_cache)
+  and while a clause is in the cache its instances are propagated here instead of through its
+  watch tree.
+
+  The instances live back to back in one literal arena with the two watched literals in the
+  first two positions.  Every instance remembers the first-order clause it came from and that's
+  the id we put in the Reasons, so conflict analysis sees the same thing it would have seen if
+  the watch tree had found the unit.  We keep the instances whole, even the literals that are
+  false at level 0, since the group of the first-order clause only makes sense on a real instance.
+
+  Instances are only added and removed at decision level 0, when P is closed.  An instance that's
+  satisfied at level 0 stays satisfied so we don't bother keeping it.
+*/
+
+class GroundCache
+{
+  class Instance {
+  public:
+	size_t     start;
+	size_t     size;
+	ClauseID   owner;
+	Instance(size_t s, size_t n, ClauseID o) : start(s), size(n), owner(o) { }
+  };
+
+  vector<Literal>            m_literals;
+  vector<Instance>           m_instances;
+  vector<vector<size_t> >    m_watchers;      // instances watching each literal, see index()
+  size_t                     m_number_dead;   // literals in the arena that belong to removed instances
+
+  size_t   index(Literal l) const { return 2*l.variable() + l.sign(); }
+  void     watch(size_t i);
+  void     compact();
+
+public:
+  GroundCache() : m_number_dead(0) { }
+
+  void     initialize(size_t number_variables);
+
+  bool     add(ClauseID owner, const GroundClauseBuffer& instances, const Assignment& P);
+  void     remove(ClauseID owner);
+  size_t   number_literals() const { return m_literals.size() - m_number_dead; }
+
+  // propagates a, which P just made true.  hits counts the units and conflicts for each owner.
+  Result   get_implications(Assignment& P, Literal a, vector<size_t>& hits);
+};
+
+} // end namespace zap
+#endif
@@ -6,6 +6,7 @@
 #include "Assignment.h"
 #include "ClauseSet.h"
 #include "Transport.h"
+#include "GroundCache.h"
 #include "FastSet.h"
 #include "LocalSearch2.h"
 #include "LocalSearch3.h"
@@ -24,15 +25,15 @@ namespace zap
 	mutable PredicateSym*        m_predicate_sym;
 	PfsTransportVector       m_transports;  // this should be a pointer to a transport vector
 	WatchIndex               m_watch_index;
-	Ptr<WatchNode>           m_root;
+	Ptr<WatchTree>           m_tree;
 	LocalSearch2             m_local_search;
 	LocalSearch3             m_local_search3;
 	vector<Literal>          m_universe;  /// maybe this cache should be in m_transport since that is who creates it.
 	vector<bool>             m_background_symmetry;
 
 	public:
-	PfsClause() : m_root(WatchNode(Clause())) { }
-	PfsClause(const Clause& c) : Clause(c), m_root(c) { }
+	PfsClause() : m_tree(WatchTree(Clause())) { }
+	PfsClause(const Clause& c) : Clause(c), m_tree(WatchTree(c)) { }
 	PfsClause(const Clause& c, const Ptr<ProductSubgroup>& ps);
 	//	PfsClause(const Clause& c, const ProductSubgroup& ps, PredicateSym* psp );
 	PfsClause(const Clause& c, const Ptr<ProductSubgroup>& pps,PredicateSym* psp);
@@ -46,13 +47,16 @@ namespace zap
 	void build_watch_tree();
 	void initialize_local_search() { m_local_search3.initialize(Clause(*this),m_predicate_sym); }
 	size_t number_ground_clauses() { return m_transports.number_ground_clauses(); }
+	bool has_transports() const { return !m_transports.empty(); }
+	size_t number_subtrees() const { return m_transports.number_subtrees(); }
 	void get_ground_clauses(vector<Clause>& ground_clauses);
-	bool k_transporter(Assignment& P, Literal l);
+	void get_ground_clauses(size_t first, size_t last, GroundClauseBuffer& out) const;
+	bool k_transporter(Assignment& P, Literal l, TouchCounter& touched);
 	bool get_symmetric_unit_lits(Assignment& P, Literal unit_lit);
 	bool get_cluster(Assignment& P, Literal unit_lit);
 
 	
-	bool k_transport_watch_tree(Assignment& P, Literal l);
+	bool k_transport_watch_tree(Assignment& P, Literal l, TouchCounter& touched);
 	bool k_transport_local_search(Assignment& P, Literal l);
 
 	const vector<Literal>& universe();
@@ -71,6 +75,13 @@ class Pfs : public vector<PfsClause>, public virtual ClauseSet
   size_t                 m_num_clauses;
   size_t                 m_end_original_clauses; // marks end of original input and points to first learned clause
   vector<VariableWatch>  m_watchers;
+  vector<VariableWatch>  m_universe_index;       // the original clauses whose universe contains each literal
+
+  GroundCache            m_ground_cache;         // hybrid mode, see refresh_ground_cache
+  size_t                 m_ground_cache_budget;  // most literals in the cache, 0 if we aren't in hybrid mode
+  vector<size_t>         m_hits;                 // recent units and conflicts from each original clause
+  vector<bool>           m_grounded;             // the original clauses propagated by the cache
+  size_t                 m_last_refresh;         // backtracks at the last refresh
 
   vector<double>         m_vsids_counts;
   double                 m_score_inc;
@@ -83,7 +94,10 @@ class Pfs : public vector<PfsClause>, public virtual ClauseSet
   PredicateSym           m_predicate_sym;
   
   void adjust_counts(size_t index);
-  Result    get_implications_ground(Assignment& P, Literal l);
+  void      build_universe_index();
+  void      refresh_ground_cache(Assignment& P);
+  Result    get_implications_ground(Assignment& P, Literal l, TouchCounter& touched);
+  Result    get_implications_hybrid(Assignment& P, Literal l, TouchCounter& touched);
     void      increment_variable_score(size_t v);
   void      rescale_variable_scores();
   void      increment_clause_score(ClauseID id);
@@ -100,7 +114,7 @@ class Pfs : public vector<PfsClause>, public virtual ClauseSet
 
 public:
 
-  Pfs() { }
+  Pfs() : m_ground_cache_budget(0), m_last_refresh(0) { }
   Pfs(const GlobalProductGroup& gpg);
   // don't really like this type of access to a ClauseSet.  Should be a tighter interface.
   GlobalProductGroup& global_group() {  return m_global_group; }
@@ -118,7 +132,8 @@ public:
   
   // void add_clause(const Clause& c) { push_back(PfsClause(c,ProductSubgroup(&m_global_group),&m_predicate_sym)); }
 
-  void get_ground_clauses(vector<Clause>& ground_clauses);
+  void get_ground_clauses(vector<GroundClauseBuffer>& ground_clauses);
+  void use_ground_cache(size_t budget);
   
   // the ClauseSet interface functions
   size_t    number_variables()                         const { return m_num_vars; }
@@ -157,7 +172,7 @@ inline ostream& operator<<(ostream& os, const Pfs& t) {
 
 inline PfsClause::PfsClause(const PfsClause& c)
   : Clause(Clause(c)), m_subgroup(c.m_subgroup), m_predicate_sym(c.m_predicate_sym), m_transports(c.m_transports),
-  m_watch_index(c.m_watch_index), m_root(c.m_root), m_local_search(c.m_local_search),
+  m_watch_index(c.m_watch_index), m_tree(c.m_tree), m_local_search(c.m_local_search),
   m_local_search3(c.m_local_search3), m_universe(c.m_universe)
 {
   m_local_search.update_transport_pointer(&m_transports);
@@ -170,9 +185,9 @@ inline void PfsClause::build_watch_tree() {
   
   const vector<Literal>& U = universe();
   m_watch_index = WatchIndex(vector<PfsVariableWatch>(U.back().variable()+1));
-  m_root->set_clause(vector<Literal>(*this));
-  m_root->build(m_transports,m_watch_index);
-  m_root->build_right_leaf();
+  m_tree->set_clause(vector<Literal>(*this));
+  m_tree->build(m_transports,m_watch_index);
+  m_tree->build_right_leaf();
 }
 
 inline void PfsClause::build_transports()
@@ -189,7 +204,14 @@ inline void PfsClause::build_transports()
 
 inline void PfsClause::get_ground_clauses(vector<Clause>& ground_clauses) {
   if (m_transports.empty()) build_transports();
-  m_transports.cnf(0,*this,ground_clauses);
+  GroundClauseBuffer buffer;
+  get_ground_clauses(0,number_subtrees(),buffer);
+  buffer.get_clauses(ground_clauses);
+}
+
+// the transports have to be built already, this gets called from the grounding threads
+inline void PfsClause::get_ground_clauses(size_t first, size_t last, GroundClauseBuffer& out) const {
+  m_transports.cnf(*this,first,last,out);
 }
 
 inline const vector<Literal>& PfsClause::universe()
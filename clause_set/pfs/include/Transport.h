@@ -15,6 +15,7 @@ namespace zap
 
 class Tanswer;
 class WatchIndex;
+class TouchCounter;
 
 
 //**************************************************************************************************/
@@ -73,6 +74,23 @@ inline const vector<Literal>& OrbitCache::get_orbit(Literal l) const
   return operator[](variable_index[l.variable()] + (l.sign() ? 0 : 1));
 }
 
+//**************************************************************************************************/
+/* GroundClauseBuffer : The ground clauses of a PfsClause (or part of one) written back to back
+ * in a single literal array with the length of each clause alongside.  Grounding a big
+ * theory makes millions of small clauses and this keeps us from allocating each one.
+ */
+class GroundClauseBuffer
+{
+public:
+  vector<Literal>    literals;
+  vector<size_t>     sizes;
+
+  void add(const vector<Literal>& c) { literals.insert(literals.end(),c.begin(),c.end()); sizes.push_back(c.size()); }
+  void get_clauses(vector<Clause>& clauses) const;
+};
+
+
+
 //**************************************************************************************************/
 /* PfsTransportVector : This is everything you need to build the k-transporter search tree.
  *
@@ -105,10 +123,14 @@ public:
   size_t                    depth_fixed(Literal l) const;
   size_t                    number_ground_clauses() const;
   bool                      empty() const { return size() <= 1; }
-  void                      cnf(size_t depth, vector<Literal> clause, vector<Clause>& clauses) const;
+  size_t                    number_subtrees() const;
+  void                      cnf(const vector<Literal>& clause, size_t first, size_t last, GroundClauseBuffer& out) const;
   
 
   void                      order_tree(size_t depth, vector<Literal> still_to_fix);
+
+private:
+  void                      cnf(size_t depth, vector<vector<Literal> >& images, GroundClauseBuffer& out) const;
 };
 
 
@@ -134,56 +156,107 @@ public:
 //**************************************************************************************************/
 /* WatchNode : This is a node in the k-transporter search tree
  *
- *
+ * Nodes live in the node pool of a WatchTree and refer to each other by their index in the pool.
+ * The children of a node are stored next to each other, so a node only needs the index of its
+ * first child and how many children it has.  Only the leaves are ever checked during propagation,
+ * the interior nodes just keep what get_skip needs (m_fixed and m_right_leaf), so we drop their
+ * clauses once the tree is built.
  */
 //**************************************************************************************************/
+const size_t NO_NODE = (size_t)-1;
+
 class WatchNode
 {
-  static size_t                     m_next_id;               // for search statistics
-  
   size_t                            m_depth;                 
   size_t                            m_child;
   size_t                            m_level_id;
   size_t                            m_right_leaf;            // ID of the right most leaf node in subtree
-  WatchNode*                        m_parent;
-  vector<WatchNode*>                m_children;
-  Clause                            m_clause;
+  size_t                            m_parent;
+  size_t                            m_first_child;
+  size_t                            m_number_children;
+  vector<Literal>                   m_clause;
   vector<BackWatcher>               m_back_watchers;
   vector<bool>                      m_fixed;                
-  
-  WatchNode* expand(const PfsTransportVector& transports);
-  bool next_child(PfsCounter& counter, const PfsTransport& transport);
-  size_t right_most_leaf() const;
-  size_t get_skip(size_t index) const;
+
+  friend class WatchTree;
   
 public:
-  WatchNode(const vector<Literal>& clause) : m_depth(0), m_child(0),
-    m_level_id(0), m_right_leaf(0), m_parent(0), m_clause(clause), m_fixed(clause.size(),false) { }
-  WatchNode(const WatchNode& n) : m_depth(n.m_depth),
-    m_child(n.m_child), m_level_id(n.m_level_id), m_right_leaf(0), m_parent(n.m_parent),
-    m_clause(n.m_clause), m_fixed(n.m_fixed) { }
-  // need a copy constructor here.  Shouldn't copy m_children or the destructor will seg fault
-  ~WatchNode() { for (size_t i=0; i < m_children.size(); i++) delete m_children[i]; }
+  WatchNode(const vector<Literal>& clause) : m_depth(0), m_child(0), m_level_id(0), m_right_leaf(0),
+    m_parent(NO_NODE), m_first_child(NO_NODE), m_number_children(0), m_clause(clause),
+    m_fixed(clause.size(),false) { }
+  
+  friend ostream& operator << (ostream& os, const WatchNode& wn);
+};
+
+
 
+//**************************************************************************************************/
+/* WatchTree : the node pool for the k-transporter search tree of one clause.  Node 0 is the root.
+ */
+//**************************************************************************************************/
+class WatchTree
+{
+  vector<WatchNode>                 m_nodes;
+
+  void       build(size_t n, const PfsTransportVector& transports, WatchIndex& watch_index);
+  size_t     expand(size_t n, const PfsTransportVector& transports);
+  bool       next_child(PfsCounter& counter, const PfsTransportVector& transports);
+  size_t     right_most_leaf(size_t n) const;
+  size_t     get_skip(size_t n, size_t index) const;
   
+public:
+  WatchTree(const vector<Literal>& clause) : m_nodes(1,WatchNode(clause)) { }
+
   void       set_clause(const vector<Literal>& c);
   void       build(const PfsTransportVector& transports, WatchIndex& watch_index);
   void       build_right_leaf();
-  pair<size_t,bool>     check(Assignment& P,vector<BackWatcher>& to_remove,int& new_watcher,ClauseID id,WatchIndex& watch_index);
-  
-  friend ostream& operator << (ostream& os, const WatchNode& wn);
+  pair<size_t,bool>     check(size_t n, Assignment& P,vector<BackWatcher>& to_remove,int& new_watcher,ClauseID id,WatchIndex& watch_index,
+							  TouchCounter& touched);
+  size_t     size() const { return m_nodes.size(); }
 };
 
 
 
 
+//**************************************************************************************************/
+/* WatchSet : the leaves watching one literal, as (leaf id, node) pairs sorted by leaf id so
+ * k_transport_watch_tree can walk them in order and jump past whole subtrees with upper_bound.
+ *
+ * The set we're walking never changes while we walk it (its literal is false and we only add
+ * watches on unvalued literals) but other sets do.  So new watches go on a short unsorted list
+ * and removed ones are just marked, and settle() merges everything back into one sorted vector
+ * before the next walk.
+ */
+//**************************************************************************************************/
+class WatchSet
+{
+public:
+  typedef pair<size_t,size_t>  Watch;   // leaf id, node
+
+private:
+  vector<Watch>                m_watches;
+  vector<Watch>                m_added;
+  size_t                       m_removed;
+
+public:
+  WatchSet() : m_removed(0) { }
+  
+  void                  add(size_t id, size_t node) { m_added.push_back(Watch(id,node)); }
+  bool                  remove(size_t id);
+  void                  settle();
+  const vector<Watch>&  watches() const { return m_watches; }
+  size_t                upper_bound(size_t id) const;
+};
+
+
+
 //**************************************************************************************************/
 class PfsVariableWatch
 {
 public:
-  map<size_t,WatchNode*> index[2];
-  const map<size_t,WatchNode*>& get_index(bool b) const { return (b ? index[1] : index[0]); }
-  map<size_t,WatchNode*>& get_index(bool b) { return (b ? index[1] : index[0]); }
+  WatchSet index[2];
+  const WatchSet& get_index(bool b) const { return (b ? index[1] : index[0]); }
+  WatchSet& get_index(bool b) { return (b ? index[1] : index[0]); }
 };
 
 //**************************************************************************************************/
@@ -192,14 +265,11 @@ class WatchIndex : public vector<PfsVariableWatch>
 public:
   WatchIndex() { }
   WatchIndex(const vector<PfsVariableWatch>& w) : vector<PfsVariableWatch>(w) { }
-  map<size_t,WatchNode*>& get_index(Literal l) { return operator[](l.variable()).get_index(l.sign()); }
-  void add_watch(const Literal l, WatchNode* w, size_t id) { get_index(l)[id] = w; }
+  WatchSet& get_index(Literal l) { return operator[](l.variable()).get_index(l.sign()); }
+  void add_watch(const Literal l, size_t node, size_t id) { get_index(l).add(id,node); }
   void remove_watch(const BackWatcher b) {
 	if (b.lit.variable() >= size()) quit("bad BackWatcher lit ");
-    map<size_t,WatchNode*>& watchers = get_index(b.lit);
-    map<size_t,WatchNode*>::iterator it = watchers.find(b.id);
-	if (it == watchers.end()) quit("bad BackWatcher id");
-    watchers.erase(it);
+	if (!get_index(b.lit).remove(b.id)) quit("bad BackWatcher id");
   }
 };
 
@@ -207,9 +277,9 @@ public:
 
 ///////////////////////////////  INLINES  ///////////////////////////////////////////
 
-inline void WatchNode::set_clause(const vector<Literal>& c)
+inline void WatchTree::set_clause(const vector<Literal>& c)
 {
-  m_clause = c; m_fixed = vector<bool>(c.size(),false); 
+  m_nodes.assign(1,WatchNode(c));
 }
 
 
@@ -296,6 +366,21 @@ inline size_t PfsTransportVector::number_ground_clauses() const
 }
 
 
+// the children of the root.  Grounding can split the work up between them.
+inline size_t PfsTransportVector::number_subtrees() const
+{
+  return (size() <= 1 ? 1 : operator[](1).number_of_images());
+}
+
+
+inline void GroundClauseBuffer::get_clauses(vector<Clause>& clauses) const
+{
+  const Literal* c = literals.data();
+  for (size_t i=0; i < sizes.size(); c += sizes[i++])
+	clauses.push_back(Clause(vector<Literal>(c,c+sizes[i])));
+}
+
+
 inline bool PfsTransportVector::fixes(Literal l, size_t depth) const
 {
   for (size_t i=depth+1; i < size(); i++) 
@@ -314,18 +399,9 @@ inline size_t PfsTransportVector::depth_fixed(Literal l) const
 
 
 
-inline bool WatchNode::next_child(PfsCounter& counter, const PfsTransport& transport)
+inline size_t WatchSet::upper_bound(size_t id) const
 {
-  if (!counter.next()) return false;
-  WatchNode* node = new WatchNode(*m_children.back());  // make a copy of earlier sibling
-  //  node->m_id = ++m_next_id;
-  node->m_child++;
-  node->m_level_id++;
-  vector<Literal>& clause = node->m_clause;
-  for (size_t i=0; i < clause.size(); i++) 
-    clause[i] = transport.action().image(clause[i],counter);
-  m_children.push_back(node);
-  return true;
+  return std::upper_bound(m_watches.begin(),m_watches.end(),Watch(id,NO_NODE)) - m_watches.begin();
 }
 
 inline ostream& operator << (ostream& os, const PfsTransport& pgt)
@@ -0,0 +1,132 @@
+#include "GroundCache.h"
+#include "TouchCounter.h"
+
+namespace zap
+{
+
+// every literal gets a watch list up front, so nothing moves while get_implications holds one
+void GroundCache::initialize(size_t number_variables)
+{
+  m_watchers.assign(2*(number_variables+1),vector<size_t>());
+}
+
+
+void GroundCache::watch(size_t i)
+{
+  const Instance& c = m_instances[i];
+  for (size_t j=0; j < 2; j++) m_watchers[index(m_literals[c.start + j])].push_back(i);
+}
+
+
+// P has to be closed and at level 0.  Then every instance that isn't satisfied has at least two
+// literals that aren't false and we watch those.  If one doesn't, P wasn't closed under the
+// first-order clause and we leave it out of the cache.
+bool GroundCache::add(ClauseID owner, const GroundClauseBuffer& instances, const Assignment& P)
+{
+  const Literal* c = instances.literals.data();
+  for (size_t i=0; i < instances.sizes.size(); c += instances.sizes[i++]) {
+	size_t size = instances.sizes[i];
+	size_t free[2];
+	size_t number_free = 0;
+	bool satisfied = false;
+	for (size_t j=0; j < size && !satisfied; j++) {
+	  size_t value = P.value(c[j].variable());
+	  if (value == (size_t)c[j].sign()) satisfied = true;
+	  else if (value == UNKNOWN && number_free < 2) free[number_free++] = j;
+	}
+	if (satisfied) continue;
+	if (number_free < 2) {
+	  remove(owner);
+	  return false;
+	}
+
+	size_t start = m_literals.size();
+	m_literals.insert(m_literals.end(),c,c + size);
+	swap(m_literals[start],m_literals[start + free[0]]);
+	swap(m_literals[start + 1],m_literals[start + free[1]]);  // free[1] > free[0] >= 0, so it didn't move
+	m_instances.push_back(Instance(start,size,owner));
+	watch(m_instances.size()-1);
+  }
+  return true;
+}
+
+
+void GroundCache::remove(ClauseID owner)
+{
+  for (size_t i=0; i < m_instances.size(); i++) {
+	Instance& c = m_instances[i];
+	if (c.owner != owner) continue;
+	for (size_t j=0; j < 2; j++) {
+	  vector<size_t>& w = m_watchers[index(m_literals[c.start + j])];
+	  for (size_t k=0; k < w.size(); k++)
+		if (w[k] == i) { w[k] = w.back(); w.pop_back(); break; }
+	}
+	c.owner = NULL_ID;
+	m_number_dead += c.size;
+  }
+  if (m_number_dead > number_literals()) compact();
+}
+
+
+// squeeze the removed instances out of the arena.  The watched literals are always the first two
+// so we can rebuild the watch lists from scratch.
+void GroundCache::compact()
+{
+  vector<Literal> literals;
+  vector<Instance> instances;
+  literals.reserve(number_literals());
+  for (size_t i=0; i < m_instances.size(); i++) {
+	const Instance& c = m_instances[i];
+	if (c.owner == NULL_ID) continue;
+	instances.push_back(Instance(literals.size(),c.size,c.owner));
+	literals.insert(literals.end(),m_literals.begin() + c.start,m_literals.begin() + c.start + c.size);
+  }
+  m_literals.swap(literals);
+  m_instances.swap(instances);
+  m_number_dead = 0;
+
+  for (size_t k=0; k < m_watchers.size(); k++) m_watchers[k].clear();
+  for (size_t i=0; i < m_instances.size(); i++) watch(i);
+}
+
+
+// the same two watched literal scheme as Pfs::get_implications_ground
+Result GroundCache::get_implications(Assignment& P, Literal a, vector<size_t>& hits)
+{
+  Literal f = a.negate();
+  TouchCounter touched;
+  vector<size_t>& w = m_watchers[index(f)];
+  for (size_t i=0; i < w.size(); i++) {
+	touched.clause();
+	const Instance& c = m_instances[w[i]];
+	Literal* lits = &m_literals[c.start];
+	if (lits[0] == f) swap(lits[0],lits[1]);
+	Literal& watcher = lits[1];
+	Literal& other_watcher = lits[0];
+
+	if (P.value(other_watcher.variable()) == (size_t)other_watcher.sign())  // the other watcher is sat
+	  continue;
+
+	bool found_new_watcher = false;
+	for (size_t j=2; j < c.size; j++) {  // try to replace this watcher
+	  touched.literal();
+	  if (P.watchable(lits[j])) {
+		m_watchers[index(lits[j])].push_back(w[i]);
+		swap(watcher,lits[j]);
+		w[i] = w.back();   // remove old watcher from watch list
+		w.pop_back();
+		--i;
+		found_new_watcher = true;
+		break;
+	  }
+	}
+	if (found_new_watcher) continue;
+
+	hits[c.owner]++;
+	if (!P.extend(AnnotatedLiteral(other_watcher,Reason(c.owner,lits,c.size))))
+	  return CONTRADICTION;
+  }
+  return SUCCESS;
+}
+
+} // end namespace zap
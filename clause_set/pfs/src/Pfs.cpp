@@ -1,11 +1,15 @@
+#include <atomic>
+#include <thread>
 #include "Pfs.h"
+#include "TouchCounter.h"
 
 namespace zap
 {
 
 Pfs::Pfs(const GlobalProductGroup& gpg)
    :  m_num_vars(gpg.number_variables()),
-	  m_num_clauses(0), m_end_original_clauses(0),	m_vsids_counts(gpg.number_variables()+1,0.0),
+	  m_num_clauses(0), m_end_original_clauses(0), m_ground_cache_budget(0), m_last_refresh(0),
+	  m_vsids_counts(gpg.number_variables()+1,0.0),
 	  m_score_inc(1), m_clause_score_inc(1),
 	  m_global_group(gpg)
 {
@@ -43,14 +47,35 @@ void Pfs::initialize_clause_set(const vector<PfsClause>& clauses)
 	//	operator[](i).initialize_local_search();
   }
 
+  build_universe_index();
+}
+
+
+/*  Propagating a literal l only involves the original clauses that have some ground instance
+	containing l, and that's the clauses whose universe has l in it.  We list them for every
+	literal so get_implications doesn't have to k-transport every first-order clause.  The
+	original clauses never move (reduce_knowledge_base only deletes learned clauses) so the
+	ids stay good.  */
+
+void Pfs::build_universe_index()
+{
+  m_universe_index.assign(number_variables()+1,VariableWatch());
+  for (size_t i=0; i < m_end_original_clauses; i++) {
+	if (operator[](i).size() <= 1) continue;
+	const vector<Literal>& U = operator[](i).universe();
+	for (size_t j=0; j < U.size(); j++) {
+	  if (U[j].variable() >= m_universe_index.size()) m_universe_index.resize(U[j].variable()+1);
+	  m_universe_index[U[j].variable()].watch_list[U[j].sign()].push_back(i);
+	}
+  }
 }
 
 //  This is the major computational loop of the solver.  80-90% of execution time will be spent here.
-Result Pfs::get_implications_ground(Assignment& P, Literal a)
+Result Pfs::get_implications_ground(Assignment& P, Literal a, TouchCounter& touched)
 {
   vector<Watcher>& w = m_watchers[a.variable()].watch_list[!a.sign()]; 
   for (size_t i=0; i < w.size(); i++) {
-	global_vars.clauses_touched++; 
+	touched.clause();
     PfsClause& c = operator[](w[i]);
     if (c.begin()->variable() == a.variable()) { Literal tmp = c[0]; c[0] = c[1]; c[1] = tmp; }  // swap
     Literal& watcher = c[1];
@@ -61,7 +86,7 @@ Result Pfs::get_implications_ground(Assignment& P, Literal a)
      
     bool found_new_watcher = false;
     for (size_t j = 2; j < c.size(); j++)  { // try to replace this watcher
-      global_vars.literals_touched++;
+      touched.literal();
       if (P.watchable(c[j])) {
 	m_watchers[c[j].variable()].watch_list[c[j].sign()].push_back(w[i]);  // add the new watcher to watch list
 	
@@ -81,7 +106,7 @@ Result Pfs::get_implications_ground(Assignment& P, Literal a)
 
 	c.score++;
 	++global_vars.prop_from_nogoods;
-    if (!P.extend(AnnotatedLiteral(other_watcher, Reason(w[i],operator[](w[i])))))
+    if (!P.extend(AnnotatedLiteral(other_watcher, Reason(w[i]))))
       return CONTRADICTION;
 
 	if (global_vars.up_structure_bound <= c.size()) {
@@ -154,30 +179,174 @@ void Pfs::rescale_clause_scores()
 
 
 
-void Pfs::get_ground_clauses(vector<Clause>& ground_clauses)
+/* Grounding is split into chunks, each one a range of the root's subtrees in one clause's
+   transport tree, and the chunks are handed out to as many threads as the machine has.  Each
+   chunk gets its own buffer and the buffers come back in clause order, so the ground theory
+   is the same however many threads ran.  Building the transports changes the clauses, so
+   that's done before any threads start.
+*/
+
+const size_t MIN_PARALLEL_GROUNDING      = 10000;  // fewer ground clauses than this aren't worth a thread
+const size_t GROUNDING_CHUNKS_PER_THREAD = 8;      // so a thread that finishes early can pick up more
+
+
+struct GroundingChunk {
+  size_t clause;
+  size_t first;
+  size_t last;
+  GroundingChunk(size_t c, size_t f, size_t l) : clause(c), first(f), last(l) { }
+};
+
+
+void ground_chunks(const Pfs* theory, const vector<GroundingChunk>* chunks,
+				   vector<GroundClauseBuffer>* buffers, atomic<size_t>* next_chunk)
+{
+  for (size_t c = (*next_chunk)++; c < chunks->size(); c = (*next_chunk)++) {
+	const GroundingChunk& chunk = (*chunks)[c];
+	(*theory)[chunk.clause].get_ground_clauses(chunk.first,chunk.last,(*buffers)[c]);
+  }
+}
+
+
+void Pfs::get_ground_clauses(vector<GroundClauseBuffer>& ground_clauses)
 {
   size_t number_ground_clauses = 0;
-  for (size_t i=0; i < size()-1; i++)
-	number_ground_clauses += operator[](i).number_ground_clauses();
-  ground_clauses.reserve(number_ground_clauses);
-  for (size_t i=0; i < size()-1; i++)
-	operator[](i).get_ground_clauses(ground_clauses);
+  for (size_t i=0; i < size()-1; i++) {
+	if (!operator[](i).has_transports()) operator[](i).build_transports();
+	number_ground_clauses += max(operator[](i).number_ground_clauses(),(size_t)1);
+  }
+
+  size_t number_threads = max(thread::hardware_concurrency(),1u);
+  if (number_ground_clauses < MIN_PARALLEL_GROUNDING) number_threads = 1;
+  size_t chunk_size = max(number_ground_clauses / (GROUNDING_CHUNKS_PER_THREAD*number_threads),(size_t)1);
+
+  vector<GroundingChunk> chunks;
+  for (size_t i=0; i < size()-1; i++) {
+	size_t subtrees = operator[](i).number_subtrees();
+	size_t n = max(operator[](i).number_ground_clauses(),(size_t)1);
+	size_t pieces = min(subtrees,(n + chunk_size - 1) / chunk_size);
+	for (size_t p=0; p < pieces; p++)
+	  chunks.push_back(GroundingChunk(i,subtrees * p / pieces,subtrees * (p+1) / pieces));
+  }
+
+  ground_clauses.assign(chunks.size(),GroundClauseBuffer());
+  atomic<size_t> next_chunk(0);
+  vector<thread> workers;
+  for (size_t t=1; t < min(number_threads,chunks.size()); t++)
+	workers.push_back(thread(ground_chunks,this,&chunks,&ground_clauses,&next_chunk));
+  ground_chunks(this,&chunks,&ground_clauses,&next_chunk);
+  for (size_t t=0; t < workers.size(); t++) workers[t].join();
 }
 
 
+// one TouchCounter for everything we look at propagating l, the watch trees included
 Result Pfs::get_implications(Assignment& P, Literal l)
 {
-  for (size_t i=0; i < m_end_original_clauses; i++) {  // propagate original clauses
-	if (operator[](i).size() > 1) {
-	  if (!operator[](i).k_transporter(P,l.negate())) return CONTRADICTION;
-	}
+  TouchCounter touched;
+  if (m_ground_cache_budget) return get_implications_hybrid(P,l,touched);
+
+  Literal n = l.negate();
+  if (n.variable() < m_universe_index.size()) {   // propagate the original clauses that can contain n
+	const vector<Watcher>& w = m_universe_index[n.variable()].watch_list[n.sign()];
+	for (size_t i=0; i < w.size(); i++)
+	  if (!operator[](w[i]).k_transporter(P,n,touched)) return CONTRADICTION;
   }
   
-  return get_implications_ground(P,l);
+  return get_implications_ground(P,l,touched);
 //   if (i > m_end_original_clauses) 
 // 	if (!operator[](i).k_transport_local_search(P,l.negate())) return CONTRADICTION;
 }
 
+
+
+
+//////////////////////////////////////   HYBRID MODE   //////////////////////////////////////
+/*
+  In hybrid mode (-c 4) the first-order clauses stay lifted, but the ones whose instances keep
+  coming up unit or conflicting get grounded into m_ground_cache, where propagating them is just
+  two watched literals.  We count the units and conflicts each original clause gives us in
+  m_hits and every so often, back at level 0, put the hottest clauses that fit in the budget into
+  the cache and take out the ones that have cooled off.  Halving the counts at every refresh
+  makes them a measure of recent activity.
+
+  A clause in the cache isn't k-transported so its watch tree doesn't see the literals that are
+  assigned while it's there.  The ones we backtrack over don't matter, as with any watched
+  literals, but the level 0 ones do.  So when a clause comes out of the cache we run its watch
+  tree over the level 0 literals.  P is closed and the cache had every instance, so this can't
+  find any units, it just moves the watches off the false literals.
+*/
+
+const size_t GROUND_CACHE_INTERVAL = 100;   // backtracks between refreshes
+
+
+void Pfs::use_ground_cache(size_t budget)
+{
+  m_ground_cache_budget = budget;
+  m_ground_cache.initialize(number_variables());
+  m_hits.assign(m_end_original_clauses,0);
+  m_grounded.assign(m_end_original_clauses,false);
+}
+
+
+Result Pfs::get_implications_hybrid(Assignment& P, Literal l, TouchCounter& touched)
+{
+  if (m_ground_cache.get_implications(P,l,m_hits) == CONTRADICTION) return CONTRADICTION;
+
+  Literal n = l.negate();
+  if (n.variable() < m_universe_index.size()) {
+	const vector<Watcher>& w = m_universe_index[n.variable()].watch_list[n.sign()];
+	for (size_t i=0; i < w.size(); i++) {
+	  if (m_grounded[w[i]]) continue;
+	  size_t number_units = P.unit_list_size();
+	  bool consistent = operator[](w[i]).k_transporter(P,n,touched);
+	  m_hits[w[i]] += P.unit_list_size() - number_units + (consistent ? 0 : 1);
+	  if (!consistent) return CONTRADICTION;
+	}
+  }
+
+  return get_implications_ground(P,l,touched);
+}
+
+
+void Pfs::refresh_ground_cache(Assignment& P)
+{
+  TouchCounter touched;
+  m_last_refresh = global_vars.number_backtracks;
+
+  vector<pair<size_t,ClauseID> > hot;
+  for (size_t i=0; i < m_end_original_clauses; i++)
+	if (m_hits[i] > 0 && operator[](i).size() > 1) hot.push_back(make_pair(m_hits[i],i));
+  sort(hot.rbegin(),hot.rend());
+
+  vector<bool> wanted(m_end_original_clauses,false);
+  size_t room = m_ground_cache_budget;
+  for (size_t i=0; i < hot.size(); i++) {
+	PfsClause& c = operator[](hot[i].second);
+	size_t number_literals = max(c.number_ground_clauses(),(size_t)1) * c.size();
+	if (number_literals > room) continue;
+	wanted[hot[i].second] = true;
+	room -= number_literals;
+  }
+
+  for (size_t i=0; i < m_end_original_clauses; i++) {
+	if (!m_grounded[i] || wanted[i]) continue;
+	m_ground_cache.remove(i);
+	m_grounded[i] = false;
+	for (size_t j=0; j < P.size(); j++) operator[](i).k_transporter(P,P[j].negate(),touched);
+  }
+
+  for (size_t i=0; i < m_end_original_clauses; i++) {
+	if (!wanted[i] || m_grounded[i]) continue;
+	GroundClauseBuffer instances;
+	operator[](i).get_ground_clauses(0,operator[](i).number_subtrees(),instances);
+	m_grounded[i] = m_ground_cache.add(i,instances,P);
+  }
+
+  for (size_t i=0; i < m_hits.size(); i++) m_hits[i] /= 2;
+}
+
+
+
 bool Pfs::get_symmetric_unit_lits(Assignment& P, ClauseID c_id, Literal unit_lit)
 {
   PfsClause& c = operator[](c_id);
@@ -187,7 +356,7 @@ bool Pfs::get_symmetric_unit_lits(Assignment& P, ClauseID c_id, Literal unit_lit
 //   	cout << "Clause " << Clause(c) << endl;
 	return c.get_symmetric_unit_lits(P,unit_lit);  // this could find a contradiction.  It shouldn't be void
   }
-  return P.extend(AnnotatedLiteral(unit_lit,Reason(c_id,c)));
+  return P.extend(AnnotatedLiteral(unit_lit,Reason(c_id)));
 }
 
 
@@ -200,7 +369,7 @@ bool Pfs::get_cluster(Assignment& P, ClauseID c_id, Literal unit_lit)
 //   	cout << "Clause " << Clause(c) << endl;
 	return c.get_cluster(P,unit_lit);  // this could find a contradiction.  It shouldn't be void
   }
-  return P.extend(AnnotatedLiteral(unit_lit,Reason(c_id,c)));
+  return P.extend(AnnotatedLiteral(unit_lit,Reason(c_id)));
 }
 
 
@@ -224,13 +393,13 @@ bool PfsClause::get_cluster(Assignment& P, Literal unit_lit)
 // }
 
 PfsClause::PfsClause(const Clause& c, const Ptr<ProductSubgroup>& ps) :
-  Clause(c), m_subgroup(ps), m_predicate_sym(NULL), m_root(c)
+  Clause(c), m_subgroup(ps), m_predicate_sym(NULL), m_tree(WatchTree(c))
 {
 
 }
 
 PfsClause::PfsClause(const Clause& c, const Ptr<ProductSubgroup>& pps, PredicateSym* psp)
-  : Clause(c), m_subgroup(pps), m_predicate_sym(psp), m_root(c)
+  : Clause(c), m_subgroup(pps), m_predicate_sym(psp), m_tree(WatchTree(c))
 {
 
 }
@@ -268,9 +437,14 @@ ClauseID Pfs::resolve(const Reason& r1, const Reason& r2, const Assignment& P, s
   const PfsClause& c2 = operator[](r2.id());
 
   if (pfs_first_round) pfs_first_round = false;  
+
+  // a reason without an instance was the clause itself
+  Clause instance1, instance2;
+  const Clause& i1 = r1.has_instance() ? (instance1 = r1.clause_instance()) : clause(r1.id());
+  const Clause& i2 = r2.has_instance() ? (instance2 = r2.clause_instance()) : clause(r2.id());
 	
 //   // resolve the instances
-  Clause c = boolean_resolve(r1.clause_instance(),r2.clause_instance());
+  Clause c = boolean_resolve(i1,i2);
   add_to_analysis(c,P);
   
   lits_this_level = 0;   // calculate lits_this_level and unit_lit
@@ -292,7 +466,7 @@ ClauseID Pfs::resolve(const Reason& r1, const Reason& r2, const Assignment& P, s
   if (global_vars.use_structure) {
 	if (c1.group_ptr() == c2.group_ptr()) g = c1.group_ptr();
 	else {
-	  g = c1.group().intersection(c2.group(),r1.clause_instance(),r2.clause_instance());
+	  g = c1.group().intersection(c2.group(),i1,i2);
 	}
   }
 //   cout  << "resolvent " << c << " and group " << g << endl << endl;
@@ -356,8 +530,7 @@ Result Pfs::load_unit_literals(Assignment& P)
   for (size_t i=0; i < size() && operator[](i).size() <= 1; i++) {
 	vector<Literal> unit_lits = operator[](i).universe();
 	for (size_t j=0; j < unit_lits.size(); j++) {
-	  Clause instance(vector<Literal>(1,unit_lits[j]));
-	  if (!P.extend(AnnotatedLiteral(unit_lits[j],Reason(i,instance))))
+	  if (!P.extend(AnnotatedLiteral(unit_lits[j],Reason(i,&unit_lits[j],1))))
 		return CONTRADICTION;
 	}
   }
@@ -423,6 +596,10 @@ void Pfs::remove_irrelevant_clauses(const Assignment& P)
 
 void Pfs::reduce_knowledge_base(Assignment& P)
 {
+  if (m_ground_cache_budget && P.current_level() == 0 &&
+	  global_vars.number_backtracks >= m_last_refresh + GROUND_CACHE_INTERVAL)
+	refresh_ground_cache(P);
+
   size_t old_clauseset_size = size();
   bool pointers_need_update = false;
   
@@ -479,7 +656,7 @@ bool Pfs::valid(const Assignment& P) const { return true; }
 bool Pfs::closed(const Assignment& P) const { return true; }
 bool Pfs::decision_minimal(const Assignment& P) const { return true; }
 
-bool PfsClause::k_transporter(Assignment& P, Literal l)
+bool PfsClause::k_transporter(Assignment& P, Literal l, TouchCounter& touched)
 {
   if (global_vars.test_local_search_up) {
 // 	cout << "local search testing " << endl;
@@ -490,8 +667,10 @@ bool PfsClause::k_transporter(Assignment& P, Literal l)
 // 	cout << "Literal: " << l << endl;
 	Assignment P_copy = P;
 	size_t initial_size = P.unit_list_size();
+	touched.flush();
 	long long unsigned touches_before = global_vars.clauses_touched;
-	bool watch_tree_result = k_transport_watch_tree(P,l);
+	bool watch_tree_result = k_transport_watch_tree(P,l,touched);
+	touched.flush();
 	long long unsigned watch_tree_touches = global_vars.clauses_touched - touches_before;
 	bool local_search_result = k_transport_local_search(P_copy,l);
 	size_t ups_watch_tree = P.unit_list_size() - initial_size;
@@ -511,7 +690,7 @@ bool PfsClause::k_transporter(Assignment& P, Literal l)
 // 	}
 	return watch_tree_result;
   }
-  else return k_transport_watch_tree(P,l);
+  else return k_transport_watch_tree(P,l,touched);
 }
 
 bool PfsClause::k_transport_local_search(Assignment& P, Literal l)
@@ -519,27 +698,29 @@ bool PfsClause::k_transport_local_search(Assignment& P, Literal l)
   return m_local_search.k_transporter(P,l,id);
 }
 
-bool PfsClause::k_transport_watch_tree(Assignment& P, Literal l)
+bool PfsClause::k_transport_watch_tree(Assignment& P, Literal l, TouchCounter& touched)
 {
   if (l.variable() >= m_watch_index.size()) return true; // the clause doesn't have this literal
-  map<size_t,WatchNode*>& watchers = m_watch_index.get_index(l);
-  map<size_t,WatchNode*>::iterator it = watchers.begin();
+  WatchSet& watch_set = m_watch_index.get_index(l);
+  watch_set.settle();
+  const vector<WatchSet::Watch>& watchers = watch_set.watches();
+  size_t it = 0;
   vector<BackWatcher> to_remove;
   int new_watcher = -1;
-  while (it != watchers.end()) {
-	pair<size_t,bool> result = it->second->check(P,to_remove,new_watcher,id,m_watch_index);
+  while (it < watchers.size()) {
+	pair<size_t,bool> result = m_tree->check(watchers[it].second,P,to_remove,new_watcher,id,m_watch_index,touched);
 	if (!result.second) {
 	  for (size_t i=0; i < to_remove.size(); i++)
 		m_watch_index.remove_watch(to_remove[i]);
 	  return false; // contradiction
 	}
 	size_t skip = result.first;
-	if ((skip > 0) && (new_watcher < 0)) it = watchers.upper_bound(skip);
+	if ((skip > 0) && (new_watcher < 0)) it = watch_set.upper_bound(skip);
 	else { // either skip is 0 or new_watcher >= 0
 	  if (skip > 0) {
 		++it;
-		while (it != watchers.end() && it->first <= skip) {
-		  pair<size_t,bool> dummy = it->second->check(P,to_remove,new_watcher,id,m_watch_index);
+		while (it < watchers.size() && watchers[it].first <= skip) {
+		  pair<size_t,bool> dummy = m_tree->check(watchers[it].second,P,to_remove,new_watcher,id,m_watch_index,touched);
 		  if (!dummy.second) {
 			for (size_t i=0; i < to_remove.size(); i++)
 			  m_watch_index.remove_watch(to_remove[i]);
@@ -547,7 +728,7 @@ bool PfsClause::k_transport_watch_tree(Assignment& P, Literal l)
 		  }
 		  ++it;
 		}
-		if (it == watchers.end()) break;
+		if (it == watchers.size()) break;
 		new_watcher = -1;
 	  }
 	  else {
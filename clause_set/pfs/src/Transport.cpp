@@ -1,5 +1,6 @@
 #include "Transport.h"
 #include "Set.h"
+#include "TouchCounter.h"
 
 namespace zap
 {
@@ -223,103 +224,139 @@ vector<Literal> PfsTransportVector::orbit(const vector<Literal>& c, size_t depth
 }
 
 
-size_t WatchNode::m_next_id = 1;
+void WatchTree::build(const PfsTransportVector& transports, WatchIndex& watch_index)
+{
+  WatchNode& root = m_nodes[0];
+  vector<Literal>& clause = root.m_clause;
+  vector<size_t> depth_fixed(clause.size(),transports.size()+1);
+  for (size_t i=0; i < clause.size(); i++)
+	depth_fixed[i] = transports.depth_fixed(clause[i]);
+
+  // now sort based on depth fixed
+  for (size_t i=0; i < clause.size()-1; i++) {
+	size_t min_i = i;
+	for (size_t j=i+1; j < clause.size(); j++) 
+	  if (depth_fixed[j] < depth_fixed[min_i]) min_i = j;
+
+	// swap
+	size_t fixed_temp = depth_fixed[i];
+	Literal temp = clause[i];
+	depth_fixed[i] = depth_fixed[min_i];
+	clause[i] = clause[min_i];
+	depth_fixed[min_i] = fixed_temp;
+	clause[min_i] = temp;
+  }
 
-void WatchNode::build(const PfsTransportVector& transports, WatchIndex& watch_index)
+  build(0,transports,watch_index);
+
+  // only the leaves need their clauses
+  for (size_t n=0; n < m_nodes.size(); n++)
+	if (m_nodes[n].m_number_children) vector<Literal>().swap(m_nodes[n].m_clause);
+}
+
+
+// Every child is made from its earlier sibling, so we make all the children of n (which puts
+// them next to each other in the pool) before we build any of their subtrees.  m_nodes can
+// grow while we do this so we hang on to indexes, never references.
+void WatchTree::build(size_t n, const PfsTransportVector& transports, WatchIndex& watch_index)
 {
-  if (m_depth == 0) {  // root node
-
-    vector<size_t> depth_fixed(m_clause.size(),transports.size()+1);
-    for (size_t i=0; i < m_clause.size(); i++)
-      depth_fixed[i] = transports.depth_fixed(m_clause[i]);
-
-    // now sort based on depth fixed
-    for (size_t i=0; i < m_clause.size()-1; i++) {
-      size_t min_i = i;
-      for (size_t j=i+1; j < m_clause.size(); j++) 
-	if (depth_fixed[j] < depth_fixed[min_i]) min_i = j;
-
-      // swap
-      size_t fixed_temp = depth_fixed[i];
-      Literal temp = m_clause[i];
-      depth_fixed[i] = depth_fixed[min_i];
-      m_clause[i] = m_clause[min_i];
-      depth_fixed[min_i] = fixed_temp;
-      m_clause[min_i] = temp;
-    }
+  {
+	WatchNode& node = m_nodes[n];
+	for (size_t i=0; i < node.m_clause.size(); i++) 
+	  if (!node.m_fixed[i]) node.m_fixed[i] = transports.fixes(node.m_clause[i],node.m_depth);
+	
+	if (node.m_depth >= transports.size()-1) {
+	  for (size_t i=0; i < node.m_clause.size() && i < 2; i++) {
+		watch_index.add_watch(node.m_clause[i],n,node.m_level_id);
+		node.m_back_watchers.push_back(BackWatcher(node.m_clause[i],node.m_level_id,i));
+	  }
+	  return;
+	}
   }
-  
-  for (size_t i=0; i < m_clause.size(); i++) 
-    if (!m_fixed[i]) m_fixed[i] = transports.fixes(m_clause[i],m_depth);
 
-//   cout << " building " << *this << endl;
-  
-  if (m_depth >= transports.size()-1) {
-    for (size_t i=0; i < m_clause.size() && i < 2; i++) {
-// 	  cout << "adding watcher " << endl << m_clause[i] << endl << *this << endl << m_level_id << endl;
-      watch_index.add_watch(m_clause[i],this,m_level_id);
-      m_back_watchers.push_back(BackWatcher(m_clause[i],m_level_id,i));
-    }
-    return;
+  size_t depth = m_nodes[n].m_depth;
+  PfsCounter counter = transports[depth+1].initial_counter();
+  m_nodes[n].m_first_child = expand(n,transports);
+  m_nodes[n].m_number_children = 1;
+  while (next_child(counter,transports)) m_nodes[n].m_number_children++;
+
+  size_t first = m_nodes[n].m_first_child;
+  size_t last = first + m_nodes[n].m_number_children;
+  for (size_t c=first; c < last; c++) build(c,transports,watch_index);
+}
+
+
+/* Ground the subtrees first up to last of the root.  The counters only tell us how to move the
+   image from one column choice to the next, so each depth keeps its own copy of the clause in
+   images and updates it in place as the counter goes.  We have to walk the counter through the
+   subtrees before first to get the image right.
+*/
+void PfsTransportVector::cnf(const vector<Literal>& clause, size_t first, size_t last, GroundClauseBuffer& out) const
+{
+  if (size() <= 1) {  // no transports, the clause is its own ground instance
+	if (first == 0 && last > 0) out.add(clause);
+	return;
+  }
+
+  vector<vector<Literal> > images(size(),clause);
+  PfsCounter counter = operator[](1).initial_counter();
+  for (size_t n=0; n < last; n++) {
+	for (size_t i=0; i < clause.size(); i++)
+	  images[1][i] = operator[](1).action().image(images[1][i],counter);
+	if (n >= first) cnf(1,images,out);
+	if (!counter.next()) return;
   }
-  
-  PfsCounter counter = transports[m_depth+1].initial_counter();
-  m_children.push_back(expand(transports));
-  do {
-    m_children.back()->build(transports,watch_index);
-  } while (next_child(counter,transports[m_depth+1]));
-  
-  return;
-  
 }
 
-void PfsTransportVector::cnf(size_t depth, vector<Literal> clause, vector<Clause>& clauses) const
+
+void PfsTransportVector::cnf(size_t depth, vector<vector<Literal> >& images, GroundClauseBuffer& out) const
 {
   if (depth == size()-1) {  // leaf node. get the clause
-	clauses.push_back(Clause(clause));
+	out.add(images[depth]);
 	return;
   }
 
+  vector<Literal>& image = images[depth+1];
+  image = images[depth];
   PfsCounter counter = operator[](depth+1).initial_counter();
   do {
-	for (size_t i=0; i < clause.size(); i++)
-	  clause[i] = operator[](depth+1).action().image(clause[i],counter);
-	cnf(depth+1,clause,clauses);
+	for (size_t i=0; i < image.size(); i++)
+	  image[i] = operator[](depth+1).action().image(image[i],counter);
+	cnf(depth+1,images,out);
   } while (counter.next());
 }
 
 
-void WatchNode::build_right_leaf()
+void WatchTree::build_right_leaf()
 {
-  m_right_leaf = right_most_leaf();
-  
-  if (m_children.empty()) return;
-  
-  for (size_t i=0; i < m_children.size(); i++)
-    m_children[i]->build_right_leaf();
-  return;
-  
+  for (size_t n=0; n < m_nodes.size(); n++)
+	m_nodes[n].m_right_leaf = right_most_leaf(n);
 }
 
 
 
 
-size_t WatchNode::get_skip(size_t index) const
+size_t WatchTree::get_skip(size_t n, size_t index) const
 {
   size_t skip = 0;
-  const WatchNode* node = m_parent;
-  while (node && node->m_fixed[index]) {
-    skip = node->m_right_leaf;
-    node = node->m_parent;
+  size_t p = m_nodes[n].m_parent;
+  while (p != NO_NODE && m_nodes[p].m_fixed[index]) {
+    skip = m_nodes[p].m_right_leaf;
+    p = m_nodes[p].m_parent;
   }
   return skip;
 }
 
 //#ifdef SUBSEARCH
 
-pair<size_t,bool> WatchNode::check(Assignment& PA,vector<BackWatcher>& to_remove,int& new_watcher,ClauseID id, WatchIndex& watch_index)
+// touched belongs to the Pfs::get_implications call we're part of, a tree checks a lot of nodes
+pair<size_t,bool> WatchTree::check(size_t n, Assignment& PA,vector<BackWatcher>& to_remove,int& new_watcher,ClauseID id, WatchIndex& watch_index,
+								   TouchCounter& touched)
 {
-  global_vars.clauses_touched++;
+  WatchNode& node = m_nodes[n];
+  const vector<Literal>& m_clause = node.m_clause;
+  vector<BackWatcher>& m_back_watchers = node.m_back_watchers;
+  touched.clause();
 //    cout << "checking " << m_clause  << " with old watchers ";
 //    cout <<  m_clause[m_back_watchers[0].local_index] << "  and  "
 //         << m_clause[m_back_watchers[1].local_index] << endl;
@@ -328,8 +365,8 @@ pair<size_t,bool> WatchNode::check(Assignment& PA,vector<BackWatcher>& to_remove
   for (size_t i=0; i < m_back_watchers.size(); i++) {
 	Literal l = m_clause[m_back_watchers[i].local_index];
     size_t value = PA.value(l.variable());
-    global_vars.literals_touched++;
-    if (value == l.sign()) return make_pair(get_skip(m_back_watchers[i].local_index),true);
+    touched.literal();
+    if (value == l.sign()) return make_pair(get_skip(n,m_back_watchers[i].local_index),true);
     if (value == UNKNOWN) unval = i;
     else {
 	  if (PA.decision_level(l.variable()) == NULL_ID) deepest = i;
@@ -346,7 +383,7 @@ pair<size_t,bool> WatchNode::check(Assignment& PA,vector<BackWatcher>& to_remove
     // there had better be a sat lit in this clause
     for (size_t i=0; i < m_clause.size(); i++) {
       size_t value = PA.value(m_clause[i].variable());
-      if (value == m_clause[i].sign()) return make_pair(get_skip(i),true);
+      if (value == m_clause[i].sign()) return make_pair(get_skip(n,i),true);
     }
 	cout << "unsat clause " << endl;
 	exit(1);
@@ -367,8 +404,8 @@ pair<size_t,bool> WatchNode::check(Assignment& PA,vector<BackWatcher>& to_remove
     m_back_watchers[unsat] = m_back_watchers.back();
     m_back_watchers.pop_back();
     
-    watch_index.add_watch(m_clause[new_watcher],this,m_level_id);  // add the new watcher
-    m_back_watchers.push_back(BackWatcher(m_clause[new_watcher],m_level_id,new_watcher));
+    watch_index.add_watch(m_clause[new_watcher],n,node.m_level_id);  // add the new watcher
+    m_back_watchers.push_back(BackWatcher(m_clause[new_watcher],node.m_level_id,new_watcher));
     return  make_pair(0,true);
   }
 
@@ -381,19 +418,19 @@ pair<size_t,bool> WatchNode::check(Assignment& PA,vector<BackWatcher>& to_remove
     size_t value = PA.value(m_clause[i].variable());
 //  	cout << "value " << value  << " lit " << m_clause[i] << ":" << m_clause[i].sign() << endl;
 	//    global_vars.literals_touched++;
-    if (value == m_clause[i].sign()) return make_pair(get_skip(i),true);
+    if (value == m_clause[i].sign()) return make_pair(get_skip(n,i),true);
     if (value == UNKNOWN) {                         // found a new watcher
 // 	  cout << "remove watcher 1 " << m_back_watchers[unsat] << endl;
 // 	  cout << m_back_watchers.size() << "\t" << unsat << endl;
       to_remove.push_back(m_back_watchers[unsat]);  // remove old watcher
       m_back_watchers[unsat] = m_back_watchers.back();
       m_back_watchers.pop_back();
-      watch_index.add_watch(m_clause[i],this,m_level_id);  // add the new watcher
-      m_back_watchers.push_back(BackWatcher(m_clause[i],m_level_id,i));
+      watch_index.add_watch(m_clause[i],n,node.m_level_id);  // add the new watcher
+      m_back_watchers.push_back(BackWatcher(m_clause[i],node.m_level_id,i));
 
       if (new_watcher >= 0) return make_pair(0,true);
       new_watcher = i;
-      return make_pair(get_skip(i),true);
+      return make_pair(get_skip(n,i),true);
     }
   }
 
@@ -458,24 +495,45 @@ pair<size_t,bool> WatchNode::check(Assignment& PA,vector<BackWatcher>& to_remove
 
 
 
-WatchNode* WatchNode::expand(const PfsTransportVector& transports)
+size_t WatchTree::expand(size_t n, const PfsTransportVector& transports)
 {
-  WatchNode* node = new WatchNode(*this);
-  node->m_parent = this;
-  node->m_depth++;
-  node->m_child = 0;
-  node->m_level_id = m_level_id * transports[node->m_depth].number_of_images();
-  
-  return node;
+  WatchNode node(m_nodes[n].m_clause);
+  node.m_fixed = m_nodes[n].m_fixed;
+  node.m_parent = n;
+  node.m_depth = m_nodes[n].m_depth + 1;
+  node.m_level_id = m_nodes[n].m_level_id * transports[node.m_depth].number_of_images();
+  m_nodes.push_back(node);
+  return m_nodes.size()-1;
 }
 
-size_t WatchNode::right_most_leaf() const
+
+// the next child is a copy of the last one (always at the end of the pool) moved by the next
+// image of the transport.  Its m_fixed starts out where the earlier sibling's ended up.
+bool WatchTree::next_child(PfsCounter& counter, const PfsTransportVector& transports)
 {
-  size_t answer = m_level_id;
-  const WatchNode* node = this;
-  while (node->m_children.size()) {
-    answer = answer * node->m_children.size() + (node->m_children.size() - 1);
-    node = node->m_children[0];
+  if (!counter.next()) return false;
+  WatchNode& sibling = m_nodes.back();
+  for (size_t i=0; i < sibling.m_clause.size(); i++) 
+	if (!sibling.m_fixed[i]) sibling.m_fixed[i] = transports.fixes(sibling.m_clause[i],sibling.m_depth);
+
+  WatchNode node = sibling;
+  const PfsTransport& transport = transports[node.m_depth];
+  node.m_child++;
+  node.m_level_id++;
+  for (size_t i=0; i < node.m_clause.size(); i++) 
+    node.m_clause[i] = transport.action().image(node.m_clause[i],counter);
+  m_nodes.push_back(node);
+  return true;
+}
+
+
+size_t WatchTree::right_most_leaf(size_t n) const
+{
+  size_t answer = m_nodes[n].m_level_id;
+  const WatchNode* node = &m_nodes[n];
+  while (node->m_number_children) {
+    answer = answer * node->m_number_children + (node->m_number_children - 1);
+    node = &m_nodes[node->m_first_child];
   }
 
   return answer;
@@ -483,4 +541,48 @@ size_t WatchNode::right_most_leaf() const
 
 
 
+// removing a watch that was added since the last settle just takes it off the list of new ones
+bool WatchSet::remove(size_t id)
+{
+  bool found = false;
+  for (size_t i=0; i < m_added.size(); i++) {
+	if (m_added[i].first != id) continue;
+	m_added[i--] = m_added.back();
+	m_added.pop_back();
+	found = true;
+  }
+  vector<Watch>::iterator it = std::lower_bound(m_watches.begin(),m_watches.end(),Watch(id,0));
+  if (it != m_watches.end() && it->first == id && it->second != NO_NODE) {
+	it->second = NO_NODE;
+	m_removed++;
+	found = true;
+  }
+  return found;
+}
+
+
+void WatchSet::settle()
+{
+  if (m_added.empty() && m_removed == 0) return;
+
+  if (m_removed) {
+	size_t j = 0;
+	for (size_t i=0; i < m_watches.size(); i++)
+	  if (m_watches[i].second != NO_NODE) m_watches[j++] = m_watches[i];
+	m_watches.resize(j);
+	m_removed = 0;
+  }
+  
+  if (m_added.size()) {
+	size_t middle = m_watches.size();
+	sort(m_added.begin(),m_added.end());
+	m_watches.insert(m_watches.end(),m_added.begin(),m_added.end());
+	inplace_merge(m_watches.begin(),m_watches.begin()+middle,m_watches.end());
+	m_watches.erase(unique(m_watches.begin(),m_watches.end()),m_watches.end());  // a leaf watches a literal once
+	m_added.clear();
+  }
+}
+
+
+
 } // end namespace zap
@@ -33,12 +33,36 @@ ClauseSetBuilder::ClauseSetBuilder(const InputTheory& input) : m_input(input), m
 }
 
 
+// the Pfs grounds into flat buffers so it never has to know about Cnfs, and we copy them
+// straight into the Cnf arena
 ClauseSet* PfsConverter::convert_to_cnf()
 {
-  vector<Clause> ground_clauses;
+  vector<GroundClauseBuffer> ground_clauses;
   m_theory.get_ground_clauses(ground_clauses);
-  m_cnf_conversion = Cnf(ground_clauses);  // this is ugly and inefficient but keeps the Pfs class clean of Cnfs
-  return &m_cnf_conversion;                // maybe I can fix this at lesat partially with a copy constructor
+
+  size_t number_clauses = 0, number_lits = 0;
+  for (size_t i=0; i < ground_clauses.size(); i++) {
+	number_clauses += ground_clauses[i].sizes.size();
+	number_lits += ground_clauses[i].literals.size();
+  }
+
+  m_cnf_conversion.begin_input(number_clauses,number_lits);
+  for (size_t i=0; i < ground_clauses.size(); i++) {
+	const GroundClauseBuffer& buffer = ground_clauses[i];
+	const Literal* c = buffer.literals.data();
+	for (size_t j=0; j < buffer.sizes.size(); c += buffer.sizes[j++])
+	  m_cnf_conversion.append_input_clause(c,buffer.sizes[j]);
+	vector<Literal>().swap(ground_clauses[i].literals);  // don't hold two copies of the theory
+  }
+  m_cnf_conversion.finish_input();
+  return &m_cnf_conversion;
+}
+
+// the first-order clauses stay lifted and the hot ones get grounded as we go, see Pfs.cpp
+ClauseSet* PfsConverter::convert_to_hybrid()
+{
+  m_theory.use_ground_cache(global_vars.ground_cache_budget);
+  return &m_theory;
 }
 
 ClauseSet* PfsConverter::convert_to_symres()
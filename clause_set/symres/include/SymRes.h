@@ -13,11 +13,11 @@ using namespace std;
 namespace zap
 {
 
-class BackupClause : public CnfClause 
+class BackupClause : public Clause 
 {
  public:
    size_t assertion_level;
- BackupClause(const CnfClause& c) : CnfClause(c), assertion_level(-1) { }
+ BackupClause(const Clause& c) : Clause(c), assertion_level(-1) { }
 };
 
    inline bool operator<(const BackupClause& bc1, const BackupClause& bc2) {
@@ -44,7 +44,7 @@ class SymRes : public Cnf
   
 public:
 
- SymRes() : m_num_asserting_clauses(0) { }
+ SymRes() : m_num_asserting_clauses(0) { m_minimize = false; }
    SymRes(const GlobalProductGroup& gpg);
    GlobalProductGroup& global_group() {  return m_global_group; }
    void set_global_groups(const map<string,Ptr<ProductSubgroup> >& g) { m_global_groups = g; }
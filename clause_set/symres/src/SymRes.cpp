@@ -7,7 +7,7 @@ namespace zap
 SymRes::SymRes(const GlobalProductGroup& gpg)
   :  m_global_group(gpg), m_num_asserting_clauses(0)
 {
-
+  m_minimize = false;   // minimizing would mix in reasons from other groups
 }
 
 void SymRes::initialize_clause_set(vector<PfsClause>& clauses)
@@ -30,7 +30,7 @@ ClauseID SymRes::resolve(const Reason& r1, const Reason& r2, const Assignment& P
 {
   //  cout << "clause id " << r1.id() << " , " << r2.id() << "   size " << size() << endl;
   if (r1.id() == NULL_ID) {
-    CnfClause& c = operator[](r2.id());
+    const CnfClause c = operator[](r2.id());
     // for (size_t i=0; i < c.size(); i++) {
     //   cout << c[i] << ":" << P.value(c[i].variable()) << ":" << P.decision_level(c[i].variable()) << ' ';
     // }
@@ -41,8 +41,8 @@ ClauseID SymRes::resolve(const Reason& r1, const Reason& r2, const Assignment& P
    if (r1.id() == NULL_ID) return r2.id();
    if (r2.id() == NULL_ID) return r1.id();
 
-   CnfClause& c1 = operator[](r1.id());
-   CnfClause& c2 = operator[](r2.id());
+   const string& group1 = group_name(r1.id());
+   const string& group2 = group_name(r2.id());
    // cout << "clause id " << r1.id() << " , " << r2.id() << "   size " << size() << endl;
    // cout << "resolving " << endl << c1 << endl << c2 << endl;
    // cout << "id 1 " << c1.group_identifier << endl;
@@ -63,16 +63,10 @@ ClauseID SymRes::resolve(const Reason& r1, const Reason& r2, const Assignment& P
    // for (size_t i=0; i < resolve_clause.size(); i++) {
    //   cout << resolve_clause[i] << ":" << P.value(resolve_clause[i].variable()) << ":" << P.current_level() - P.decision_level(resolve_clause[i].variable()) << " ";
    // }
-   for (size_t i=0; i < resolve_clause.size(); i++) 
-     if (P.value(resolve_clause[i].variable()) == resolve_clause[i].sign()) {
-       cout << "sat resolvent" << endl;
-       exit(1);
-     }
-
    //   cout << endl << endl;;
    // cout << "back in resolve " << back() << endl;
-   if (c1.group_identifier == c2.group_identifier)
-      operator[](id).group_identifier = c1.group_identifier;
+   if (group1 == group2)
+      m_learned_clause.group_identifier = group1;
    return id;
 }
 
@@ -119,19 +113,18 @@ void SymRes::add_learned_clause(ClauseID c_id, const Assignment& P)
 {
   m_num_asserting_clauses = 1;
   // cout << P << endl << operator[](c_id) << endl;
-   if (operator[](c_id).size() > global_vars.symres_bound || operator[](c_id).group_identifier == "") {
+   if (operator[](c_id).size() > global_vars.symres_bound || group_name(c_id) == "") {
       Cnf::add_learned_clause(c_id,P);
       return;
    }
    first_round = true;
-   seen.clear();
    
    // cout << "adding learned clause with symmetry " << operator[](c_id) << endl;
 
-   if (c_id != (int)(size()-1)) return;
+   if (c_id != learned_clause_id()) return;
 
-   CnfClause c = operator[](c_id);
-   pop_back(); 
+   Clause c = m_learned_clause;
+   m_learned_clause = Clause(); 
    PfsClause pfsClause(c,lookup_group(c.group_identifier)); 
    pfsClause.build_transports();
    vector<Clause> ground_clauses;
@@ -181,21 +174,16 @@ void SymRes::add_learned_clause(ClauseID c_id, const Assignment& P)
    
    m_num_asserting_clauses = 0;
    size_t base_assertion_level = backups[0].assertion_level;
+   size_t group = intern_group(c.group_identifier);
    for (size_t i=0; i < backups.size(); i++) {
-      push_back(backups[i]);
-      back().group_identifier = c.group_identifier;
-      back().id = size()-1;
-      increment_clause_score(size()-1);
+      ClauseID id = append_clause(backups[i],group);
+      increment_clause_score(id);
       
-      if (c.size() > 1) {
-         for (size_t j=0; j < 2; j++) // now we can watch the first two literals of each clause
-            m_watchers[back()[j].variable()].watch_list[back()[j].sign()].push_back(size()-1);
-      }
+      if (c.size() > 1) watch_clause(id); // now we can watch the first two literals of each clause
       if (backups[i].assertion_level == base_assertion_level) m_num_asserting_clauses++;
    }
    //   cout << "number unit clauses " << m_num_asserting_clauses << endl;
    m_clause_score_inc *= CLAUSE_SCORE_INC_FACTOR;
-   push_back(CnfClause());
    
    // cout << "num asserting clauses " << m_num_asserting_clauses << endl;
   
@@ -209,8 +197,8 @@ bool SymRes::get_symmetric_unit_lits(Assignment& P, ClauseID c_id, Literal unit_
   //  cout << "number unit clauses " << m_num_asserting_clauses << endl;
   //  cout << "getting symmetric lits " << endl << P << endl;
    // cout << "primary clause " << operator[](c_id) << endl;
-  for (size_t i=c_id; (i < c_id + m_num_asserting_clauses) && (i < size()-1); i++) { // walk through all the learned clauses
-      CnfClause& c = operator[](i);
+  for (size_t i=c_id; (i < c_id + m_num_asserting_clauses) && (i < number_clauses()); i++) { // walk through all the learned clauses
+      const CnfClause c = operator[](i);
       //if (c_id != i) cout << "additional sym lit " << c[0] << endl;
       //      cout << i << " extending " << c[0] << " with reason " << i << " instance " << operator[](i) << endl;
       if (!P.extend(AnnotatedLiteral(c[0],i))) {
@@ -19,27 +19,35 @@ const int PURE          = -2 ;
 ////////////////////////////////////   REASON   ////////////////////////////////////////////
 
 
-/* A reason is an annotation for a variable assignment.  It's a clauseID
-   (an index into a ClauseSet). We'll need to add a data field to store either a ground clause
-   or a permutation. This is used when working with Augmented Clauses to generate the ground clause that
-   caused a variable assignment when it is not the representative clause of the AugmentedClause m_id.
-   I'm not sure how I'm going to implement it yet.
-   If the ClauseID is the NULL_ID (-1) that indicates a branch assignment.  */
+/* A reason is an annotation for a variable assignment.  It's a clauseID (an index into a ClauseSet).
+   If the ClauseID is the NULL_ID (-1) that indicates a branch assignment.
+
+   Clause sets with symmetry (PFS) can make a literal unit with a ground instance of a clause that
+   isn't the representative clause m_id.  Those reasons also carry the literals of the instance.  A
+   Reason doesn't own them, it just points at them.  When we extend an Assignment, the Assignment
+   copies the instance into its own storage, and the Reasons it hands back from get_reason point
+   there, so they're only good until the Assignment is changed.  Most reasons don't have an
+   instance and are just a ClauseID.  */
 
 class Reason
 {
-  ClauseID	    m_id;
-  Clause        m_clause_instance;
+  ClauseID	      m_id;
+  const Literal*  m_instance;
+  size_t          m_instance_size;
 public:
-  Reason(ClauseID id = NULL_ID) : m_id(id)  { }
-  Reason(ClauseID id, const Clause& c) : m_id(id), m_clause_instance(c) { }
+  Reason(ClauseID id = NULL_ID) : m_id(id), m_instance(NULL), m_instance_size(0) { }
+  Reason(ClauseID id, const vector<Literal>& c) : m_id(id), m_instance(c.data()), m_instance_size(c.size()) { }
+  Reason(ClauseID id, const Literal* lits, size_t size) : m_id(id), m_instance(lits), m_instance_size(size) { }
   
   bool is_branch()   const { return m_id == NULL_ID; }
   bool is_pure()     const { return m_id == PURE; }
   bool good_reason() const { return m_id >= 0; }
   ClauseID      id() const    { return m_id; }
   ClauseID &    id()        { return m_id; }
-  const Clause& clause_instance() const { return m_clause_instance; }
+  bool          has_instance()  const { return m_instance != NULL; }
+  const Literal* instance()     const { return m_instance; }
+  size_t        instance_size() const { return m_instance_size; }
+  Clause        clause_instance() const { return Clause(vector<Literal>(m_instance,m_instance + m_instance_size)); }
   
   friend ostream& operator << (ostream& os, const Reason& r);
 };
@@ -65,11 +73,16 @@ public:
 /* A possibly partial assignment of values to Boolean variables.  When we assign values to variables,
    we have to seperate assignments whose unit consequences have  been computed (stored in m_stack)
    from those whose unit consequences still need to be checked (stored in m_unit_list).
-   Data members m_level, m_value and m_reason are all indexed by variable so provide
-   constant time access.  Assignment won't allow you to add both positive and negated versions of
-   a literal.  If you do, the contradiction variable is recorded in the m_contradiction data member
-   and we keep the reasons for both assignments in m_reason.  
-   
+   Data members m_level, m_value, m_position and m_reason are all indexed by variable so provide
+   constant time access.  They're kept as separate flat arrays so extending the assignment never
+   allocates.  Assignment won't allow you to add both positive and negated versions of
+   a literal.  If you do, the contradiction variable is recorded in the m_contradiction data member,
+   its reason stays in m_reason and the reason for the other value goes in m_contradiction_reason.
+
+   Ground instances that come with reasons are copied to the end of m_instance_lits and
+   m_instance[v] is where variable v's instance starts (NULL_ID if it doesn't have one).  Every
+   assignment made after a branch is undone before the branch is, so the instances are freed from
+   the end like a stack and the space gets reused.
  */
 
 class Assignment
@@ -81,12 +94,22 @@ class Assignment
   
   // these are all indexed by variable. 
   vector<int>             m_level;    
-  vector<size_t>          m_value;
+  vector<unsigned char>   m_value;
   vector<int>             m_position; // in the stack
-  vector<vector<Reason> > m_reason;
+  vector<ClauseID>        m_reason;
+  vector<int>             m_instance;       // start of the reason's ground instance in m_instance_lits
+  vector<unsigned>        m_instance_size;
+  
+  ClauseID                m_contradiction_reason;   // for the value of m_contradiction we couldn't set
+  int                     m_contradiction_instance;
+  unsigned                m_contradiction_instance_size;
+  vector<Literal>         m_instance_lits;
   const vector<double>*   m_vsids_counts;
   
-  void resize(size_t sz);
+  void    resize(size_t sz);
+  int     store_instance(const Reason& r);
+  Reason  stored_reason(ClauseID id, int instance, unsigned size) const;
+  void    forget_reason(Variable v, size_t& instances_top);
   
 public:
   Assignment();
@@ -108,7 +131,7 @@ public:
   bool           has_contradiction() const;
 
   // ways of selecting unvalued variables for branching 
-  Literal    random_unvalued_literal() const;
+  Literal    random_unvalued_literal(unsigned* seed = NULL) const;  // rand_r(seed) if we have one
   Literal    first_unvalued_literal() const;
   Literal    vsids_literal() const;
   Literal    user_input_literal() const;
@@ -158,11 +181,20 @@ inline ostream& operator<<(ostream& os, const AnnotatedLiteral& a) {
 
 
 
-inline Assignment::Assignment() : m_current_level(0), m_contradiction(0), m_vsids_counts(NULL) { }
+inline Assignment::Assignment() :
+  m_current_level(0),
+  m_contradiction(0),
+  m_contradiction_reason(NULL_ID),
+  m_contradiction_instance(NULL_ID),
+  m_contradiction_instance_size(0),
+  m_vsids_counts(NULL) { }
 inline Assignment::Assignment(size_t nv, const vector<double>* vc) :
   m_unit_list(nv,vc),
   m_current_level(0),
   m_contradiction(0),
+  m_contradiction_reason(NULL_ID),
+  m_contradiction_instance(NULL_ID),
+  m_contradiction_instance_size(0),
   m_vsids_counts(vc) { resize(nv); }
 
 
@@ -203,7 +235,28 @@ inline int Assignment::decision_level(Variable v) const
   return m_level[v];
 }
 
-inline const Reason Assignment::get_reason(Literal l) const { return m_reason[l.variable()][l.sign()]; }
+inline Reason Assignment::stored_reason(ClauseID id, int instance, unsigned size) const
+{
+  if (instance == NULL_ID) return Reason(id);
+  return Reason(id,&m_instance_lits[instance],size);
+}
+
+inline const Reason Assignment::get_reason(Literal l) const
+{
+  Variable v = l.variable();
+  if (m_value[v] == l.sign()) return stored_reason(m_reason[v],m_instance[v],m_instance_size[v]);
+  if (v == m_contradiction)
+    return stored_reason(m_contradiction_reason,m_contradiction_instance,m_contradiction_instance_size);
+  return Reason();
+}
+
+inline int Assignment::store_instance(const Reason& r)
+{
+  if (!r.has_instance()) return NULL_ID;
+  int start = (int)m_instance_lits.size();
+  m_instance_lits.insert(m_instance_lits.end(),r.instance(),r.instance() + r.instance_size());
+  return start;
+}
 
 inline bool Assignment::watchable(Literal l) const
 {
@@ -220,7 +273,7 @@ inline int Assignment::position(Variable v) const
 
 
 
-inline Literal Assignment::random_unvalued_literal() const
+inline Literal Assignment::random_unvalued_literal(unsigned* seed) const
 {
   vector<size_t> candidates;
   for (size_t i=1; i < m_value.size(); i++) 
@@ -228,7 +281,7 @@ inline Literal Assignment::random_unvalued_literal() const
   //  bool sign = rand() % 2;
   bool sign = true;
   size_t var = 0;
-  if (!candidates.empty()) var = candidates[rand() % candidates.size()];
+  if (!candidates.empty()) var = candidates[(seed ? rand_r(seed) : rand()) % candidates.size()];
   return Literal(var, sign);
 }
 
@@ -297,7 +350,9 @@ inline void Assignment::resize(size_t sz) // sz is the highest index we want to
 {
   size_t more = sz + 1 - m_value.size();
   m_value.insert(m_value.end(),more,UNKNOWN);
-  m_reason.insert(m_reason.end(),more,vector<Reason>(2,Reason()));
+  m_reason.insert(m_reason.end(),more,NULL_ID);
+  m_instance.insert(m_instance.end(),more,NULL_ID);
+  m_instance_size.insert(m_instance_size.end(),more,0);
   m_level.insert(m_level.end(),more,NULL_ID);
   m_position.insert(m_position.end(),more,NULL_ID);
 }
@@ -317,13 +372,13 @@ inline void Assignment::backjump(size_t al)
 inline void Assignment::update_reasons(const vector<int>& indexes)
 {
   for (size_t i=0; i < m_stack.size(); i++) {
-    Reason& r = m_reason[m_stack[i].variable()][m_stack[i].sign()];
-    if (r.is_branch() || r.is_pure()) continue;
-    if (indexes[r.id()] == -1) {
+    ClauseID& r = m_reason[m_stack[i].variable()];
+    if (r == NULL_ID || r == PURE) continue;
+    if (indexes[r] == -1) {
       cout << "we deleted this reason " << endl;
       exit(1);
     }
-    r = Reason(indexes[r.id()],r.clause_instance());
+    r = indexes[r];
   }
 }
 
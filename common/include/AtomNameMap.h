@@ -38,6 +38,16 @@ public:
       }
     }
   
+  // the atom numbered i is numbered new_id[i] from now on (see CnfRenumbering)
+  void renumber(const vector<size_t>& new_id)
+    {
+      vector<string> names(size());
+      for (size_t i=1; i <= size(); i++) names[new_id[i] - 1].swap(operator[](i - 1));
+      vector<string>::swap(names);
+      for (map<string,size_t>::iterator p = m_atoms.begin(); p != m_atoms.end(); p++)
+	p->second = new_id[p->second];
+    }
+
   void clear() { 
     m_atoms.clear(); 
     vector<string>::clear(); 
@@ -31,6 +31,7 @@ public:
   virtual void      add_learned_clause(ClauseID c_id, const Assignment& P) = 0;
   virtual Result    load_unit_literals(Assignment& P) = 0;
   virtual void      reduce_knowledge_base(Assignment& P) = 0;
+  virtual Result    import_shared_clauses(Assignment& P) { return SUCCESS; }  // learned by other solvers, see zap/portfolio.h
   
   virtual const Clause&          clause(ClauseID c) const = 0;  // reference to a clause via ID
   virtual const vector<double>&  VSIDS_counts() const = 0;
@@ -0,0 +1,110 @@
+#ifndef __PROOF_WRITER__
+#define __PROOF_WRITER__
+
+#include <cstdio>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common.h"
+using namespace std;
+
+namespace zap
+{
+
+#define PROOF_BUFFER_SIZE   (1 << 22)   // bytes the solver fills before handing them to the writer
+
+
+/*  A ProofWriter writes a proof of unsatisfiability to a file without slowing the solver down
+    much.  zapsat's CNF clause set writes binary DRAT (add and delete) and pbchaff writes a
+    VeriPB style text log.  The ProofWriter doesn't care which, it just moves bytes.
+
+    The solver appends to one big buffer, and once that holds PROOF_BUFFER_SIZE bytes it swaps
+    it with a second buffer that a thread of our own writes to the file.  The solver only waits
+    if the writer hasn't finished the previous buffer yet, which means the disk can't keep up.
+
+    Binary DRAT records are 'a' (add) or 'd' (delete), then each literal as 2*variable, plus 1
+    if it's negative, in 7 bit groups low group first with the high bit set on all but the last,
+    and finally a 0.  drat-trim reads these directly.
+
+    If the solver's variables have been renumbered (see CnfRenumbering) map_variables makes us
+    write each literal with the variable's original number, so the proof goes with the input.
+ */
+
+class ProofWriter {
+  FILE*               m_file;
+  string              m_filename;
+  vector<char>        m_buffer;       // being filled by the solver
+  vector<char>        m_full;         // being written out by m_thread
+  bool                m_full_ready;
+  bool                m_closing;
+  mutex               m_mutex;
+  condition_variable  m_changed;
+  thread              m_thread;
+  const vector<Variable>*  m_original;   // solver variable -> input variable, NULL if they're the same
+
+  void  write_buffers();
+  void  hand_off();
+  void  put_literal(Literal l);
+  void  put_clause(char kind, const Literal* lits, size_t size);
+
+public:
+  ProofWriter(const string& filename);
+  ~ProofWriter() { close(); }
+  void  close();
+
+  void  map_variables(const vector<Variable>* original) { m_original = original; }
+
+  // binary DRAT
+  void  add(const Literal* lits, size_t size)    { put_clause('a',lits,size); }
+  void  remove(const Literal* lits, size_t size) { put_clause('d',lits,size); }
+
+  // text
+  ProofWriter&  operator<<(const string& s);
+  ProofWriter&  operator<<(long n);
+};
+
+
+//////////////////////////   INLINES   ///////////////////////////////////////
+
+
+inline void ProofWriter::put_literal(Literal l)
+{
+  Variable v = m_original ? (*m_original)[l.variable()] : l.variable();
+  size_t u = 2*v + (l.sign() ? 0 : 1);
+  while (u > 127) {
+	m_buffer.push_back((char)(0x80 | (u & 0x7f)));
+	u >>= 7;
+  }
+  m_buffer.push_back((char)u);
+}
+
+
+inline void ProofWriter::put_clause(char kind, const Literal* lits, size_t size)
+{
+  m_buffer.push_back(kind);
+  for (size_t i=0; i < size; i++) put_literal(lits[i]);
+  m_buffer.push_back(0);
+  if (m_buffer.size() >= PROOF_BUFFER_SIZE) hand_off();
+}
+
+
+inline ProofWriter& ProofWriter::operator<<(const string& s)
+{
+  m_buffer.insert(m_buffer.end(),s.begin(),s.end());
+  if (m_buffer.size() >= PROOF_BUFFER_SIZE) hand_off();
+  return *this;
+}
+
+
+inline ProofWriter& ProofWriter::operator<<(long n)
+{
+  char digits[24];
+  int length = snprintf(digits,sizeof(digits),"%ld",n);
+  m_buffer.insert(m_buffer.end(),digits,digits + length);
+  return *this;
+}
+
+} // end namespace zap
+#endif
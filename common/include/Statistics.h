@@ -0,0 +1,129 @@
+#ifndef __STATISTICS__
+#define __STATISTICS__
+
+#include <cstddef>
+#include <time.h>
+using namespace std;
+
+namespace zap
+{
+
+/*  Statistics the solvers keep besides the plain counters in GlobalVars.  Where the time goes
+    (PhaseTimer) and what the learned clauses and backjumps look like (Histogram).  They live in
+    global_vars like the counters, so each thread keeps its own and the portfolio adds them up.
+    front_end prints them with the other statistics and writes them out as JSON for the progress
+    reports (see front_end.h).  */
+
+enum SolverPhase { PHASE_PARSE, PHASE_CONVERT, PHASE_PREPROCESS, PHASE_RENUMBER, PHASE_PROPAGATE, PHASE_ANALYZE, PHASE_REDUCE,
+				   NUMBER_PHASES };
+
+inline const char* phase_name(SolverPhase p)
+{
+  switch (p) {
+  case PHASE_PARSE:      return "parse";
+  case PHASE_CONVERT:    return "convert";
+  case PHASE_PREPROCESS: return "preprocess";
+  case PHASE_RENUMBER:   return "renumber";
+  case PHASE_PROPAGATE:  return "propagate";
+  case PHASE_ANALYZE:    return "analyze";
+  case PHASE_REDUCE:     return "reduce";
+  default:               return "unknown";
+  }
+}
+
+
+// seconds on a clock that doesn't jump
+inline double get_monotonic_time()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return ts.tv_sec + ts.tv_nsec/1000000000.0;
+}
+
+
+// adds the time from construction to destruction onto total
+class PhaseTimer
+{
+  double&  m_total;
+  double   m_start;
+public:
+  PhaseTimer(double& total) : m_total(total), m_start(get_monotonic_time()) { }
+  ~PhaseTimer() { m_total += get_monotonic_time() - m_start; }
+};
+
+
+// For phases that run once a decision, like unit propagation, two clock reads a call show up in
+// profiles.  This times every PHASE_SAMPLE_RATE'th call (calls counts them) and charges it that
+// many times over.
+#define PHASE_SAMPLE_RATE  64
+
+class SampledPhaseTimer
+{
+  double&  m_total;
+  double   m_start;    // negative when we're not timing this call
+public:
+  SampledPhaseTimer(double& total, size_t& calls)
+	: m_total(total), m_start(calls++ % PHASE_SAMPLE_RATE ? -1 : get_monotonic_time()) { }
+  ~SampledPhaseTimer() { if (m_start >= 0) m_total += PHASE_SAMPLE_RATE * (get_monotonic_time() - m_start); }
+};
+
+
+
+/*  A histogram of sizes in power of two buckets.  Bucket 0 counts 0, bucket 1 counts 1, bucket 2
+    counts 2 and 3, bucket 3 counts 4 to 7 and so on up to the last bucket, which takes everything
+    bigger.  It's a fixed array so adding to it never allocates and copying it is cheap.  */
+
+class Histogram
+{
+public:
+  static const size_t NUMBER_BUCKETS = 24;
+
+private:
+  long long unsigned  m_bucket[NUMBER_BUCKETS];
+  long long unsigned  m_count;
+  long long unsigned  m_sum;
+  size_t              m_max;
+
+public:
+  Histogram() { clear(); }
+
+  void clear() {
+	for (size_t i=0; i < NUMBER_BUCKETS; i++) m_bucket[i] = 0;
+	m_count = m_sum = 0;
+	m_max = 0;
+  }
+
+  void add(size_t value) {
+	size_t b = 0;
+	for (size_t v = value; v && b < NUMBER_BUCKETS - 1; v >>= 1) b++;
+	m_bucket[b]++;
+	m_count++;
+	m_sum += value;
+	if (value > m_max) m_max = value;
+  }
+
+  void add(const Histogram& h) {
+	for (size_t i=0; i < NUMBER_BUCKETS; i++) m_bucket[i] += h.m_bucket[i];
+	m_count += h.m_count;
+	m_sum += h.m_sum;
+	if (h.m_max > m_max) m_max = h.m_max;
+  }
+
+  long long unsigned  count()           const { return m_count; }
+  long long unsigned  bucket(size_t i)  const { return m_bucket[i]; }
+  size_t              max()             const { return m_max; }
+  double              mean()            const { return m_count ? (double)m_sum / m_count : 0.0; }
+
+  // the smallest value that goes in bucket i
+  static size_t bucket_low(size_t i) { return i == 0 ? 0 : (size_t)1 << (i - 1); }
+
+  // index of the last bucket with anything in it, plus one
+  size_t used_buckets() const {
+	size_t n = NUMBER_BUCKETS;
+	while (n > 0 && m_bucket[n-1] == 0) n--;
+	return n;
+  }
+};
+
+} // end namespace zap
+#endif
@@ -0,0 +1,59 @@
+#ifndef __TOUCH_COUNTER__
+#define __TOUCH_COUNTER__
+
+#include "common.h"
+
+namespace zap
+{
+
+/*  Counts the clauses and literals unit propagation looks at (global_vars.clauses_touched and
+    literals_touched).  The propagation loops used to bump global_vars directly for every clause
+    and literal they visited.  global_vars is thread_local and has a constructor, so outside common
+    each of those increments goes through a call to the TLS wrapper and a read-modify-write of
+    memory, right in the innermost loop.  A TouchCounter lives on the stack of one call to
+    get_implications, so its counts stay in registers, and adds them to global_vars once when it
+    goes out of scope.  Each thread only ever writes its own global_vars, so nothing is shared.
+
+    The counts are only statistics.  Configuring with -DZAP_TOUCH_COUNTERS=OFF, the default for
+    Release builds, defines ZAP_NO_TOUCH_COUNTERS and a TouchCounter does nothing at all, for builds
+    where we want speed and don't care about them.  clauses touched and literals touched then stay 0,
+    and upbench isn't built.  */
+
+#ifndef ZAP_NO_TOUCH_COUNTERS
+
+class TouchCounter
+{
+  long long unsigned  m_clauses;
+  long long unsigned  m_literals;
+
+public:
+  TouchCounter() : m_clauses(0), m_literals(0) { }
+  ~TouchCounter() { flush(); }
+
+  void clause()   { m_clauses++; }
+  void literal()  { m_literals++; }
+
+  // for anyone who reads global_vars before we go out of scope
+  void flush() {
+	if (m_clauses == 0 && m_literals == 0) return;
+	GlobalVars& gv = global_vars;
+	gv.clauses_touched += m_clauses;
+	gv.literals_touched += m_literals;
+	m_clauses = m_literals = 0;
+  }
+};
+
+#else
+
+class TouchCounter
+{
+public:
+  void clause()   { }
+  void literal()  { }
+  void flush()    { }
+};
+
+#endif
+
+} // end namespace zap
+#endif
@@ -4,8 +4,12 @@
 #include <iostream>
 #include <vector>
 #include <sstream>
+#include <algorithm>
+#include <sys/time.h>
+#include <sys/resource.h>
 #include "Set.h"
 #include "AtomNameMap.h"
+#include "Statistics.h"
 
 using namespace std;
 
@@ -16,9 +20,9 @@ typedef int       ClauseID;
 typedef size_t    Variable;
 typedef size_t Column;
 typedef size_t Row;
-enum Outcome { UNSAT, SAT, SAMPLE_FINISHED, TIME_OUT, MEMORY_OUT };
+enum Outcome { UNSAT, SAT, SAMPLE_FINISHED, TIME_OUT, MEMORY_OUT, CANCELLED };
 enum Result { FAILURE, SUCCESS, CONTRADICTION };
-enum ClauseSetType { CNF, PFS, SYMRES, GROUP_BASED, NOT_SPECIFIED };
+enum ClauseSetType { CNF, PFS, SYMRES, GROUP_BASED, HYBRID, NOT_SPECIFIED };
 
 const double SCORE_INC_FACTOR           = 1 / 0.95;
 const double SCORE_LIMIT                = 1e100;
@@ -88,6 +92,12 @@ public:
   long unsigned number_branch_decisions;
   long unsigned number_backtracks;
   long long unsigned prop_from_nogoods;
+  long long unsigned shared_exported;   // learned clauses passed between portfolio solvers
+  long long unsigned shared_imported;
+  long long unsigned shared_useful;     // imported clauses that later took part in conflict analysis
+  double phase_time[NUMBER_PHASES];     // seconds spent in each phase (see Statistics.h)
+  Histogram learned_sizes;              // literals in each learned clause
+  Histogram backjump_distances;         // decision levels undone by each backjump
   double solution_time;
   double time_out;
   double start_time;
@@ -112,22 +122,117 @@ public:
   size_t up_structure_bound;
   size_t relevance_bound;
   size_t symres_bound;
+  size_t number_threads;  // > 1 runs a portfolio of solvers
+  size_t number_cubes;      // > 0 splits the problem into about this many cubes (cube and conquer)
+  size_t share_size_bound;  // longest learned clause portfolio solvers share (0 means don't share)
+  size_t share_lbd_bound;   // and the most decision levels it may span (units and binaries always go)
+  size_t ground_cache_budget;  // most ground literals the hybrid clause set keeps (-c 4)
+  size_t restart_policy;       // pbchaff restarts (-q): 0 Luby, 1 LBD moving averages, 2 none
+  string proof_file;           // write a DRAT (zapsat) or VeriPB (pbchaff) proof here (-p)
+  int progress_fd;                     // JSON lines progress reports go here (-v), -1 for none
+  long unsigned progress_conflicts;    // report every this many conflicts (-x)
+  double progress_seconds;             // or this many seconds, whichever comes first (-y)
+  long unsigned next_progress_conflicts;  // when this thread reports next
+  double next_progress_time;
+  size_t worker;                       // which portfolio or cube worker this thread is, 0 otherwise
+  bool preprocess;                     // simplify plain CNFs before search (-P 1)
+  bool renumber;                       // and give their variables cache friendly numbers (-R)
 
   ClauseSetType desired_type;
 
 public:
   GlobalVars() : clauses_touched(0), queue_pops(0), literals_touched(0), number_branch_decisions(0),
-				 number_backtracks(0), prop_from_nogoods(0),
+				 number_backtracks(0), prop_from_nogoods(0), shared_exported(0), shared_imported(0), shared_useful(0),
 				 solution_time(0), time_out(0), start_time(0), dpll(false), output_variable_names(false),
 				 read_branch_from_user(false),
 				 branching_heuristic_on(true), up_queue_pop_heuristic_on(true), restarts_on(true),
        	         forget_clauses_on(true), test_local_search_up(false), use_structure(true), fix_attempts(10),
 				 map_attempts(10), structure_clause_limit(4), length_bound(2), up_structure_bound(2000),
-                 relevance_bound(5), symres_bound(2), desired_type(NOT_SPECIFIED) { }
+                 relevance_bound(5), symres_bound(2), number_threads(1), number_cubes(0),
+                 share_size_bound(8), share_lbd_bound(4), ground_cache_budget(4000000),
+                 restart_policy(0), progress_fd(-1), progress_conflicts(10000), progress_seconds(10),
+                 next_progress_conflicts(0), next_progress_time(0), worker(0), preprocess(false), renumber(false), desired_type(NOT_SPECIFIED) {
+	for (size_t i=0; i < NUMBER_PHASES; i++) phase_time[i] = 0;
+  }
+
+  // the command line options, for a worker thread.  The atom names stay with the main thread,
+  // they're as big as the problem and the workers don't print literals.
+  void copy_settings(const GlobalVars& g) {
+	time_out = g.time_out;
+	start_time = g.start_time;
+	dpll = g.dpll;
+	output_variable_names = g.output_variable_names;
+	read_branch_from_user = g.read_branch_from_user;
+	branching_heuristic_on = g.branching_heuristic_on;
+	up_queue_pop_heuristic_on = g.up_queue_pop_heuristic_on;
+	restarts_on = g.restarts_on;
+	forget_clauses_on = g.forget_clauses_on;
+	test_local_search_up = g.test_local_search_up;
+	use_structure = g.use_structure;
+	fix_attempts = g.fix_attempts;
+	map_attempts = g.map_attempts;
+	structure_clause_limit = g.structure_clause_limit;
+	length_bound = g.length_bound;
+	up_structure_bound = g.up_structure_bound;
+	relevance_bound = g.relevance_bound;
+	symres_bound = g.symres_bound;
+	number_threads = g.number_threads;
+	number_cubes = g.number_cubes;
+	share_size_bound = g.share_size_bound;
+	share_lbd_bound = g.share_lbd_bound;
+	ground_cache_budget = g.ground_cache_budget;
+	restart_policy = g.restart_policy;
+	proof_file = g.proof_file;
+	progress_fd = g.progress_fd;
+	progress_conflicts = g.progress_conflicts;
+	progress_seconds = g.progress_seconds;
+	next_progress_conflicts = g.next_progress_conflicts;
+	next_progress_time = g.next_progress_time;
+	worker = g.worker;
+	preprocess = g.preprocess;
+	renumber = g.renumber;
+	desired_type = g.desired_type;
+  }
+
+  void copy_statistics(const GlobalVars& g) {
+	clauses_touched = g.clauses_touched;
+	queue_pops = g.queue_pops;
+	literals_touched = g.literals_touched;
+	number_branch_decisions = g.number_branch_decisions;
+	number_backtracks = g.number_backtracks;
+	prop_from_nogoods = g.prop_from_nogoods;
+	shared_exported = g.shared_exported;
+	shared_imported = g.shared_imported;
+	shared_useful = g.shared_useful;
+	for (size_t i=0; i < NUMBER_PHASES; i++) phase_time[i] = g.phase_time[i];
+	learned_sizes = g.learned_sizes;
+	backjump_distances = g.backjump_distances;
+  }
+
+  // every portfolio worker shares clauses, not only the one that wins
+  void add_sharing_statistics(const GlobalVars& g) {
+	shared_exported += g.shared_exported;
+	shared_imported += g.shared_imported;
+	shared_useful += g.shared_useful;
+  }
 
+  void add_statistics(const GlobalVars& g) {
+	clauses_touched += g.clauses_touched;
+	queue_pops += g.queue_pops;
+	literals_touched += g.literals_touched;
+	number_branch_decisions += g.number_branch_decisions;
+	number_backtracks += g.number_backtracks;
+	prop_from_nogoods += g.prop_from_nogoods;
+	add_sharing_statistics(g);
+	for (size_t i=0; i < NUMBER_PHASES; i++) phase_time[i] += g.phase_time[i];
+	learned_sizes.add(g.learned_sizes);
+	backjump_distances.add(g.backjump_distances);
+  }
 };
 
-extern GlobalVars global_vars;
+// Each thread gets its own copy so solvers running in parallel keep their own statistics.
+// Threads that solve copy the main thread's settings in before they start (see zap/portfolio.cpp).
+extern thread_local GlobalVars global_vars;
 
 
 
@@ -146,6 +251,13 @@ inline ostream& operator<<(ostream& os, const Literal l)
 }
 
 
+inline double get_wall_time(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec/1000000.0;
+}
+
 inline double get_cpu_time(void) 
 {
   struct rusage ru;
@@ -156,6 +268,14 @@ inline double get_cpu_time(void)
 	   ru.ru_stime.tv_usec/1000000.0 );
 }
 
+// just the calling thread's, which is what a portfolio or cube worker should report
+inline double get_thread_cpu_time(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec/1000000000.0;
+}
+
 
 inline void quit(string s)
 {
@@ -249,7 +369,9 @@ inline Column column_image(Column c,const vector<Column>& before,const vector<Co
   return c;
 }
 
-inline Clause boolean_resolve(const Clause& c1, const Clause& c2)
+// works on anything that looks like an array of literals
+template<class C1, class C2>
+Clause boolean_resolve(const C1& c1, const C2& c2)
 {
   Clause answer;
   size_t num_opposing_lits = 0;
@@ -261,7 +383,7 @@ inline Clause boolean_resolve(const Clause& c1, const Clause& c2)
   for (size_t i=0; i < c2.size(); i++) {
 	if (!r.contains(c2[i])) {
 	  if (r.contains(c2[i].negate())) {	
-		vector<Literal>::iterator it = find(answer.begin(),answer.end(),c2[i].negate());
+		Clause::iterator it = find(answer.begin(),answer.end(),c2[i].negate());
 		*it = answer.back();
 		answer.pop_back();
 		++num_opposing_lits;
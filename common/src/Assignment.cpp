@@ -24,16 +24,23 @@ Literal Assignment::pop_unit_list()
 
 bool Assignment::extend(AnnotatedLiteral l)   // extend the current partial assignment with literal l
 {
-  if (m_value[l.variable()] == (size_t)(!l.sign())) {  // check the stack for contradictions
-    m_contradiction = l.variable();
-    m_reason[l.variable()][l.sign()] = l.reason();
+  Variable v = l.variable();
+  if (m_value[v] == (size_t)(!l.sign())) {  // check the stack for contradictions
+    Reason r = l.reason();
+    m_contradiction = v;
+    m_contradiction_reason = r.id();
+    m_contradiction_instance = store_instance(r);
+    m_contradiction_instance_size = r.instance_size();
     return false;
   }
 
-  if (m_value[l.variable()] != UNKNOWN) return true;  // it's already set
+  if (m_value[v] != UNKNOWN) return true;  // it's already set
   
-  m_reason[l.variable()][l.sign()] = l.reason();
-  m_value[l.variable()] = l.sign();
+  Reason r = l.reason();
+  m_reason[v] = r.id();
+  m_instance[v] = store_instance(r);
+  m_instance_size[v] = r.instance_size();
+  m_value[v] = l.sign();
   m_unit_list.insert(l.variable());
   return true;
 }
@@ -41,17 +48,33 @@ bool Assignment::extend(AnnotatedLiteral l)   // extend the current partial assi
 
 bool Assignment::has_contradiction() const
 {
-  if (m_reason[m_contradiction][true].id() == NULL_ID) return false;
-  if (m_reason[m_contradiction][false].id() == NULL_ID) return false;
-  return true;
+  if (m_contradiction_reason == NULL_ID) return false;
+  if (m_value[m_contradiction] == UNKNOWN) return false;
+  return m_reason[m_contradiction] != NULL_ID;
+}
+
+
+// clear the reason for v and note where its instance started, if it had one
+void Assignment::forget_reason(Variable v, size_t& instances_top)
+{
+  if (m_instance[v] != NULL_ID && (size_t)m_instance[v] < instances_top) instances_top = m_instance[v];
+  m_reason[v] = NULL_ID;
+  m_instance[v] = NULL_ID;
+  m_instance_size[v] = 0;
 }
 
 
 Literal Assignment::undo_current_decision()
 {
+  size_t instances_top = m_instance_lits.size();
+  if (m_contradiction_instance != NULL_ID) instances_top = m_contradiction_instance;
+  m_contradiction_reason = NULL_ID;
+  m_contradiction_instance = NULL_ID;
+  m_contradiction_instance_size = 0;
+  
   while (!m_unit_list.empty()) { //  clear the unit_list
     Variable v = m_unit_list.top();
-	m_reason[v][m_value[v]] = Reason();
+	forget_reason(v,instances_top);
 	m_value[v] = UNKNOWN;
 	m_unit_list.pop();
   }
@@ -62,11 +85,12 @@ Literal Assignment::undo_current_decision()
     m_level[l.variable()] = NULL_ID;
     m_position[l.variable()] = NULL_ID;
     m_value[l.variable()] = UNKNOWN;
-    m_reason[l.variable()][true]  = Reason();
-    m_reason[l.variable()][false] = Reason();
+    forget_reason(l.variable(),instances_top);
     m_stack.pop_back();
   }
   m_current_level--;
+  m_instance_lits.resize(instances_top);           // everything after the first instance we freed is
+                                                   // from this level too
 
   return l;                                     // we return the associated branch decision so the calling
 }                                               // function can try the other variable value
@@ -103,28 +127,20 @@ vector<Literal> Assignment::lits_at_current_level(const Clause& c) const
 size_t Assignment::assertion_level(const Clause& c) const
 {
   if (c.size() <= 1) return 0;
-  
-  // int deepest = NULL_ID;
-  // int next_deepest = NULL_ID;
-  // for (size_t i=0; i < c.size(); i++) {
-  //   int level = decision_level(c[i].variable());
-  //   if (level >= deepest) {
-  //     next_deepest = deepest;
-  //     deepest = level;
-  //   }
-  //   else {
-  //     if (level > next_deepest) {
-  // 	next_deepest = level;
-  //     }
-  //   }
-  // }
-  // // sanity test
-  // if (next_deepest != decision_level(c[1].variable())) {
-  //   cerr << "asserting lit not in the right place" << endl;
-  //   cerr << next_deepest << " vs " << decision_level(c[1].variable()) << endl;
-  //   exit(1);
-  // }
-  return decision_level(c[1].variable());
+
+  // the second deepest level.  We don't count on the clause set having moved that literal to c[1]
+  // yet, the solver asks before it adds the clause.
+  int deepest = 0;
+  int next_deepest = 0;
+  for (size_t i=0; i < c.size(); i++) {
+    int level = decision_level(c[i].variable());
+    if (level >= deepest) {
+      next_deepest = deepest;
+      deepest = level;
+    }
+    else if (level > next_deepest) next_deepest = level;
+  }
+  return next_deepest;
 }
 
 
@@ -0,0 +1,58 @@
+#include "ProofWriter.h"
+
+namespace zap
+{
+
+ProofWriter::ProofWriter(const string& filename) : m_filename(filename), m_full_ready(false), m_closing(false), m_original(NULL)
+{
+  m_file = fopen(filename.c_str(),"wb");
+  if (m_file == NULL) quit("can't open proof file " + filename);
+  m_buffer.reserve(PROOF_BUFFER_SIZE + 4096);
+  m_full.reserve(PROOF_BUFFER_SIZE + 4096);
+  m_thread = thread(&ProofWriter::write_buffers,this);
+}
+
+
+// runs on m_thread.  We write without holding the lock so the solver can keep filling m_buffer.
+void ProofWriter::write_buffers()
+{
+  unique_lock<mutex> lock(m_mutex);
+  while (true) {
+	m_changed.wait(lock,[this]{ return m_full_ready || m_closing; });
+	if (!m_full_ready) return;   // closing and there's nothing left
+	lock.unlock();
+	if (fwrite(m_full.data(),1,m_full.size(),m_file) != m_full.size())
+	  quit("couldn't write proof file " + m_filename);
+	m_full.clear();
+	lock.lock();
+	m_full_ready = false;
+	m_changed.notify_all();
+  }
+}
+
+
+void ProofWriter::hand_off()
+{
+  unique_lock<mutex> lock(m_mutex);
+  m_changed.wait(lock,[this]{ return !m_full_ready; });
+  m_buffer.swap(m_full);
+  m_full_ready = true;
+  m_changed.notify_all();
+}
+
+
+void ProofWriter::close()
+{
+  if (m_file == NULL) return;
+  if (!m_buffer.empty()) hand_off();
+  {
+	lock_guard<mutex> lock(m_mutex);
+	m_closing = true;
+  }
+  m_changed.notify_all();
+  m_thread.join();
+  if (fclose(m_file) != 0) quit("couldn't write proof file " + m_filename);
+  m_file = NULL;
+}
+
+} // end namespace zap
@@ -3,7 +3,7 @@
 namespace zap
 {
 
-GlobalVars global_vars;
+thread_local GlobalVars global_vars;
 
 }
 
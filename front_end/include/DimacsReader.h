@@ -0,0 +1,74 @@
+#ifndef __DIMACS_READER__
+#define __DIMACS_READER__
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "common.h"
+#include "Cnf.h"
+using namespace std;
+
+namespace zap
+{
+
+////////////////////////////////////////   DIMACS READER   ////////////////////////////////////////
+/*
+  The DimacsReader reads a plain DIMACS CNF file straight into a Cnf.  The general parser
+  (grammar.y) has to handle the whole zap input language, so every literal goes through flex,
+  yacc, an InputTheory full of strings, the atom name map and finally a vector<Clause> before it
+  gets to the Cnf arena.  For big CNF instances that takes longer than solving some of them.
+
+  Here we map the file into memory and scan the integers by hand, appending each clause to the
+  Cnf arena as soon as we see its terminating 0.  Files ending in .gz or .xz are decompressed
+  by gzip or xz running on the other end of a pipe, and we scan them a buffer at a time.
+
+  DIMACS variable n gets atom id n and the name "n", so the ids match the file and the
+  output looks the same as before.  Like the old path we sort each clause, take out duplicate
+  literals and drop tautologies, because the Cnf watches the first two literals of a clause and
+  they have to be different.  DIMACS allows 5 5 -7 0.  An empty clause (a 0 on its own) can't go
+  in the Cnf either, so we just note that there was one and the input is UNSAT.
+*/
+
+class DimacsReader {
+  string          m_filename;
+  const char*     m_cursor;
+  const char*     m_end;
+  char*           m_map;          // the mapped file
+  size_t          m_map_size;
+  FILE*           m_pipe;         // or the output of the decompressor
+  vector<char>    m_buffer;
+  size_t          m_line;
+  bool            m_empty_clause;
+
+  void  open_file();
+  void  close_file();
+  bool  refill();
+  int   next_char();
+  int   skip_white_space();
+  void  skip_line();
+  long  read_int(int c);
+  void  error(const string& message);
+  void  append_clause(Cnf& cnf, vector<Literal>& clause);
+
+public:
+  DimacsReader(const string& filename);
+  ~DimacsReader() { close_file(); }
+  void read(Cnf& cnf);
+  bool has_empty_clause() const { return m_empty_clause; }
+
+  static bool compressed(const string& filename);
+  static bool is_dimacs(const string& filename);
+};
+
+
+//////////////////////////   INLINES   ///////////////////////////////////////
+
+// only the pipe ever needs refilling, a mapped file is one big buffer
+inline int DimacsReader::next_char()
+{
+  if (m_cursor == m_end && !refill()) return EOF;
+  return (unsigned char)*m_cursor++;
+}
+
+} // end namespace zap
+#endif
@@ -0,0 +1,42 @@
+#ifndef __PERF_COUNTERS__
+#define __PERF_COUNTERS__
+
+#include <cstddef>
+using namespace std;
+
+namespace zap
+{
+
+/*  Hardware counters for the calling thread, read with perf_event_open on Linux.  The UP testing
+    framework runs them over the sample (see UPTesting.h) so we can compare unit propagation code on
+    cache misses and instructions and not just on time.  Whether we get them at all depends on the
+    kernel, on /proc/sys/kernel/perf_event_paranoid and on the machine (virtual machines often don't
+    pass the counters through), so any of them can be missing and available says which ones we have.
+    We only count user space, which is what the paranoid setting usually allows.  If the kernel had
+    to share the counters between events the counts are scaled up to the whole sample.  */
+
+enum PerfEvent { PERF_CYCLES, PERF_INSTRUCTIONS, PERF_CACHE_REFERENCES, PERF_CACHE_MISSES,
+				 PERF_BRANCH_MISSES, NUMBER_PERF_EVENTS };
+
+class PerfCounters {
+  int                 m_fd[NUMBER_PERF_EVENTS];      // -1 if we couldn't open the counter
+  long long unsigned  m_count[NUMBER_PERF_EVENTS];
+  bool                m_opened;
+
+  void  open();
+
+public:
+  PerfCounters();
+  ~PerfCounters();
+
+  void  start();    // zero and enable every counter we could open
+  void  stop();     // disable them and read the counts
+
+  bool                available(PerfEvent e) const { return m_fd[e] >= 0; }
+  bool                any_available()        const;
+  long long unsigned  count(PerfEvent e)     const { return m_count[e]; }
+  static const char*  name(PerfEvent e);
+};
+
+} // end namespace zap
+#endif
@@ -41,6 +41,7 @@
 
 #include "front_end.h"
 #include "Assignment.h"
+#include "PerfCounters.h"
 using namespace std;
 
 namespace zap
@@ -52,7 +53,6 @@ namespace zap
 class UPTestingInterface {
 protected:
   UPTestingInterface() { }
-  virtual ~UPTestingInterface() { }
   
   virtual AnnotatedLiteral upt_local_select_branch() = 0;   // wrapper for calling the local solver's branching function
   virtual bool             upt_assignment_is_full() = 0;            
@@ -62,12 +62,21 @@ protected:
   AnnotatedLiteral         upt_select_branch();            // may branch from a file or defer to local_select_branch
   Outcome                  upt_dpll_inner_loop();
 public:
-  void                     upt_dpll();
+  virtual ~UPTestingInterface() { }
+  Outcome                  upt_dpll();
 };
 
 
 
 extern long unsigned sample_size;  // the number of unit propagation calls we want to make/sample
+extern long unsigned trial_count;  // how many we actually made
+
+// what we measured over the sample, for anyone who wants more than output_up_stats prints
+extern double       sample_start_time;    // cpu time
+extern double       sample_finish_time;
+extern double       sample_start_wall;
+extern double       sample_finish_wall;
+extern PerfCounters sample_counters;      // hardware counters, where the machine lets us have them
 
 
 
@@ -12,10 +12,26 @@ namespace zap
 {
 Cnf read_cnf(int argc, char** argv);  
 InputTheory parse_input(int argc, char** argv);
+InputTheory parse_file(const string& name);
+bool use_dimacs_reader(const string& name);
+void read_dimacs(const string& name, Cnf& cnf);
+void read_testing_params(int argc, char** argv);
 void output_up_stats();
 void output_solver_stats();
 void output_result(Outcome result);
+void output_progress(const char* event);
 bool get_token(string& token, string& line);
 
+
+// The solvers call this after each conflict.  If -v asked for progress reports and one is due
+// (every -x conflicts or -y seconds) it writes a JSON line with this thread's statistics.
+inline void check_progress()
+{
+  GlobalVars& gv = global_vars;
+  if (gv.progress_fd < 0) return;
+  if (gv.number_backtracks >= gv.next_progress_conflicts || get_monotonic_time() >= gv.next_progress_time)
+	output_progress("progress");
+}
+
 }
 #endif
@@ -0,0 +1,220 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include "DimacsReader.h"
+
+namespace zap
+{
+
+const size_t PIPE_BUFFER_SIZE = 1 << 20;
+
+
+DimacsReader::DimacsReader(const string& filename) : m_filename(filename), m_cursor(NULL), m_end(NULL),
+													 m_map(NULL), m_map_size(0), m_pipe(NULL), m_line(1),
+													 m_empty_clause(false)
+{
+  open_file();
+}
+
+
+bool DimacsReader::compressed(const string& filename)
+{
+  size_t n = filename.size();
+  return n > 3 && (filename.compare(n-3,3,".gz") == 0 || filename.compare(n-3,3,".xz") == 0);
+}
+
+
+// the first line that isn't a comment has to be the problem line.  We can't look inside compressed
+// files cheaply, but the general parser can't read them at all so they have to be DIMACS.
+bool DimacsReader::is_dimacs(const string& filename)
+{
+  if (compressed(filename)) return true;
+  ifstream in(filename.c_str());
+  string line;
+  while (getline(in,line)) {
+	size_t i = line.find_first_not_of(" \t\r");
+	if (i == string::npos || line[i] == 'c') continue;
+	return line.compare(i,5,"p cnf") == 0;
+  }
+  return false;
+}
+
+
+
+////////////////////////////////////   THE INPUT BUFFER   ////////////////////////////////////
+
+
+void DimacsReader::open_file()
+{
+  if (compressed(m_filename)) {
+	string quoted = "'";   // the shell shouldn't interpret anything in the file name
+	for (size_t i=0; i < m_filename.size(); i++) {
+	  if (m_filename[i] == '\'') quoted += "'\\''";
+	  else quoted += m_filename[i];
+	}
+	quoted += "'";
+	string program = (m_filename.compare(m_filename.size()-3,3,".gz") == 0 ? "gzip" : "xz");
+	if (access(m_filename.c_str(),R_OK) != 0) quit("can't open " + m_filename);
+	m_pipe = popen((program + " -dc " + quoted).c_str(),"r");
+	if (m_pipe == NULL) quit("can't run " + program + " to read " + m_filename);
+	m_buffer.resize(PIPE_BUFFER_SIZE);
+	m_cursor = m_end = m_buffer.data();
+	return;
+  }
+
+  int fd = open(m_filename.c_str(),O_RDONLY);
+  if (fd < 0) quit("can't open " + m_filename);
+  struct stat st;
+  if (fstat(fd,&st) != 0) quit("can't read " + m_filename);
+  m_map_size = st.st_size;
+  if (m_map_size > 0) {
+	void* p = mmap(NULL,m_map_size,PROT_READ,MAP_PRIVATE,fd,0);
+	if (p == MAP_FAILED) quit("can't map " + m_filename);
+	madvise(p,m_map_size,MADV_SEQUENTIAL);
+	m_map = (char*)p;
+  }
+  close(fd);  // the mapping stays valid
+  m_cursor = m_map;
+  m_end = m_map + m_map_size;
+}
+
+
+void DimacsReader::close_file()
+{
+  if (m_map) munmap(m_map,m_map_size);
+  while (refill()) { }  // let the decompressor finish or it dies of a broken pipe
+  if (m_pipe && pclose(m_pipe) != 0) quit("couldn't decompress " + m_filename);
+  m_map = NULL;
+  m_pipe = NULL;
+}
+
+
+bool DimacsReader::refill()
+{
+  if (m_pipe == NULL) return false;
+  size_t n = fread(m_buffer.data(),1,m_buffer.size(),m_pipe);
+  m_cursor = m_buffer.data();
+  m_end = m_cursor + n;
+  return n > 0;
+}
+
+
+
+////////////////////////////////////////   SCANNING   ////////////////////////////////////////
+
+
+void DimacsReader::error(const string& message)
+{
+  quit(m_filename + " line " + to_string(m_line) + ": " + message);
+}
+
+
+// returns the first character that isn't white space
+int DimacsReader::skip_white_space()
+{
+  int c = next_char();
+  while (c == ' ' || c == '\n' || c == '\t' || c == '\r') {
+	if (c == '\n') m_line++;
+	c = next_char();
+  }
+  return c;
+}
+
+
+void DimacsReader::skip_line()
+{
+  int c = next_char();
+  while (c != '\n' && c != EOF) c = next_char();
+  m_line++;
+}
+
+
+// c is the first character of the number
+long DimacsReader::read_int(int c)
+{
+  bool negative = (c == '-');
+  if (c == '-' || c == '+') c = next_char();
+  if (c < '0' || c > '9') error("expected a number");
+  long n = 0;
+  while (c >= '0' && c <= '9') {
+	n = n*10 + (c - '0');
+	if (n > INT_MAX) error("number too big");
+	c = next_char();
+  }
+  if (c == '\n') m_line++;
+  else if (c != ' ' && c != '\t' && c != '\r' && c != EOF) error("unexpected character after a number");
+  return negative ? -n : n;
+}
+
+
+
+////////////////////////////////////////   READING   ////////////////////////////////////////
+
+
+// sorted, without duplicate literals, and not at all if it's a tautology (5 5 -7, 3 -3 8) or empty
+void DimacsReader::append_clause(Cnf& cnf, vector<Literal>& clause)
+{
+  if (clause.empty()) {
+	m_empty_clause = true;
+	return;
+  }
+  sort(clause.begin(),clause.end());
+  clause.erase(unique(clause.begin(),clause.end()),clause.end());
+  for (size_t i=1; i < clause.size(); i++)
+	if (clause[i].variable() == clause[i-1].variable()) return;
+  cnf.append_input_clause(clause.data(),clause.size());
+}
+
+
+
+void DimacsReader::read(Cnf& cnf)
+{
+  AtomNameMap& names = global_vars.atom_name_map;
+  if (!names.empty()) quit("the DIMACS reader needs an empty atom name map");
+
+  long number_vars = 0;
+  long number_clauses = 0;
+  long max_var = 0;
+  bool seen_header = false;
+  vector<Literal> clause;
+
+  for (int c = skip_white_space(); c != EOF; c = skip_white_space()) {
+	if (c == 'c') { skip_line(); continue; }
+	if (c == '%') break;  // the SATLIB benchmarks end this way
+	if (c == 'p') {
+	  if (seen_header) error("second problem line");
+	  string format;
+	  for (c = skip_white_space(); c >= 'a' && c <= 'z'; c = next_char()) format += char(c);
+	  if (format != "cnf") error("the problem line has to be p cnf, not p " + format);
+	  number_vars = read_int(skip_white_space());
+	  number_clauses = read_int(skip_white_space());
+	  seen_header = true;
+	  cnf.begin_input(number_clauses,0);
+	  continue;
+	}
+	if (!seen_header) error("clause before the problem line");
+	long lit = read_int(c);
+	if (lit == 0) {
+	  append_clause(cnf,clause);
+	  clause.clear();
+	  continue;
+	}
+	long var = (lit < 0 ? -lit : lit);
+	if (var > max_var) max_var = var;
+	clause.push_back(Literal(var,lit > 0));
+  }
+  if (!clause.empty()) append_clause(cnf,clause);  // no terminating 0
+  close_file();
+
+  if (!seen_header) quit(m_filename + " has no DIMACS problem line");
+  if (max_var > number_vars) number_vars = max_var;
+  for (long v=1; v <= number_vars; v++) names.lookup(to_string(v));
+  cnf.finish_input();
+}
+
+} // end namespace zap
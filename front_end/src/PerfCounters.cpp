@@ -0,0 +1,112 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace zap
+{
+
+PerfCounters::PerfCounters() : m_opened(false)
+{
+  for (size_t i=0; i < NUMBER_PERF_EVENTS; i++) {
+	m_fd[i] = -1;
+	m_count[i] = 0;
+  }
+}
+
+
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+  for (size_t i=0; i < NUMBER_PERF_EVENTS; i++)
+	if (m_fd[i] >= 0) close(m_fd[i]);
+#endif
+}
+
+
+const char* PerfCounters::name(PerfEvent e)
+{
+  switch (e) {
+  case PERF_CYCLES:            return "cycles";
+  case PERF_INSTRUCTIONS:      return "instructions";
+  case PERF_CACHE_REFERENCES:  return "cache_references";
+  case PERF_CACHE_MISSES:      return "cache_misses";
+  case PERF_BRANCH_MISSES:     return "branch_misses";
+  default:                     return "unknown";
+  }
+}
+
+
+bool PerfCounters::any_available() const
+{
+  for (size_t i=0; i < NUMBER_PERF_EVENTS; i++)
+	if (m_fd[i] >= 0) return true;
+  return false;
+}
+
+
+// We only try once.  Counters that fail stay at -1 and are left out from then on.
+void PerfCounters::open()
+{
+  m_opened = true;
+#ifdef __linux__
+  const unsigned long long config[NUMBER_PERF_EVENTS] = {
+	PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_REFERENCES,
+	PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+
+  for (size_t i=0; i < NUMBER_PERF_EVENTS; i++) {
+	struct perf_event_attr attr;
+	memset(&attr,0,sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = config[i];
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	m_fd[i] = (int)syscall(__NR_perf_event_open,&attr,0,-1,-1,0);   // this thread, any cpu
+  }
+#endif
+}
+
+
+void PerfCounters::start()
+{
+  if (!m_opened) open();
+  for (size_t i=0; i < NUMBER_PERF_EVENTS; i++) m_count[i] = 0;
+#ifdef __linux__
+  for (size_t i=0; i < NUMBER_PERF_EVENTS; i++) {
+	if (m_fd[i] < 0) continue;
+	ioctl(m_fd[i],PERF_EVENT_IOC_RESET,0);
+	ioctl(m_fd[i],PERF_EVENT_IOC_ENABLE,0);
+  }
+#endif
+}
+
+
+void PerfCounters::stop()
+{
+#ifdef __linux__
+  for (size_t i=0; i < NUMBER_PERF_EVENTS; i++)
+	if (m_fd[i] >= 0) ioctl(m_fd[i],PERF_EVENT_IOC_DISABLE,0);
+
+  for (size_t i=0; i < NUMBER_PERF_EVENTS; i++) {
+	if (m_fd[i] < 0) continue;
+	unsigned long long values[3];   // count, time enabled, time running
+	if (read(m_fd[i],values,sizeof(values)) != (ssize_t)sizeof(values)) {
+	  close(m_fd[i]);
+	  m_fd[i] = -1;
+	  continue;
+	}
+	if (values[2] == 0) m_count[i] = 0;
+	else m_count[i] = (long long unsigned)((double)values[0] * values[1] / values[2]);
+  }
+#endif
+}
+
+} // end namespace zap
@@ -16,7 +16,10 @@ long unsigned sample_start_count = 0; // we start timing when we hit this many t
 long unsigned sample_size = 0;         // this is the total number of trials we want to sample
 double sample_start_time = 0;
 double sample_finish_time = 0;
+double sample_start_wall = 0;
+double sample_finish_wall = 0;
 bool sample_started = false;
+PerfCounters sample_counters;
 
 
 
@@ -26,16 +29,21 @@ bool sample_started = false;
 
 void start_sample()
 {
-  sample_start_time = get_cpu_time();
   global_vars.clauses_touched = 0;
   global_vars.literals_touched = 0;
+  global_vars.queue_pops = 0;
+  sample_start_wall = get_wall_time();
+  sample_start_time = get_cpu_time();
+  sample_counters.start();
 }
 
 
 
 void end_sample()
 {
+  sample_counters.stop();
   sample_finish_time = get_cpu_time();
+  sample_finish_wall = get_wall_time();
 }
 
 
@@ -50,14 +58,20 @@ AnnotatedLiteral branch_from_file()
     exit(0);
   }
   
-  get_token(branch,line);
+  // the whole line is the name, names from .zap files have spaces in them (in[2 8])
+  string::size_type begin = line.find_first_not_of(" \t");
+  string::size_type end = line.find_last_not_of(" \t\r");
+  if (begin == string::npos) quit("Blank line in branch file " + branch_file_in);
+  branch = line.substr(begin,end - begin + 1);
   
   if (branch[0] == '-') {
     sign = false;
     branch.erase(0,1);
   }
   
+  size_t known = global_vars.atom_name_map.size();
   size_t atom = global_vars.atom_name_map.lookup(branch);
+  if (atom > known) quit("Branch file " + branch_file_in + " has unknown variable " + branch);
   return AnnotatedLiteral(Literal(atom,sign));
 }
 
@@ -115,12 +129,13 @@ AnnotatedLiteral UPTestingInterface::upt_select_branch()
 
 
 
-void UPTestingInterface::upt_dpll()
+Outcome UPTestingInterface::upt_dpll()
 {
   Outcome result = upt_dpll_inner_loop();
-  output_result(result);
   end_sample();
+  output_result(result);
   output_up_stats();
+  return result;
 }
 
 } // end namespace zap
@@ -2,11 +2,17 @@
 #include <iomanip>
 #include <string>
 #include <cmath>
+#include <cstdlib>
+#include <mutex>
+#include <fcntl.h>
 #include <sys/resource.h>
+#include <unistd.h>
 #include "front_end.h"
 #include "InputTheory.h"
 #include "Cnf.h"
 #include "Converter.h"
+#include "DimacsReader.h"
+#include "PerfCounters.h"
 using namespace zap;
 
 int yyparse();
@@ -26,19 +32,26 @@ extern string branch_file_in;
 extern string branch_file_out;
 extern double sample_start_time;
 extern double sample_finish_time;
+extern double sample_start_wall;
+extern double sample_finish_wall;
+extern PerfCounters sample_counters;
 
 
 //////////////////////////////////////  PARSING INPUT FILE  ///////////////////////////////////////////
 
+// the name on the command line can leave off the .zap or .cnf
+string input_file_name(string name)
+{
+  if (access(name.c_str(),F_OK) == 0) return name;
+  if (access((name + ".zap").c_str(),F_OK) == 0) return name + ".zap";
+  if (access((name + ".cnf").c_str(),F_OK) == 0) return name + ".cnf";
+  return name;
+}
+
+
 FILE * open_file(string name)
 {
-  FILE * ans = fopen(name.c_str(),"r");
-  if (ans) return ans;
-  string longname = name + ".zap";
-  ans = fopen(longname.c_str(),"r");
-  if (ans) return ans;
-  longname = name + ".cnf";
-  return fopen(longname.c_str(),"r");
+  return fopen(input_file_name(name).c_str(),"r");
 }
 
 
@@ -58,11 +71,118 @@ bool get_token(string &token, string &line)
 
 
 
+//////////////////////////////////////  PROGRESS REPORTS  /////////////////////////////////////////////
+
+/*  With -v the solvers write a JSON line every -x conflicts or -y seconds (see check_progress in
+    front_end.h) and output_solver_stats writes one more with everything at the end.  A scheduler
+    can watch these to decide whether a solve is worth waiting for.  The destination can be a file
+    descriptor the scheduler opened for us or a file.  Portfolio and cube workers all report, each
+    line says which worker it came from, and we write each line with a single write so they don't
+    get mixed up.  */
+
+double progress_start_wall = 0;
+std::mutex progress_mutex;
+
+
+void open_progress(const string& dest)
+{
+  if (dest.find_first_not_of("0123456789") == string::npos)
+	global_vars.progress_fd = atoi(dest.c_str());
+  else {
+	global_vars.progress_fd = open(dest.c_str(),O_WRONLY | O_CREAT | O_TRUNC | O_APPEND,0644);
+	if (global_vars.progress_fd < 0) quit("can't write progress reports to " + dest);
+  }
+  progress_start_wall = get_wall_time();
+}
+
+
+// when this thread should report next
+void schedule_progress()
+{
+  GlobalVars& gv = global_vars;
+  gv.next_progress_conflicts = (gv.progress_conflicts ? gv.number_backtracks + gv.progress_conflicts
+								: (long unsigned)-1);
+  gv.next_progress_time = (gv.progress_seconds > 0 ? get_monotonic_time() + gv.progress_seconds : HUGE_VAL);
+}
+
+
+void write_json_histogram(ostream& os, const char* name, const Histogram& h)
+{
+  os << ",\"" << name << "\":{\"count\":" << h.count() << ",\"mean\":" << h.mean() << ",\"max\":" << h.max()
+	 << ",\"buckets\":[";
+  for (size_t i=0; i < h.used_buckets(); i++)   // [smallest value in the bucket, count]
+	os << (i ? "," : "") << '[' << Histogram::bucket_low(i) << ',' << h.bucket(i) << ']';
+  os << "]}";
+}
+
+
+// one JSON line with this thread's statistics.  Histograms only go in the final report.
+string json_statistics(const char* event)
+{
+  const GlobalVars& gv = global_vars;
+  bool final = (string(event) == "final");
+  ostringstream os;
+  os << setprecision(6);
+  os << "{\"event\":\"" << event << "\""
+	 << ",\"worker\":" << gv.worker
+	 << ",\"wall\":" << get_wall_time() - progress_start_wall
+	 << ",\"cpu\":" << (final ? get_cpu_time() : get_thread_cpu_time())   // the whole run, or this worker
+	 << ",\"decisions\":" << gv.number_branch_decisions
+	 << ",\"conflicts\":" << gv.number_backtracks
+	 << ",\"queue_pops\":" << gv.queue_pops
+	 << ",\"clauses_touched\":" << gv.clauses_touched
+	 << ",\"literals_touched\":" << gv.literals_touched
+	 << ",\"learned_size_mean\":" << gv.learned_sizes.mean()
+	 << ",\"backjump_mean\":" << gv.backjump_distances.mean();
+  if (gv.number_threads > 1)
+	os << ",\"shared_exported\":" << gv.shared_exported
+	   << ",\"shared_imported\":" << gv.shared_imported
+	   << ",\"shared_useful\":" << gv.shared_useful;
+  os << ",\"phase_time\":{";
+  for (size_t i=0; i < NUMBER_PHASES; i++)
+	os << (i ? "," : "") << '"' << phase_name((SolverPhase)i) << "\":" << gv.phase_time[i];
+  os << '}';
+  if (final) {
+	const char* result = "unknown";
+	switch (gv.result) {
+	case UNSAT :           result = "UNSAT"; break;
+	case SAT :             result = "SAT"; break;
+	case TIME_OUT :        result = "TIME_OUT"; break;
+	case SAMPLE_FINISHED : result = "SAMPLE_FINISHED"; break;
+	default : break;
+	}
+	os << ",\"result\":\"" << result << "\",\"solution_time\":" << gv.solution_time;
+	write_json_histogram(os,"learned_sizes",gv.learned_sizes);
+	write_json_histogram(os,"backjump_distances",gv.backjump_distances);
+  }
+  os << "}\n";
+  return os.str();
+}
+
+
+void output_progress(const char* event)
+{
+  if (global_vars.progress_fd < 0) return;
+  string line = json_statistics(event);
+  {
+	std::lock_guard<std::mutex> lock(progress_mutex);
+	size_t written = 0;
+	while (written < line.size()) {
+	  ssize_t n = write(global_vars.progress_fd,line.data() + written,line.size() - written);
+	  if (n <= 0) break;   // the scheduler went away, that's not our problem
+	  written += n;
+	}
+  }
+  schedule_progress();
+}
+
+
+
 void output_commandline_args()
 {
   cout << "Command line arguments are: " << endl;
   cout << setw(20) << left << "     -c #"
-       << "desired clauseset type 0:CNF, 1:PFS, 2:SYMRES, 3:GROUP_BASED" << endl
+       << "desired clauseset type 0:CNF, 1:PFS, 2:SYMRES, 3:GROUP_BASED, 4:HYBRID" << endl
        << setw(20) << left << "     -b #"
        << "symres length bound" << endl
        << setw(20) << left << "     -a"
@@ -81,6 +201,30 @@ void output_commandline_args()
        << "number of trials that go by before starting the sample" << endl
        << setw(20) << left << "     -t #"
        << "time out" << endl
+       << setw(20) << left << "     -j #"
+       << "number of solver threads to run as a portfolio (CNF only)" << endl
+       << setw(20) << left << "     -k #"
+       << "cube and conquer: split into about # cubes and solve them on the -j threads (CNF only)" << endl
+       << setw(20) << left << "     -w #"
+       << "longest learned clause shared between portfolio solvers (0 is no sharing)" << endl
+       << setw(20) << left << "     -g #"
+       << "most decision levels (lbd) a shared learned clause may span" << endl
+       << setw(20) << left << "     -n #"
+       << "most ground literals the hybrid clause set (-c 4) keeps" << endl
+       << setw(20) << left << "     -q #"
+       << "pbchaff restarts 0:Luby, 1:LBD moving averages, 2:none" << endl
+       << setw(20) << left << "     -p <file>"
+       << "write a proof of unsatisfiability, binary DRAT (CNF only) or VeriPB for pbchaff" << endl
+       << setw(20) << left << "     -v <fd|file>"
+       << "write progress reports and the final statistics as JSON lines to a file descriptor or file" << endl
+       << setw(20) << left << "     -x #"
+       << "conflicts between progress reports (0 for no limit, default 10000)" << endl
+       << setw(20) << left << "     -y #"
+       << "seconds between progress reports (0 for no limit, default 10)" << endl
+       << setw(20) << left << "     -P #"
+       << "1 simplifies plain CNFs (-c 0) before search (off by default)" << endl
+       << setw(20) << left << "     -R #"
+       << "1 renumbers the variables of plain CNFs (-c 0) breadth first for memory locality" << endl
        << setw(20) << left << "     -i <file>"
        << "file to read branch decisions from" << endl
        << setw(20) << left << "     -l"
@@ -109,6 +253,18 @@ void read_testing_params(int argc, char **argv)
       case 'b' : ++i; global_vars.symres_bound = atoi(argv[i]); break;
       case 's' : ++i; sample_start_count = atoi(argv[i]); global_vars.dpll = true; break;
       case 't' : ++i; global_vars.time_out = atof(argv[i]); break;
+      case 'j' : ++i; global_vars.number_threads = atoi(argv[i]); break;
+      case 'k' : ++i; global_vars.number_cubes = atoi(argv[i]); break;
+      case 'w' : ++i; global_vars.share_size_bound = atoi(argv[i]); break;
+      case 'g' : ++i; global_vars.share_lbd_bound = atoi(argv[i]); break;
+      case 'n' : ++i; global_vars.ground_cache_budget = atoi(argv[i]); break;
+      case 'q' : ++i; global_vars.restart_policy = atoi(argv[i]); break;
+      case 'p' : ++i; global_vars.proof_file = argv[i]; break;
+      case 'v' : ++i; open_progress(argv[i]); break;
+      case 'x' : ++i; global_vars.progress_conflicts = atol(argv[i]); break;
+      case 'y' : ++i; global_vars.progress_seconds = atof(argv[i]); break;
+      case 'P' : ++i; global_vars.preprocess = atoi(argv[i]); break;
+      case 'R' : ++i; global_vars.renumber = atoi(argv[i]); break;
       case 'c' : ++i; global_vars.desired_type = (ClauseSetType)(atoi(argv[i])); break;
       case 'i' : ++i; branch_file_in = argv[i]; break;
       case 'o' : ++i; branch_file_out = argv[i]; break;
@@ -128,6 +284,7 @@ void read_testing_params(int argc, char **argv)
   
   if (branch_file_in.length()) branch_in.open(branch_file_in.c_str());
   if (branch_file_out.length()) branch_out.open(branch_file_out.c_str());
+  schedule_progress();
 }
 
 
@@ -135,8 +292,16 @@ void read_testing_params(int argc, char **argv)
 InputTheory parse_input(int argc, char **argv)
 {
   read_testing_params(argc,argv);
-  string input_filename = argv[1];
-  yyin = open_file(input_filename);
+  return parse_file(argv[1]);
+}
+
+
+
+InputTheory parse_file(const string& name)
+{
+  PhaseTimer timer(global_vars.phase_time[PHASE_PARSE]);
+  yyin = open_file(name);
+  if (yyin == NULL) quit("can't open " + name);
 
   yyparse();
 
@@ -145,9 +310,40 @@ InputTheory parse_input(int argc, char **argv)
 
 
 
+// plain DIMACS files skip the general parser, see DimacsReader.h
+bool use_dimacs_reader(const string& name)
+{
+  ClauseSetType t = global_vars.desired_type;
+  return (t == CNF || t == NOT_SPECIFIED) && DimacsReader::is_dimacs(input_file_name(name));
+}
+
+
+
+void read_dimacs(const string& name, Cnf& cnf)
+{
+  PhaseTimer timer(global_vars.phase_time[PHASE_PARSE]);
+  DimacsReader reader(input_file_name(name));
+  reader.read(cnf);
+  if (reader.has_empty_clause()) {   // nothing to solve
+	cout << "// " << name << " has an empty clause" << endl;
+	global_vars.result = UNSAT;
+	output_result(UNSAT);
+	exit(0);
+  }
+}
+
+
+
 Cnf read_cnf(int argc, char **argv)
 {
-  InputTheory input = parse_input(argc,argv);
+  read_testing_params(argc,argv);
+  if (use_dimacs_reader(argv[1])) {
+	Cnf cnf;
+	read_dimacs(argv[1],cnf);
+	return cnf;
+  }
+  InputTheory input = parse_file(argv[1]);
+  PhaseTimer timer(global_vars.phase_time[PHASE_CONVERT]);
   ClauseSetBuilder builder(input);
   builder.convert_to(CNF);
   return builder.get_cnf();
@@ -188,6 +384,23 @@ void output_up_stats()
        << setw(20) << left << global_vars.clauses_touched
        << setw(20) << left << time
        << setw(20) << left << (time > 0 ? global_vars.clauses_touched/time : 0.0) << endl;
+
+  double wall = round_time(sample_finish_wall - sample_start_wall);
+  cout << setw(20) << left << "wall time"
+       << setw(20) << left << "queue pops"
+       << setw(20) << left << "pops/wall time" << endl;
+  cout << setw(20) << left << wall
+       << setw(20) << left << global_vars.queue_pops
+       << setw(20) << left << global_vars.queue_pops/wall << endl;
+
+  if (sample_counters.any_available()) {  // hardware counters over the sample, if we could get them
+	for (size_t i=0; i < NUMBER_PERF_EVENTS; i++)
+	  if (sample_counters.available((PerfEvent)i)) cout << setw(20) << left << PerfCounters::name((PerfEvent)i);
+	cout << endl;
+	for (size_t i=0; i < NUMBER_PERF_EVENTS; i++)
+	  if (sample_counters.available((PerfEvent)i)) cout << setw(20) << left << sample_counters.count((PerfEvent)i);
+	cout << endl;
+  }
   
   cout << "**********************************************************************************************" << endl;
 }
@@ -216,8 +429,38 @@ void output_solver_stats()
        << setw(20) << left << global_vars.literals_touched
 	   << setw(20) << left << global_vars.prop_from_nogoods
 	   << setw(20) << left << global_vars.number_backtracks << endl;
+
+  cout << setw(20) << left << "time in";
+  for (size_t i=0; i < NUMBER_PHASES; i++) cout << setw(20) << left << phase_name((SolverPhase)i);
+  cout << endl << setw(20) << left << "";
+  // not rounded: round_time would turn a phase that never ran into 0.0001 like everything else
+  for (size_t i=0; i < NUMBER_PHASES; i++) cout << setw(20) << left << global_vars.phase_time[i];
+  cout << endl;
+
+  if (global_vars.learned_sizes.count()) {
+	cout << setw(20) << left << "learned clauses"
+		 << setw(20) << left << "mean size"
+		 << setw(20) << left << "max size"
+		 << setw(20) << left << "mean backjump"
+		 << setw(20) << left << "max backjump" << endl;
+	cout << setw(20) << left << global_vars.learned_sizes.count()
+		 << setw(20) << left << global_vars.learned_sizes.mean()
+		 << setw(20) << left << global_vars.learned_sizes.max()
+		 << setw(20) << left << global_vars.backjump_distances.mean()
+		 << setw(20) << left << global_vars.backjump_distances.max() << endl;
+  }
+
+  if (global_vars.number_threads > 1) {
+	cout << setw(20) << left << "shared exported"
+		 << setw(20) << left << "shared imported"
+		 << setw(20) << left << "shared useful" << endl;
+	cout << setw(20) << left << global_vars.shared_exported
+		 << setw(20) << left << global_vars.shared_imported
+		 << setw(20) << left << global_vars.shared_useful << endl;
+  }
   
   cout << "********************************************************************************************" << endl;
+  output_progress("final");
 }
 
 
@@ -1,4 +1,6 @@
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <set>
 #include <vector>
@@ -47,7 +49,7 @@ int main(int argc, char* argv[] ) {
   while (num_complete > 0)
     {
       // randomly pick one of the remaining grid squares
-      size_t index = rand() & (grid_squares.size()-1);
+      size_t index = rand() % grid_squares.size();
       size_t square = grid_squares[index];
       grid_squares.erase(remove(grid_squares.begin(),grid_squares.end(),square),grid_squares.end());
       --num_complete;
@@ -71,7 +73,7 @@ int main(int argc, char* argv[] ) {
 	}
       
       // randomly pick a color
-      index = rand() & (allowed.size() - 1);
+      index = rand() % allowed.size();
       
       // set the color in the grid
       grid[i][j] = allowed[index];
@@ -100,7 +102,7 @@ int main(int argc, char* argv[] ) {
 	}
     }
   
-  return 1;
+  return 0;
   
 }
 
@@ -0,0 +1,129 @@
+#ifndef _ACTIVITY_HEAP_H
+#define _ACTIVITY_HEAP_H
+
+#include <vector>
+#include "Asserts.h"
+
+
+
+/***************************************************************/
+/*
+
+   CLASS: ActivityHeap
+
+   PURPOSE: To keep the atoms ordered by their VSIDS activity so the
+   branch heuristic can find the most active unvalued atom in
+   O(log n) instead of sorting every atom and scanning from the top.
+
+   IMPLEMENTATION: A binary max heap of atom ids in m_heap with
+   m_position giving each atom's index in it, or -1 if it isn't
+   there.  The activities belong to the Solver and we only keep a
+   pointer to them.  Activities only ever go up between rescalings,
+   and rescaling every activity by the same factor doesn't change
+   the order, so update only has to move an atom up.
+
+   The Solver removes atoms lazily.  An atom stays in the heap when
+   it gets a value and is thrown out when it reaches the top, and
+   every atom that loses its value is put back.
+
+********************************************************************/
+
+
+class ActivityHeap
+{
+  std::vector<int> m_heap;
+  std::vector<int> m_position;
+  const std::vector<double>* m_activity;
+
+  bool bigger(int a1, int a2) const { return (*m_activity)[a1] > (*m_activity)[a2]; }
+  inline void percolateUp(int);
+  inline void percolateDown(int);
+
+ public:
+
+  ActivityHeap() : m_activity(NULL) {}
+
+  inline void initialize(std::size_t capacity, const std::vector<double>* activity);
+
+  bool empty() const { return m_heap.empty(); }
+  std::size_t size() const { return m_heap.size(); }
+  bool contains(int atom) const { return m_position[atom] >= 0; }
+  int top() const { return m_heap[0]; }
+
+  inline void insert(int atom);
+  inline int removeTop();
+  void update(int atom) { if (contains(atom)) percolateUp(m_position[atom]); }
+};
+
+
+
+/*************************** INLINES ***************************/
+
+
+inline void ActivityHeap::initialize(std::size_t capacity, const std::vector<double>* activity)
+{
+  m_heap.clear();
+  m_heap.reserve(capacity);
+  m_position.assign(capacity,-1);
+  m_activity = activity;
+}
+
+
+inline void ActivityHeap::insert(int atom)
+{
+  if (contains(atom)) return;
+  m_position[atom] = m_heap.size();
+  m_heap.push_back(atom);
+  percolateUp(m_heap.size() - 1);
+}
+
+
+inline int ActivityHeap::removeTop()
+{
+  ASSERT(!empty());
+  int atom = m_heap[0];
+  m_heap[0] = m_heap.back();
+  m_position[m_heap[0]] = 0;
+  m_position[atom] = -1;
+  m_heap.pop_back();
+  if (m_heap.size() > 1) percolateDown(0);
+  return atom;
+}
+
+
+inline void ActivityHeap::percolateUp(int i)
+{
+  int atom = m_heap[i];
+  while (i > 0)
+    {
+      int parent = (i - 1) >> 1;
+      if (!bigger(atom,m_heap[parent])) break;
+      m_heap[i] = m_heap[parent];
+      m_position[m_heap[i]] = i;
+      i = parent;
+    }
+  m_heap[i] = atom;
+  m_position[atom] = i;
+}
+
+
+inline void ActivityHeap::percolateDown(int i)
+{
+  int atom = m_heap[i];
+  int size = m_heap.size();
+  while (2 * i + 1 < size)
+    {
+      int child = 2 * i + 1;
+      if (child + 1 < size && bigger(m_heap[child + 1],m_heap[child])) child++;
+      if (!bigger(m_heap[child],atom)) break;
+      m_heap[i] = m_heap[child];
+      m_position[m_heap[i]] = i;
+      i = child;
+    }
+  m_heap[i] = atom;
+  m_position[atom] = i;
+}
+
+
+
+#endif
@@ -9,6 +9,7 @@
 #ifndef _CLAUSE_H
 #define _CLAUSE_H
 
+#include <cstddef>
 #include "PartialAssignment.h"
 #include "ImplicationList.h"
 #include "FastClause.h"
@@ -49,6 +50,9 @@
 
 	     markUnused - mark a clause as deleted.
 
+	     markPermanent - a constraint added through the incremental
+	     interface (see Solver.h).  Never deleted as irrelevant.
+
 	     **********************************************************
 	     
 	     These functions are used in memory management when clauses
@@ -67,7 +71,7 @@
 
              size - bits 2 and up.
 	     inUse - bit 1
-	     Unused flag - bit 0.
+	     permanent - bit 0.
 
 	     
 **********************************************************************/
@@ -89,6 +93,7 @@ public:
   
   std::size_t size() const { return m_sizeAndFlags >> 2; }
   bool inUse() const { return m_sizeAndFlags & 2; }
+  bool isPermanent() const { return m_sizeAndFlags & 1; }
   std::size_t getRequired() const { return m_required; }
   const PoolLiteral& getReadLiteral(int i) const { return m_firstLiteral[i]; }
   int getAtom(int i) const { return m_firstLiteral[i].getAtom(); }
@@ -100,9 +105,10 @@ public:
 
   inline void initialize(PoolLiteral *p, std::size_t r, std::size_t n); 
   void markUnused() { m_sizeAndFlags &= ~2 ; }
+  void markPermanent() { m_sizeAndFlags |= 1; }
   PoolLiteral& getWriteLiteral(int i) { return m_firstLiteral[i]; }
   void setFirst(PoolLiteral *plp) { m_firstLiteral = plp; }
-  void incFirst(int i) { m_firstLiteral += i; }
+  void incFirst(std::ptrdiff_t i) { m_firstLiteral += i; }
   PoolLiteral * getFirst() { return m_firstLiteral; }
 };
 
@@ -145,6 +151,7 @@ public:
   
   std::size_t size() const { return m_sizeAndFlags >> 2; }
   bool inUse() const { return m_sizeAndFlags & 2; }
+  bool isPermanent() const { return m_sizeAndFlags & 1; }
   std::size_t getRequired() const { return m_required; }
   const PoolPBLiteral& getReadLiteral(int i) const { return m_firstLiteral[i]; }
   int getAtom(int i) const { return m_firstLiteral[i].getAtom(); }
@@ -157,9 +164,10 @@ public:
 
   inline void initialize(PoolPBLiteral *p, std::size_t r, std::size_t n);
   void markUnused() { m_sizeAndFlags &= ~2 ; }
+  void markPermanent() { m_sizeAndFlags |= 1; }
   PoolPBLiteral& getWriteLiteral(int i) { return m_firstLiteral[i]; }
   void setFirst(PoolPBLiteral *plp) { m_firstLiteral = plp; }
-  void incFirst(int i) { m_firstLiteral += i; }
+  void incFirst(std::ptrdiff_t i) { m_firstLiteral += i; }
   PoolPBLiteral * getFirst() { return m_firstLiteral; }
 };
 
@@ -195,7 +203,7 @@ public:
   void markUnused() { m_sizeAndFlags &= ~2 ; }
   PoolLiteral& getWriteLiteral(int i) { return m_firstLiteral[i]; }
   void setFirst(PoolLiteral *plp) { m_firstLiteral = plp; }
-  void incFirst(int i) { m_firstLiteral += i; }
+  void incFirst(std::ptrdiff_t i) { m_firstLiteral += i; }
   PoolLiteral * getFirst() { return m_firstLiteral; }
 };
 
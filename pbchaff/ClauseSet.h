@@ -102,6 +102,7 @@ class ClauseSet {
   inline const Conflict& getConflict() const;
   // check out a copy of a clause
   inline void initializeClause(FastClause&, ClauseID) const;
+  inline bool getBinaryReason(ClauseID, int, Literal&) const;
   inline int getLiteralCount(Literal l) const;
   inline bool initialClauseCheck(ImplicationList&) const;
   inline const StackOfLists& getOverSatClauses() const;
@@ -118,6 +119,7 @@ class ClauseSet {
   inline void unwind(Literal l);
 
   inline ClauseID addClause(FastClause& atoms);
+  inline void markPermanent(ClauseID);
   inline void deleteIrrelevantClauses();
   inline void removeClause(ClauseID);
 
@@ -166,6 +168,12 @@ inline void ClauseSet::initializeClause(FastClause& c, ClauseID id) const {
   }
 }
 
+// only the LazyClauseSet keeps binary clauses
+inline bool ClauseSet::getBinaryReason(ClauseID id, int atom, Literal& other) const {
+  if (id % 3 != LAZY) return false;
+  return m_lazyClauses.getBinaryReason(id / 3, atom, other);
+}
+
 inline const ClauseSetStatistics& ClauseSet::getStatistics() {
   const ClauseSetStatistics& lazyStats = m_lazyClauses.getStatistics();
   const ClauseSetStatistics& PBStats = m_PBClauses.getStatistics();
@@ -245,6 +253,20 @@ inline ClauseID ClauseSet::addClause(FastClause& atoms) {
   return 3 * m_lazyClauses.addClause(atoms);
 }
 
+// constraints added between calls to Solver::solve must never be deleted
+inline void ClauseSet::markPermanent(ClauseID id) {
+  switch (id % 3) {
+    case LAZY:
+      m_lazyClauses.markPermanent(id / 3);
+      break;
+    case PB:
+      m_PBClauses.markPermanent(id / 3);
+      break;
+    default:
+      fatalError("markPermanent not supported in ClauseSet::markPermanent");
+  }
+}
+
 inline void ClauseSet::initialize(const PartialAssignment* pa) {
   m_assignment = pa;
   m_PBClauses.initialize(pa);
@@ -287,6 +309,7 @@ inline void ClauseSet::unwind(Literal l) {
   m_overSatClauses.popTopList();
   m_lazyClauses.unwind(l);
   m_PBClauses.unwind(l);
+  m_mod2Clauses.unwind(l);
 }
 
 inline void ClauseSet::reduceCounts() {
@@ -303,7 +326,7 @@ inline void ClauseSet::getWhyOverSat(FastClause& c, AtomValueMap& whyLits,
     int atom = m_satLits.getAtom(i);
     int id = m_assignment->getReason(atom);
     if (id == 0)
-      whyLits.addAtom(atom, m_satLits.getValue(atom));
+      whyLits.addAtom(atom, -m_satLits.getValue(atom));  // the decision is the negation of a why literal
     else {
       int whichSet = id % 3;
       if (whichSet != MOD2) reasons.push_back(atom);
@@ -55,27 +55,32 @@ void FastClause::add(const FastClause &f) {
   for (size_t i = 0; i < f.size(); ++i) {
     a = f.getAtom(i);
     v = f.getValue(a);
-    if (v) {
-      if (!(m_value[a])) addAtom(a,v);
+    if (v) addLiteral(a,v);
+  }	
+}
+
+
+/** Add the single weighted literal v*a.  The required field has
+    already been taken care of by the caller. */
+void FastClause::addLiteral(int a, int v) {
+  if (!(m_value[a])) addAtom(a,v);
+  else {
+    /// no cancellation
+    if ((v < 0) == (m_value[a] < 0)) increment(a,v);
+    else {
+      /// complete cancellation
+      if (-v == m_value[a]) {
+	remove(a);
+	m_required -= abs(v);
+      }
       else {
-	/// no cancellation
-	if ((v < 0) == (m_value[a] < 0)) increment(a,v);
-	else {
-	  /// complete cancellation
-	  if (-v == m_value[a]) {
-	    remove(a);
-	    m_required -= abs(v);
-	  }
-	  else {
-	    /// partial cancellation
-	    if (abs(v) < abs(m_value[a])) m_required -= abs(v);
-	    else m_required -= abs(m_value[a]);
-	    increment(a,v);
-	  }
-	}
+	/// partial cancellation
+	if (abs(v) < abs(m_value[a])) m_required -= abs(v);
+	else m_required -= abs(m_value[a]);
+	increment(a,v);
       }
     }
-  }	
+  }
 }
 
 
@@ -110,6 +115,23 @@ void FastClause::resolve(FastClause &f, int a) {
 
 
 
+/** Resolve with the binary clause (!x v l) where x is the literal
+    on atom a in *this.  This is what resolve() would do with a
+    FastClause holding the binary clause scaled by the weight of a,
+    but we don't have to build it. */
+void FastClause::resolveBinary(int a, Literal l) {
+
+  int weight = abs(getValue(a));
+  ASSERT(weight != 0);
+
+  /// a cancels completely, leaving the required field unchanged
+  remove(a);
+  addLiteral(l.getAtom(),(l.getSign() ? weight : -weight));
+}
+
+
+
+
 void FastClause::divideQuick(int divisor)
 {
   int weight;
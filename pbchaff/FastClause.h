@@ -53,6 +53,8 @@ class FastClause : public AtomValueMap {
   int m_possible;
   int m_current;
   int m_flags;
+
+  void addLiteral(int, int);
   
  public:                   
   
@@ -93,6 +95,7 @@ class FastClause : public AtomValueMap {
   void setRequired(int i) { m_required = i; }
   void incRequired(int i) { m_required += i; }
   void setMod2() { m_flags |= 1; }
+  void clearMod2() { m_flags &= ~1; }
 
   inline void multiply(int i);
   void divideQuick(int);
@@ -100,6 +103,7 @@ class FastClause : public AtomValueMap {
   void add(const FastClause &);
   
   void resolve(FastClause&, int);
+  void resolveBinary(int, Literal);
   /* almost all of these FastClause functions assume
      that a constraint has been simplified */
   void simplify();
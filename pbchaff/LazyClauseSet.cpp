@@ -5,9 +5,11 @@
 ***********************************/
 
 #include "LazyClauseSet.h"
+#include "TouchCounter.h"
+#include <cstring>
 using namespace std;
 
-LazyClauseSet::LazyClauseSet() : m_assignment(0)
+LazyClauseSet::LazyClauseSet() : m_firstLearnedID(1), m_assignment(0)
 { 
   m_poolBegin = new PoolLiteral[STARTUP_LIT_POOL_SIZE];
   m_poolEnd = m_poolBegin;
@@ -29,6 +31,7 @@ void LazyClauseSet::initialize(const PartialAssignment* ptr)
   for (size_t i=0; i <= numberVariables; ++i)
     {
       m_watchedLitIndex.push_back(Watchers());
+      m_binaryLitIndex.push_back(BinaryIndex());
       m_idLitIndex.push_back(LitIndex());
       m_scrapPaper.push_back(0);
       m_literalCounts[0].push_back(0);
@@ -122,7 +125,7 @@ bool LazyClauseSet::enlargePool()
   m_poolEndStorage = m_poolBegin + newSize;
   memcpy(m_poolBegin,oldBegin,(oldEnd - oldBegin) * sizeof(PoolLiteral));
   m_poolEnd = m_poolBegin + (oldEnd - oldBegin);
-  int offset = m_poolBegin - oldBegin;
+  std::ptrdiff_t offset = m_poolBegin - oldBegin;
 
   // update pointers into pool
   vector<Clause>::iterator it = m_clauses.begin();
@@ -155,6 +158,7 @@ bool LazyClauseSet::enlargePool()
 void LazyClauseSet::removeClause(int id)
 {
   Clause& c = m_clauses[id];
+  if (isBinary(c)) removeBinaryImplications(id);
   c.markUnused();
   int size = c.size();
   for (int i = 0; i < size; i++)
@@ -195,7 +199,6 @@ ClauseID LazyClauseSet::addClause(FastClause &atoms)
 {
   
   int newID;
-  size_t numberLits = atoms.size();
 
   // make sure there is space in the pool
   while (getPoolFreeSpace() <= atoms.size() + 1) 
@@ -247,6 +250,28 @@ ClauseID LazyClauseSet::addClause(FastClause &atoms)
 
   // if the clause is unit return
   if (c.size() == c.getRequired()) return newID;
+
+  if (isBinary(c)) addBinaryImplications(newID);
+  else setWatchers(newID,atoms);
+  
+  // add to fullIndex
+  if (m_settings.strengthenOn)
+    {
+      computeCounts(newID);
+      
+      for (size_t i=0; i < c.size(); ++i)
+	{
+	  const PoolLiteral &pl = c.getReadLiteral(i);
+	  m_idLitIndex[pl.getAtom()].getIndex(pl.getSign()).push_back(newID);
+	}
+    }
+  return newID;
+}
+
+void LazyClauseSet::setWatchers(ClauseID id, FastClause &atoms)
+{
+  Clause &c = m_clauses[id];
+  size_t numberLits = c.size();
   
   //set the watched literals
   // calculate number of watchers needed and
@@ -322,23 +347,41 @@ ClauseID LazyClauseSet::addClause(FastClause &atoms)
 	  if (stillNeeded == 0) break;
 	}
     }
+}
 
-  // add to fullIndex
-  if (m_settings.strengthenOn)
+
+void LazyClauseSet::addBinaryImplications(ClauseID id)
+{
+  Clause &c = m_clauses[id];
+  Literal l0(c.getAtom(0),c.getSign(0));
+  Literal l1(c.getAtom(1),c.getSign(1));
+  m_binaryLitIndex[l0.getAtom()].getIndex(l0.getSign()).push_back(BinaryImplication(l1,id));
+  m_binaryLitIndex[l1.getAtom()].getIndex(l1.getSign()).push_back(BinaryImplication(l0,id));
+}
+
+
+void LazyClauseSet::removeBinaryImplications(ClauseID id)
+{
+  Clause &c = m_clauses[id];
+  for (size_t i=0; i < 2; ++i)
     {
-      computeCounts(newID);
-      
-      for (size_t i=0; i < c.size(); ++i)
-	{
-	  const PoolLiteral &pl = c.getReadLiteral(i);
-	  m_idLitIndex[pl.getAtom()].getIndex(pl.getSign()).push_back(newID);
-	}
+      vector<BinaryImplication> &index = m_binaryLitIndex[c.getAtom(i)].getIndex(c.getSign(i));
+      for (size_t j=0, size=index.size(); j < size; ++j)
+	if (index[j].id == id)
+	  {
+	    index[j] = index[size - 1];
+	    index.pop_back();
+	    break;
+	  }
     }
-  return newID;
 }
 
+
 /*
-  We walk through all clauses that are watching the literal l.
+  Binary clauses containing the negation of l are handled first.
+  Each one implies its other literal directly.
+
+  Then we walk through all clauses that are watching the literal l.
 
   For each clause we begin at the watched literal
   and we walk in the specified direction. When we hit an end
@@ -358,8 +401,33 @@ ClauseID LazyClauseSet::addClause(FastClause &atoms)
 
 bool LazyClauseSet::getImplications(Literal l, ImplicationList& units)
 {
+  zap::TouchCounter touched;
   int atom = l.getAtom();
   bool sign = l.getSign();
+
+  vector<BinaryImplication>& binaries = m_binaryLitIndex[atom].getIndex(!sign);
+  vector<BinaryImplication>::iterator bit = binaries.begin();
+  vector<BinaryImplication>::iterator bend = binaries.end();
+  for ( ; bit != bend; ++bit)
+    {
+      Literal other = bit->other;
+      int a = other.getAtom();
+      if (m_assignment->isValued(a)) continue;
+      touched.clause();
+#ifdef VERIFY
+      verifyReason(other,bit->id);
+#endif
+      if (units.contains(other.getNegation()))
+	{
+	  m_conflict.atom = a;
+	  m_conflict.reason1 = bit->id * 3;
+	  m_conflict.reason2 = units.getReason(a);
+	  return false;
+	}
+      if (!units.contains(other) || betterClause(bit->id,units.getReason(a)))
+	units.push(other,bit->id * 3);
+    }
+  
   vector<PoolLiteral*>& watched = m_watchedLitIndex[atom].getWatchers(!sign);
   vector<PoolLiteral*>::iterator it = watched.begin();
 
@@ -370,6 +438,7 @@ bool LazyClauseSet::getImplications(Literal l, ImplicationList& units)
 
       // don't bother if the clause isn't in use
       if (ptr->isNull()) continue;
+      touched.clause();
       
       int dir = (watchedLit->getDirection() ? 1 : -1);
       ClauseID clauseID = -1;
@@ -497,12 +566,12 @@ void LazyClauseSet::deleteIrrelevantClauses()
   // delete the clauses
   size_t oldDeletedClauseCount = m_statistics.deletedClauseCount;
   size_t nc = m_clauses.size();
-  size_t ic = m_statistics.initialClauseCount + 1;
+  size_t ic = m_firstLearnedID;
   for (size_t i=ic; i < nc; ++i)
     {
       Clause &c = m_clauses[i];
       size_t size = c.size() - c.getRequired();
-      if (!c.inUse() || size < m_settings.lengthBound) continue;
+      if (!c.inUse() || c.isPermanent() || size < m_settings.lengthBound) continue;
       int possible = - c.getRequired();
       for (size_t j=0; j < c.size(); j++)
 	{
@@ -34,6 +34,26 @@ class LitIndex
     }
 };
 
+// a binary clause seen from one of its literals. other is the
+// remaining literal, the one that is implied when the first is falsified.
+class BinaryImplication
+{
+ public:
+  Literal other;
+  ClauseID id;
+  BinaryImplication(Literal l, ClauseID i) : other(l), id(i) {}
+};
+
+// simple struct to hold binary clauses by literal
+class BinaryIndex
+{
+ public:
+  std::vector<BinaryImplication> index[2];
+  std::vector<BinaryImplication>& getIndex(bool b)
+    {
+      return (b ? index[0] : index[1]);
+    }
+};
 
 /********************************************************************/
 /**
@@ -59,6 +79,10 @@ class LitIndex
    subsets of clauses that contain a specific literal.  This is
    needed for determining unit implications quickly.  The indexing
    scheme used here is the watched literal implementation of zchaff.
+   Binary clauses aren't watched.  Each literal keeps a list of the
+   binary clauses it appears in together with the other literal of
+   the clause, so propagating a binary clause never looks at the pool.
+   These lists are scanned before the watched literals.
    I've also added a count based index.  This is for use in
    strengthening.  The maintenance of this structure can be turned
    off when not in use to improve performance.  
@@ -76,10 +100,12 @@ class LazyClauseSet
   PoolLiteral* m_poolEndStorage;
 
   std::vector<Watchers> m_watchedLitIndex;
+  std::vector<BinaryIndex> m_binaryLitIndex;
   std::vector<LitIndex> m_idLitIndex;
   std::vector<Clause> m_clauses;
   std::vector<int> m_currentCount;
   std::queue<ClauseID> m_unusedIDs;
+  std::size_t m_firstLearnedID;         // ids below this are never deleted as irrelevant
   const PartialAssignment* m_assignment; // pointer to current assignment
 
   // temp object that I just reuse for speed
@@ -105,6 +131,12 @@ class LazyClauseSet
   inline bool isUNSAT(const PoolLiteral*) const ;
   inline bool isSAT(const PoolLiteral*) const ;
 
+  // watched literals and binary clause lists
+  void setWatchers(ClauseID, FastClause&);
+  void addBinaryImplications(ClauseID);
+  void removeBinaryImplications(ClauseID);
+  bool isBinary(const Clause& c) const { return c.size() == 2 && c.getRequired() == 1; }
+  
   // maintain counts
   void computeCounts(ClauseID);
   inline void incCurrent(Literal,StackOfLists&);
@@ -130,6 +162,7 @@ public:
   inline int getLiteralCount(Literal l) const;
   bool initialClauseCheck(ImplicationList&) const;
   inline void getUnfavorables(int, AtomValueMap&) const;
+  inline bool getBinaryReason(ClauseID, int, Literal&) const;
   
   // data-structure verification
   void verifyReason(Literal,ClauseID) const;
@@ -141,6 +174,7 @@ public:
   //*********************** WRITE ********************************
   
   ClauseID addClause(FastClause &atoms);
+  void markPermanent(ClauseID id) { m_clauses[id].markPermanent(); }
   void removeClause(int);
   void deleteIrrelevantClauses();
    
@@ -173,6 +207,7 @@ inline void LazyClauseSet::setInitialClauseCount()
     m_statistics.addedClauseCount -
     m_statistics.deletedClauseCount;
   m_statistics.initialClauseCount = count;
+  m_firstLearnedID = m_clauses.size();   // preprocessing may have left holes below it
   m_statistics.addedClauseCount = 0;
   m_statistics.deletedClauseCount = 0;
 }
@@ -181,6 +216,7 @@ inline void LazyClauseSet::setInitialClauseCount()
 inline void LazyClauseSet::deleteClause(ClauseID id)
 {
   Clause &c = m_clauses[id];
+  if (isBinary(c)) removeBinaryImplications(id);
   c.markUnused();
   int size = c.size();
   for (int i = 0; i < size; ++i)
@@ -201,6 +237,7 @@ inline std::size_t LazyClauseSet::estimateMemoryUsage() const
 {
   return sizeof(PoolLiteral) * (getPoolSize() + getPoolFreeSpace()) +
     sizeof(Watchers) * m_watchedLitIndex.capacity() +
+    sizeof(BinaryIndex) * m_binaryLitIndex.capacity() +
     sizeof(Clause) * m_clauses.capacity() +
     sizeof(int) * m_unusedIDs.size();
 }
@@ -306,4 +343,16 @@ inline void LazyClauseSet::getUnfavorables(int id, AtomValueMap& unfaves) const
     }
 }
 
+// if clause id is a binary clause, put the literal other than the
+// one on atom in other.  Conflict analysis uses this to resolve on
+// binary reasons without building a FastClause.
+inline bool LazyClauseSet::getBinaryReason(ClauseID id, int atom, Literal& other) const
+{
+  const Clause &c = m_clauses[id];
+  if (!isBinary(c)) return false;
+  int i = ((int)c.getAtom(0) == atom ? 1 : 0);
+  other = Literal(c.getAtom(i),c.getSign(i));
+  return true;
+}
+
 #endif
@@ -5,10 +5,18 @@
 ***********************************/
 
 #include "Mod2ClauseSet.h"
+#include "TouchCounter.h"
+#include <cstring>
 #include <iostream>
 using namespace std;
 
-Mod2ClauseSet::Mod2ClauseSet() : m_assignment(0)
+Mod2ClauseSet::Mod2ClauseSet() :
+  m_firstLearnedID(1),
+  m_assignment(0),
+  m_matrixBuilt(false),
+  m_inconsistent(false),
+  m_words(0),
+  m_numberRows(0)
 { 
   m_poolBegin = new PoolLiteral[STARTUP_LIT_POOL_SIZE];
   m_poolEnd = m_poolBegin;
@@ -26,12 +34,15 @@ void Mod2ClauseSet::initialize(const PartialAssignment* ptr)
   m_clauses[0].initialize(0,0,0);
   m_currentSumMod2.push_back(false);
   m_unvaluedCount.push_back(0);
+  m_reasonRow.push_back(-1);
   
   size_t numberVariables = m_assignment->getNumberVariables();
   for (size_t i=0; i <= numberVariables; ++i)
     {
       m_literalIndex.push_back(vector<int>());
+      m_column.push_back(-1);
     }
+  m_explanation.initialize(numberVariables + 1);
 }
 
 
@@ -105,7 +116,7 @@ bool Mod2ClauseSet::enlargePool()
   m_poolEndStorage = m_poolBegin + newSize;
   memcpy(m_poolBegin,oldBegin,(oldEnd - oldBegin) * sizeof(PoolLiteral));
   m_poolEnd = m_poolBegin + (oldEnd - oldBegin);
-  int offset = m_poolBegin - oldBegin;
+  std::ptrdiff_t offset = m_poolBegin - oldBegin;
 
   // update pointers into pool
   vector<Mod2Clause>::iterator it = m_clauses.begin();
@@ -140,6 +151,7 @@ ClauseID Mod2ClauseSet::addClause(FastClause &atoms)
       m_clauses.resize(newID + 1);
       m_unvaluedCount.push_back(0);
       m_currentSumMod2.push_back(0);
+      m_reasonRow.push_back(-1);
     }
   else
     {
@@ -175,6 +187,7 @@ ClauseID Mod2ClauseSet::addClause(FastClause &atoms)
 
 bool Mod2ClauseSet::getImplications(Literal l, ImplicationList& units)
 {
+  zap::TouchCounter touched;
   int atom = l.getAtom();
   vector<int>& watchers = m_literalIndex[atom];
   vector<int>::iterator it = watchers.begin();
@@ -185,6 +198,7 @@ bool Mod2ClauseSet::getImplications(Literal l, ImplicationList& units)
       int id = *it;
       if (m_unvaluedCount[id] == 1)
 	{
+	  touched.clause();
 	  Mod2Clause& c = m_clauses[id];
 	  for (size_t i=0; i < c.size(); ++i)
 	    {
@@ -208,6 +222,223 @@ bool Mod2ClauseSet::getImplications(Literal l, ImplicationList& units)
 	    }
 	}
     }
+
+  if (m_column[atom] == -1) return true;
+  return getMatrixImplications(m_column[atom],units);
+}
+
+
+
+/************************* GAUSSIAN ELIMINATION *************************/
+
+
+/* Copy the constraints into the matrix and put it in reduced row
+   echelon form.  Columns that aren't valued are preferred as pivots.
+   Rows that reduce to 0 = 0 are dropped and a row 0 = 1 means the
+   constraints are inconsistent.  Rows with a single column are added
+   as constraints so initialClauseCheck will find them.
+*/
+void Mod2ClauseSet::buildMatrix()
+{
+  m_matrixBuilt = true;
+
+  // number the columns
+  int numberColumns = 0;
+  size_t nc = m_clauses.size();
+  for (size_t i=1; i < nc; ++i)
+    {
+      const Mod2Clause &c = m_clauses[i];
+      if (!c.inUse()) continue;
+      for (size_t j=0; j < c.size(); ++j)
+	{
+	  int atom = c.getAtom(j);
+	  if (m_column[atom] == -1)
+	    {
+	      m_column[atom] = numberColumns++;
+	      m_columnAtom.push_back(atom);
+	    }
+	}
+    }
+  if (numberColumns == 0) return;
+
+  m_words = (numberColumns + 63) / 64;
+  m_valued.assign(m_words,0);
+  m_valuedTrue.assign(m_words,0);
+  m_pivotRow.assign(numberColumns,-1);
+  for (int col=0; col < numberColumns; ++col)
+    {
+      int atom = m_columnAtom[col];
+      if (!m_assignment->isValued(atom)) continue;
+      setBit(&m_valued[0],col);
+      if (m_assignment->getValue(atom)) setBit(&m_valuedTrue[0],col);
+    }
+
+  // one row per constraint
+  for (size_t i=1; i < nc; ++i)
+    {
+      const Mod2Clause &c = m_clauses[i];
+      if (!c.inUse()) continue;
+      m_rows.resize(m_rows.size() + m_words,0);
+      Word* row = getRow(m_numberRows);
+      for (size_t j=0; j < c.size(); ++j) setBit(row,m_column[c.getAtom(j)]);
+      m_rowSumMod2.push_back(c.getSumMod2());
+      m_rowReason.push_back(i);
+      m_reasonRow[i] = m_numberRows;
+      m_pivot.push_back(-1);
+      ++m_numberRows;
+    }
+
+  // gauss-jordan elimination
+  size_t r = 0;
+  while (r < m_numberRows)
+    {
+      Word* row = getRow(r);
+      int pivot = -1;
+      for (size_t w=0; w < m_words && pivot == -1; ++w)
+	if (row[w] & ~m_valued[w]) pivot = (w << 6) + __builtin_ctzll(row[w] & ~m_valued[w]);
+      for (size_t w=0; w < m_words && pivot == -1; ++w)
+	if (row[w]) pivot = (w << 6) + __builtin_ctzll(row[w]);
+
+      if (pivot == -1)
+	{
+	  // drop the row by moving the last row over it
+	  if (m_rowSumMod2[r]) m_inconsistent = true;
+	  forgetRowReason(r);
+	  size_t last = --m_numberRows;
+	  if (r != last)
+	    {
+	      memcpy(row,getRow(last),m_words * sizeof(Word));
+	      m_rowSumMod2[r] = m_rowSumMod2[last];
+	      m_rowReason[r] = m_rowReason[last];
+	      if (m_rowReason[r] != 0) m_reasonRow[m_rowReason[r]] = r;
+	      if (m_pivot[last] != -1) m_pivotRow[m_pivot[last]] = r;
+	      m_pivot[r] = m_pivot[last];
+	    }
+	  continue;
+	}
+
+      m_pivot[r] = pivot;
+      m_pivotRow[pivot] = r;
+      for (size_t j=0; j < m_numberRows; ++j)
+	if (j != r && testBit(getRow(j),pivot)) addRow(j,r);
+      ++r;
+    }
+  m_rows.resize(m_numberRows * m_words);
+  m_rowSumMod2.resize(m_numberRows);
+  m_rowReason.resize(m_numberRows);
+  m_pivot.resize(m_numberRows);
+
+  for (size_t i=0; i < m_numberRows; ++i)
+    {
+      const Word* row = getRow(i);
+      int count = 0;
+      for (size_t w=0; w < m_words; ++w) count += __builtin_popcountll(row[w]);
+      if (count == 1) getRowReason(i);
+    }
+}
+
+
+// row j += row r
+void Mod2ClauseSet::addRow(size_t j, size_t r)
+{
+  Word* to = getRow(j);
+  const Word* from = getRow(r);
+  for (size_t w=0; w < m_words; ++w) to[w] ^= from[w];
+  m_rowSumMod2[j] = (m_rowSumMod2[j] != m_rowSumMod2[r]);
+  forgetRowReason(j);
+}
+
+
+/* The pivot of row r was just valued.  Move the pivot to another
+   unvalued column of the row and eliminate that column from the
+   other rows.  If every column of the row is valued the pivot stays.
+*/
+void Mod2ClauseSet::pivotOn(size_t r, int oldPivot)
+{
+  const Word* row = getRow(r);
+  int pivot = -1;
+  for (size_t w=0; w < m_words; ++w)
+    if (row[w] & ~m_valued[w])
+      {
+	pivot = (w << 6) + __builtin_ctzll(row[w] & ~m_valued[w]);
+	break;
+      }
+  if (pivot == -1) return;
+
+  m_pivotRow[oldPivot] = -1;
+  m_pivotRow[pivot] = r;
+  m_pivot[r] = pivot;
+  for (size_t j=0; j < m_numberRows; ++j)
+    if (j != r && testBit(getRow(j),pivot)) addRow(j,r);
+}
+
+
+// get the ID of a constraint equal to row r, adding one if needed
+ClauseID Mod2ClauseSet::getRowReason(size_t r)
+{
+  if (m_rowReason[r] != 0) return m_rowReason[r];
+
+  m_explanation.clear();
+  const Word* row = getRow(r);
+  for (size_t w=0; w < m_words; ++w)
+    for (Word bits = row[w]; bits; bits &= bits - 1)
+      m_explanation.addAtom(m_columnAtom[(w << 6) + __builtin_ctzll(bits)],1);
+  m_explanation.setRequired(m_rowSumMod2[r]);
+  m_explanation.setMod2();
+
+  ClauseID id = addClause(m_explanation);
+  if (id == -1) return 0;
+  m_rowReason[r] = id;
+  m_reasonRow[id] = r;
+  return id;
+}
+
+
+/* column was just valued.  Fix the pivot if it was one and then look
+   for rows containing the column with one unvalued column left.
+*/
+bool Mod2ClauseSet::getMatrixImplications(int column, ImplicationList& units)
+{
+  if (m_pivotRow[column] != -1) pivotOn(m_pivotRow[column],column);
+
+  for (size_t r=0; r < m_numberRows; ++r)
+    {
+      const Word* row = getRow(r);
+      if (!testBit(row,column)) continue;
+
+      int count = 0;
+      int forcedColumn = -1;
+      bool sum = m_rowSumMod2[r];
+      for (size_t w=0; w < m_words && count < 2; ++w)
+	{
+	  Word unvalued = row[w] & ~m_valued[w];
+	  if (unvalued)
+	    {
+	      count += __builtin_popcountll(unvalued);
+	      forcedColumn = (w << 6) + __builtin_ctzll(unvalued);
+	    }
+	  sum ^= __builtin_popcountll(row[w] & m_valuedTrue[w]) & 1;
+	}
+      if (count != 1) continue;
+
+      // the forced atom makes the sum come out right
+      int forcedAtom = m_columnAtom[forcedColumn];
+      Literal l(forcedAtom,sum);
+      if (units.contains(l)) continue;
+      ClauseID id = getRowReason(r);
+      if (id == 0) continue;
+#ifdef VERIFY
+      verifyReason(l,id);
+#endif
+      if (units.contains(l.getNegation()))
+	{
+	  m_conflict.atom = forcedAtom;
+	  m_conflict.reason1 = (id * 3) + 2;
+	  m_conflict.reason2 = units.getReason(forcedAtom);
+	  return false;
+	}
+      units.push(l,(id * 3) + 2);
+    }
   return true;
 }
 
@@ -233,6 +464,7 @@ void Mod2ClauseSet::computeCounts(ClauseID id)
 
 bool Mod2ClauseSet::initialClauseCheck(ImplicationList &unitList) const
 {
+  if (m_inconsistent) return false;
   size_t nc = m_clauses.size();
   for (size_t i=1; i < nc; ++i)
     {
@@ -278,7 +510,7 @@ void Mod2ClauseSet::deleteIrrelevantClauses()
   // delete the clauses
   size_t oldDeletedClauseCount = m_statistics.deletedClauseCount;
   size_t nc = m_clauses.size();
-  size_t ic = m_statistics.initialClauseCount + 1;
+  size_t ic = m_firstLearnedID;
   for (size_t i=ic; i < nc; ++i)
     {
       size_t size = m_clauses[i].size();
@@ -286,8 +518,7 @@ void Mod2ClauseSet::deleteIrrelevantClauses()
       int unvaluedCount = m_unvaluedCount[i];
       if (unvaluedCount >= (int)(m_settings.relevanceBound))
 	deleteClause(i);
-      
-      if (size > m_settings.maxLength && (unvaluedCount > 0))
+      else if (size > m_settings.maxLength && (unvaluedCount > 0))
 	deleteClause(i);
     }
 
@@ -327,7 +558,11 @@ void Mod2ClauseSet::verifyReason(Literal l,ClauseID id)
 	  foundAtom = true;
 	  if (m_unvaluedCount[id] == 1 && m_assignment->isValued(l.getAtom()))
 	    fatalError("too many unvalued lits in Mod2ClauseSet::verifyReason");
-	  if ((m_currentSumMod2[id] == c.getSumMod2()) == l.getSign())
+	  // leave l out of the sum if it already has its value
+	  bool sum = m_currentSumMod2[id];
+	  if (m_assignment->isValued(l.getAtom()) && m_assignment->getValue(l.getAtom()))
+	    sum = !sum;
+	  if ((sum == c.getSumMod2()) == l.getSign())
 	    fatalError("bad value in Mod2ClauseSet::verifyReason");;
 	  break;
 	}
@@ -351,6 +586,33 @@ void Mod2ClauseSet::verifyConstraintSet()
 	    }
 	}
     }
+
+  // pivots are only in their own row and are unvalued unless the
+  // whole row is.  After propagation no row has one unvalued column.
+  for (size_t r=0; r < m_numberRows; ++r)
+    {
+      const Word* row = getRow(r);
+      int pivot = m_pivot[r];
+      if (!testBit(row,pivot) || m_pivotRow[pivot] != (int)r)
+	fatalError("bad pivot in Mod2ClauseSet::verifyConstraintSet");
+      for (size_t j=0; j < m_numberRows; ++j)
+	if (j != r && testBit(getRow(j),pivot))
+	  fatalError("pivot in two rows in Mod2ClauseSet::verifyConstraintSet");
+
+      int count = 0;
+      bool sum = m_rowSumMod2[r];
+      for (size_t w=0; w < m_words; ++w)
+	{
+	  count += __builtin_popcountll(row[w] & ~m_valued[w]);
+	  sum ^= __builtin_popcountll(row[w] & m_valuedTrue[w]) & 1;
+	}
+      if (count > 0 && testBit(&m_valued[0],pivot))
+	fatalError("valued pivot in Mod2ClauseSet::verifyConstraintSet");
+      if (count == 1)
+	fatalError("unit row in Mod2ClauseSet::verifyConstraintSet");
+      if (count == 0 && sum)
+	fatalError("UNSAT row in Mod2ClauseSet::verifyConstraintSet");
+    }
 }
 
 
@@ -15,6 +15,41 @@
 #include <iostream>
 
 
+/********************************************************************/
+/**
+   CLASS: Mod2ClauseSet
+
+   PURPOSE:  A Mod2ClauseSet maintains a database of parity (xor)
+   constraints.
+
+   IMPLEMENTATION:
+
+   COUNTS: For each constraint we keep the number of unvalued atoms
+   and the sum mod 2 of the valued ones.  A constraint with one
+   unvalued atom forces it.
+
+   GAUSSIAN ELIMINATION: A single constraint only propagates when it
+   is unit but a sum of constraints can be unit long before any of
+   them is.  When the initial constraints are in, they are copied into
+   a bit packed matrix over GF(2), one row per constraint and one
+   column per atom, and put in reduced row echelon form.  Each row has
+   a pivot column that appears in no other row.  We keep every pivot
+   unvalued, unless every column of its row is valued.  When a pivot
+   gets a value, we pick another unvalued column of the row as its
+   pivot and add the row to the other rows that contain that column.
+   With that invariant, any sum of rows with one unvalued atom is
+   already a row with one unvalued atom.  So checking the rows that
+   contain the newly valued column finds every implication the whole
+   system has.  Row operations are never undone.  Backing up only
+   unvalues columns, which keeps the invariant true.
+
+   The reason for an implication found this way is the row itself.
+   The first time a row is used as a reason it is added to the set as
+   a new constraint.  Its ID is reused until the row changes, so
+   conflict analysis (Solver::learnMod2Constraint) sees an ordinary
+   mod 2 constraint.
+
+***********************************************************************/
 
 class Mod2ClauseSet
 {
@@ -30,12 +65,31 @@ private:
   std::vector<int> m_unvaluedCount;
   std::vector<bool> m_currentSumMod2;
   std::queue<ClauseID> m_unusedIDs;
+  std::size_t m_firstLearnedID;         // ids below this are never deleted as irrelevant
   const PartialAssignment* m_assignment; // pointer to current assignment
 
   Conflict m_conflict;
   ClauseSetStatistics m_statistics;
   ClauseSetSettings m_settings;
 
+  // the gaussian elimination matrix, m_words words per row
+  typedef unsigned long long Word;
+  bool m_matrixBuilt;
+  bool m_inconsistent;              // the matrix has a row 0 = 1
+  std::size_t m_words;
+  std::size_t m_numberRows;
+  std::vector<Word> m_rows;
+  std::vector<bool> m_rowSumMod2;
+  std::vector<int> m_pivot;         // pivot column of each row
+  std::vector<int> m_pivotRow;      // row a column is pivot of or -1
+  std::vector<ClauseID> m_rowReason; // constraint equal to the row or 0
+  std::vector<int> m_reasonRow;     // row a constraint explains or -1
+  std::vector<int> m_column;        // column of each atom or -1
+  std::vector<int> m_columnAtom;
+  std::vector<Word> m_valued;       // columns valued by the assignment
+  std::vector<Word> m_valuedTrue;   // columns valued true
+  FastClause m_explanation;         // scratch space for new reasons
+
   // memory management functions
   std::size_t getPoolSize() const { return m_poolEnd - m_poolBegin; }
   std::size_t getPoolFreeSpace() const { return m_poolEndStorage - m_poolEnd; }
@@ -57,6 +111,19 @@ private:
 
   std::size_t getNumberConstraints() { return m_clauses.size() - m_unusedIDs.size(); }
   inline void deleteClause(int) ;
+
+  // gaussian elimination
+  void buildMatrix();
+  Word* getRow(std::size_t r) { return &m_rows[r * m_words]; }
+  const Word* getRow(std::size_t r) const { return &m_rows[r * m_words]; }
+  static bool testBit(const Word* w, int i) { return (w[i >> 6] >> (i & 63)) & 1; }
+  static void setBit(Word* w, int i) { w[i >> 6] |= ((Word)1) << (i & 63); }
+  static void clearBit(Word* w, int i) { w[i >> 6] &= ~(((Word)1) << (i & 63)); }
+  void addRow(std::size_t, std::size_t);
+  void pivotOn(std::size_t, int);
+  inline void forgetRowReason(std::size_t);
+  ClauseID getRowReason(std::size_t);
+  bool getMatrixImplications(int, ImplicationList&);
   
 public:
 
@@ -104,10 +171,12 @@ public:
 
 inline void Mod2ClauseSet::setInitialClauseCount() 
 {  
+  if (!m_matrixBuilt) buildMatrix();
   int count = m_statistics.initialClauseCount +
     m_statistics.addedClauseCount -
     m_statistics.deletedClauseCount;
   m_statistics.initialClauseCount = count;
+  m_firstLearnedID = m_clauses.size();   // preprocessing may have left holes below it
   m_statistics.addedClauseCount = 0;
   m_statistics.deletedClauseCount = 0;
 }
@@ -123,6 +192,7 @@ inline void Mod2ClauseSet::deleteClause(ClauseID id)
       PoolLiteral &plit = c.getWriteLiteral(i);
       plit.clear();
     }
+  if (m_reasonRow[id] != -1) forgetRowReason(m_reasonRow[id]);
   m_statistics.deletedClauseCount++;
   m_unusedIDs.push(id);
 }
@@ -133,7 +203,15 @@ inline std::size_t Mod2ClauseSet::estimateMemoryUsage() const
   return sizeof(PoolLiteral) * (getPoolSize() + getPoolFreeSpace()) +
     sizeof(std::vector<int>) * m_literalIndex.capacity() +
     sizeof(Clause) * m_clauses.capacity() +
-    sizeof(int) * m_unusedIDs.size();
+    sizeof(int) * m_unusedIDs.size() +
+    sizeof(Word) * m_rows.capacity();
+}
+
+// the row has changed or its constraint is gone
+inline void Mod2ClauseSet::forgetRowReason(std::size_t r)
+{
+  if (m_rowReason[r] != 0) m_reasonRow[m_rowReason[r]] = -1;
+  m_rowReason[r] = 0;
 }
 
 
@@ -183,12 +261,27 @@ inline void Mod2ClauseSet::wind(Literal l)
 
   if (sign) valuePositive(atom);
   else valueNegative(atom);
+
+  int column = m_column[atom];
+  if (column != -1)
+    {
+      setBit(&m_valued[0],column);
+      if (sign) setBit(&m_valuedTrue[0],column);
+    }
 }
 
 inline void Mod2ClauseSet::unwind(Literal l)
 {
-  if (l.getSign()) unvaluePositive(l.getAtom());
-  else unvalueNegative(l.getAtom());
+  int atom = l.getAtom();
+  if (l.getSign()) unvaluePositive(atom);
+  else unvalueNegative(atom);
+
+  int column = m_column[atom];
+  if (column != -1)
+    {
+      clearBit(&m_valued[0],column);
+      clearBit(&m_valuedTrue[0],column);
+    }
 }
 
 
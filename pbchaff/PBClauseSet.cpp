@@ -5,13 +5,15 @@
 ***********************************/
 
 #include "PBClauseSet.h"
+#include "TouchCounter.h"
+#include <cstring>
 #include <iostream>
 #include <algorithm>
 using namespace std;
 
 
 
-PBClauseSet::PBClauseSet() : m_assignment(0)
+PBClauseSet::PBClauseSet() : m_firstLearnedID(1), m_assignment(0)
 { 
   m_poolBegin = new PoolPBLiteral[STARTUP_LIT_POOL_SIZE];
   m_poolEnd = m_poolBegin;
@@ -27,12 +29,13 @@ void PBClauseSet::initialize(const PartialAssignment* ptr)
   // we don't allow clauseIDs of 0 so just push a dummy clause
   m_clauses.resize(1);
   m_clauses[0].initialize(0,0,0);
-  m_possible.push_back(0);
+  m_watchSlack.push_back(0);
   m_current.push_back(0);
   
   size_t numberVariables = m_assignment->getNumberVariables();
   for (size_t i=0; i <= numberVariables; i++)
     {
+      m_watchedLitIndex.push_back(PBLitIndex());
       m_literalIndex.push_back(PBLitIndex());
       m_literalCounts[0].push_back(0);
       m_literalCounts[1].push_back(0);
@@ -110,7 +113,7 @@ bool PBClauseSet::enlargePool()
   m_poolEndStorage = m_poolBegin + newSize;
   memcpy(m_poolBegin,oldBegin,(oldEnd - oldBegin) * sizeof(PoolPBLiteral));
   m_poolEnd = m_poolBegin + (oldEnd - oldBegin);
-  int offset = m_poolBegin - oldBegin;
+  std::ptrdiff_t offset = m_poolBegin - oldBegin;
 
   // update pointers into pool
   vector<PBClause>::iterator it = m_clauses.begin();
@@ -124,8 +127,20 @@ bool PBClauseSet::enlargePool()
 }
 
 
+// remove the entry for constraint id from a list in a literal index
+static void removeID(vector<WeightedClauseID> &watchers, int id)
+{
+  for (size_t i=0,size=watchers.size(); i < size; ++i)
+    if (id == watchers[i].id)
+      {
+	watchers[i] = watchers[size - 1];
+	watchers.pop_back();
+	return;
+      }
+}
+
 /* This function is different than deleteClause because it
-   removes the clause from the literal index as well.  deleteClause
+   removes the clause from the literal indexes as well.  deleteClause
    does not.
 */
 void PBClauseSet::removeClause(int id)
@@ -139,15 +154,10 @@ void PBClauseSet::removeClause(int id)
       int atom = plit.getAtom();
       bool sign = plit.getSign();
       m_literalCounts[sign][atom]--;
+      if (plit.isWatched())
+	removeID(m_watchedLitIndex[atom].getPBLitIndex(sign),id);
+      removeID(m_literalIndex[atom].getPBLitIndex(sign),id);
       plit.clear();
-      vector<WeightedClauseID> &watchers = m_literalIndex[atom].getPBLitIndex(sign);
-      for (size_t i=0,size=watchers.size(); i < size; ++i)
-	if (id == watchers[i].id)
-	  {
-	    watchers[i] = watchers[size - 1];
-	    watchers.pop_back();
-	    break;
-	  }
     }
   m_statistics.deletedClauseCount++;
   m_statistics.literalCount -= size;
@@ -179,7 +189,7 @@ ClauseID PBClauseSet::addClause(FastClause &atoms)
     {
       newID = m_clauses.size();
       m_clauses.resize(newID + 1);
-      m_possible.push_back(0);
+      m_watchSlack.push_back(0);
       m_current.push_back(0);
     }
   else
@@ -205,55 +215,141 @@ ClauseID PBClauseSet::addClause(FastClause &atoms)
   // update some counts
   m_statistics.literalCount += c.size();
   m_statistics.addedClauseCount++;
-  computeCounts(newID);
 
-  // add to literal index
-  for (size_t i=0, size=c.size(); i < size; i++)
+  setWatchers(newID,atoms);
+
+  // add to full index
+  if (m_settings.strengthenOn)
     {
-      bool sign = c.getSign(i);
-      int atom = c.getAtom(i);
-      int weight = c.getWeight(i);
-      m_literalIndex[atom].getPBLitIndex(sign).push_back(WeightedClauseID(newID,weight));
+      computeCounts(newID);
+
+      for (size_t i=0, size=c.size(); i < size; i++)
+	{
+	  bool sign = c.getSign(i);
+	  int atom = c.getAtom(i);
+	  int weight = c.getWeight(i);
+	  m_literalIndex[atom].getPBLitIndex(sign).push_back(WeightedClauseID(newID,weight));
+	}
     }
 
   return newID;
 }
 
 
+/* Watch literals that aren't UNSAT until the watch slack covers
+   the largest weight.  If that isn't possible, keep watching UNSAT
+   literals, those valued deepest first, until the watched weight
+   reaches the degree plus the largest weight or we run out.  Watched
+   UNSAT literals don't count toward the slack until they are unwound.
+*/
+void PBClauseSet::setWatchers(ClauseID id, FastClause &atoms)
+{
+  PBClause &c = m_clauses[id];
+  size_t numberLits = c.size();
+  m_watchSlack[id] = - c.getRequired();
+  if (numberLits == 0) return;
+  int maxWeight = c.getWeight(0);
+  int slack = - c.getRequired();
+  int watchedWeight = 0;
+
+  for (size_t i=0; i < numberLits && slack < maxWeight; i++)
+    {
+      PoolPBLiteral &plit = c.getWriteLiteral(i);
+      if (!isUNSAT(plit))
+	{
+	  watch(id,plit);
+	  slack += plit.getWeight();
+	  watchedWeight += plit.getWeight();
+	}
+    }
+  m_watchSlack[id] = slack;
+  if (slack >= maxWeight) return;
+
+  int needed = c.getRequired() + maxWeight;
+  for (int i = m_assignment->size() - 1; i >= 0 && watchedWeight < needed; --i)
+    {
+      Literal l = m_assignment->getLiteral(i);
+      int a = l.getAtom();
+      if (atoms.contains(a) && (atoms.getValue(a) > 0) != l.getSign())
+	{
+	  PoolPBLiteral &plit = c.getWriteLiteral(atoms.getPosition(a));
+	  watch(id,plit);
+	  watchedWeight += plit.getWeight();
+	}
+    }
+}
+
+
+/* l has just been made true and wind has already taken the weight of
+   !l out of the slack of every constraint watching it.  Constraints
+   whose slack no longer covers their largest weight look for more
+   literals to watch.  If there aren't enough, every literal that
+   isn't UNSAT is watched and we can read the implications off the
+   slack.
+*/
 bool PBClauseSet::getImplications(Literal l, ImplicationList& units)
 {
+  zap::TouchCounter touched;
   int atom = l.getAtom();
   bool sign = l.getSign();
-  vector<WeightedClauseID>& watchers = m_literalIndex[atom].getPBLitIndex(!sign);
-  vector<WeightedClauseID>::iterator it = watchers.begin();
-  vector<WeightedClauseID>::iterator end = watchers.end();
-  
-  for ( ; it != end; it++)
+  vector<WeightedClauseID>& watchers = m_watchedLitIndex[atom].getPBLitIndex(!sign);
+
+  for (size_t k=0; k < watchers.size(); k++)
     {
-      int id = (*it).id;
-      if (isUnit(id))
+      int id = watchers[k].id;
+      PBClause& c = m_clauses[id];
+      int maxWeight = c.getWeight(0);
+      if (m_watchSlack[id] >= maxWeight) continue;
+      touched.clause();
+
+      // look for more literals to watch
+      size_t size = c.size();
+      size_t falsified = size;
+      for (size_t i=0; i < size; i++)
 	{
-	  const PBClause& c = m_clauses[id];
-	  for (size_t i=0, size=c.size();
-	       i < size && c.getWeight(i) > m_possible[id]; i++)
+	  PoolPBLiteral &plit = c.getWriteLiteral(i);
+	  if (plit.isWatched())
 	    {
-	      int a = c.getAtom(i);
-	      if (!m_assignment->isValued(a))
-		{
-		  Literal l(a,c.getSign(i));
+	      if ((int)plit.getAtom() == atom) falsified = i;
+	    }
+	  else if (m_watchSlack[id] < maxWeight && !isUNSAT(plit))
+	    {
+	      watch(id,plit);
+	      m_watchSlack[id] += plit.getWeight();
+	    }
+	  if (m_watchSlack[id] >= maxWeight && falsified < size) break;
+	}
+
+      // we don't need to watch !l anymore
+      if (m_watchSlack[id] >= maxWeight)
+	{
+	  c.getWriteLiteral(falsified).unsetWatch();
+	  watchers[k] = watchers.back();
+	  watchers.pop_back();
+	  k--;
+	  continue;
+	}
+
+      // every literal that isn't UNSAT is watched so the slack is exact
+      int slack = m_watchSlack[id];
+      for (size_t i=0; i < size && c.getWeight(i) > slack; i++)
+	{
+	  int a = c.getAtom(i);
+	  if (!m_assignment->isValued(a))
+	    {
+	      Literal u(a,c.getSign(i));
 #ifdef VERIFY
-		  verifyReason(l,id);
+	      verifyReason(u,id);
 #endif
-		  if (units.contains(l.getNegation()))
-		    {
-		      m_conflict.atom = a;
-		      m_conflict.reason1 = (id * 3) + 1;
-		      m_conflict.reason2 = units.getReason(a);
-		      return false;
-		    }
-		   if (!units.contains(l) || betterClause(id,units.getReason(a),a))
-		     units.push(l,(id * 3) + 1);
+	      if (units.contains(u.getNegation()))
+		{
+		  m_conflict.atom = a;
+		  m_conflict.reason1 = (id * 3) + 1;
+		  m_conflict.reason2 = units.getReason(a);
+		  return false;
 		}
+	      if (!units.contains(u) || betterClause(id,units.getReason(a),a))
+		units.push(u,(id * 3) + 1);
 	    }
 	}
     }
@@ -264,23 +360,21 @@ bool PBClauseSet::getImplications(Literal l, ImplicationList& units)
 void PBClauseSet::computeCounts(ClauseID id)
 {
   const PBClause& c = m_clauses[id];
-  m_possible[id] = - c.getRequired();
   m_current[id] = - c.getRequired();
   
   for (size_t i=0, size=c.size(); i < size; i++)
-    {
-      int atom = c.getAtom(i);
-      int weight = c.getWeight(i);
-      if (!m_assignment->isValued(atom)) m_possible[id] += weight;
-      else
-	{
-	  if (isSAT(c.getReadLiteral(i)))
-	    {
-	      m_possible[id] += weight;
-	      m_current[id] += weight;
-	    }
-	}
-    }
+    if (isSAT(c.getReadLiteral(i))) m_current[id] += c.getWeight(i);
+}
+
+
+// the weight of the literals that aren't UNSAT minus the degree
+int PBClauseSet::getPossible(ClauseID id) const
+{
+  const PBClause& c = m_clauses[id];
+  int possible = - c.getRequired();
+  for (size_t i=0, size=c.size(); i < size; i++)
+    if (!isUNSAT(c.getReadLiteral(i))) possible += c.getWeight(i);
+  return possible;
 }
 
 
@@ -292,11 +386,12 @@ bool PBClauseSet::initialClauseCheck(ImplicationList &unitList) const
       const PBClause &c = m_clauses[i];
       if (c.inUse())
 	{
-	  if (isUnit(i))
+	  int possible = getPossible(i);
+	  if (c.getWeight(0) > possible)
 	    {
 	      for (size_t j=0,sz=c.size(); j < sz; j++)
 		{
-		  if (c.getWeight(j) <= m_possible[i]) break;
+		  if (c.getWeight(j) <= possible) break;
 		  Literal l(c.getAtom(j),c.getSign(j));
 		  if (unitList.contains(l.getNegation()))
 		    return false;
@@ -309,6 +404,23 @@ bool PBClauseSet::initialClauseCheck(ImplicationList &unitList) const
 }
 
 
+// drop entries for constraints that deleteClause has voided out
+void PBClauseSet::removeDeleted(vector<WeightedClauseID> &watchers)
+{
+  vector<WeightedClauseID>::iterator it = watchers.begin();
+  for ( ; it != watchers.end(); it++)
+    {
+      PBClause& c = m_clauses[(*it).id];
+      if (c.getFirst()->isNull())
+	{
+	  *it = watchers.back();
+	  watchers.pop_back();
+	  it--;
+	}
+    }
+}
+
+
 void PBClauseSet::deleteIrrelevantClauses()
 {
   // if we've been running out of memory reduce the relevance bounds
@@ -335,12 +447,12 @@ void PBClauseSet::deleteIrrelevantClauses()
   // delete the clauses
   size_t oldDeletedClauseCount = m_statistics.deletedClauseCount;
   size_t nc = m_clauses.size();
-  size_t ic = m_statistics.initialClauseCount + 1;
+  size_t ic = m_firstLearnedID;
   for (size_t i=ic; i < nc; i++)
     {
       size_t size = m_clauses[i].size() - m_clauses[i].getRequired();
-      if (!m_clauses[i].inUse() || size < m_settings.lengthBound) continue;
-      int possible = m_possible[i];
+      if (!m_clauses[i].inUse() || m_clauses[i].isPermanent() || size < m_settings.lengthBound) continue;
+      int possible = getPossible(i);
       int weight0 = m_clauses[i].getWeight(0);
       bool notReason = (weight0 <= possible);
       if ((possible >= (int)(m_settings.relevanceBound) && notReason))
@@ -352,35 +464,13 @@ void PBClauseSet::deleteIrrelevantClauses()
 
   if (oldDeletedClauseCount == m_statistics.deletedClauseCount) return;
 
-   // update pointers into the literalPool
-   for (size_t i=1; i < m_literalIndex.size(); i++)
+  // remove the deleted constraints from the literal indexes
+  for (size_t i=1; i < m_literalIndex.size(); i++)
     {
-      vector<WeightedClauseID> &watchers1 = m_literalIndex[i].getPBLitIndex(true);
-      vector<WeightedClauseID>::iterator it1 = watchers1.begin();
-      for ( ; it1 != watchers1.end(); it1++)
-	{
-	  PBClause& c = m_clauses[(*it1).id];
-	  if (c.getFirst()->isNull())
-	    {
-	      *it1 = watchers1.back();
-	      watchers1.pop_back();
-	      it1--;
-	    }
-	}
-      
-      
-      vector<WeightedClauseID> &watchers0 = m_literalIndex[i].getPBLitIndex(false);
-      vector<WeightedClauseID>::iterator it0 = watchers0.begin();
-      for ( ; it0 != watchers0.end(); it0++)
-	{
-	  PBClause& c = m_clauses[(*it0).id];
-	  if (c.getFirst()->isNull())
-	    {
-	      *it0 = watchers0.back();
-	      watchers0.pop_back();
-	      it0--;
-	    }
-	}
+      removeDeleted(m_watchedLitIndex[i].getPBLitIndex(true));
+      removeDeleted(m_watchedLitIndex[i].getPBLitIndex(false));
+      removeDeleted(m_literalIndex[i].getPBLitIndex(true));
+      removeDeleted(m_literalIndex[i].getPBLitIndex(false));
     }
 }
 
@@ -390,14 +480,14 @@ void PBClauseSet::verifyReason(Literal l,ClauseID id)
   int atom = l.getAtom();
   bool foundAtom = false;
   const PBClause &c = m_clauses[id];
-  computeCounts(id);
+  int possible = getPossible(id);
   for (size_t i=0; i < c.size(); i++)
     {
       int a = c.getAtom(i);
       if (atom == a)
 	{
 	  foundAtom = true;
-	  if (m_possible[id] >= c.getWeight(i))
+	  if (possible >= c.getWeight(i))
 	    {
 	      cerr << "Bad reason for " << l << endl;
 	      cerr << m_clauses[id] << endl;
@@ -421,17 +511,34 @@ void PBClauseSet::verifyConstraintSet()
     {
       if (m_clauses[i].inUse())
 	{
-	  int oldPossible = m_possible[i];
-	  int oldCurrent = m_current[i];
-	  computeCounts(i);
-
-	  if (oldPossible != m_possible[i])
-	    fatalError("bad possible value in PBClauseSet::verifyConstraintSet");
-
-	  if (oldCurrent != m_current[i])
-	    fatalError("bad current value in PBClauseSet::verifyConstraintSet");
+	  const PBClause &c = m_clauses[i];
+	  int possible = getPossible(i);
+
+	  // the watch slack counts the watched literals that aren't UNSAT
+	  // and if it doesn't cover the largest weight they all have to be
+	  // watched
+	  int slack = - c.getRequired();
+	  bool allWatched = true;
+	  for (size_t j=0; j < c.size(); j++)
+	    if (!isUNSAT(c.getReadLiteral(j)))
+	      {
+		if (c.getReadLiteral(j).isWatched()) slack += c.getWeight(j);
+		else allWatched = false;
+	      }
+	  if (slack != m_watchSlack[i])
+	    fatalError("bad watch slack in PBClauseSet::verifyConstraintSet");
+	  if (slack < c.getWeight(0) && !allWatched)
+	    fatalError("too few watchers in PBClauseSet::verifyConstraintSet");
+
+	  if (m_settings.strengthenOn)
+	    {
+	      int oldCurrent = m_current[i];
+	      computeCounts(i);
+	      if (oldCurrent != m_current[i])
+		fatalError("bad current value in PBClauseSet::verifyConstraintSet");
+	    }
 
-	  if (m_possible[i] < 0)
+	  if (possible < 0)
 	    {
 	      cerr << "ID: " << i << "   " << m_clauses[i];
 	      cerr << "UNSAT clause in PBClauseSet::verifyConstraintSet" << endl;
@@ -8,8 +8,8 @@
 /**
    There are currently three versions of ClauseSet.  They implement
    the same interface but with different data structure maintenence.
-   This version uses count based adjacency list data structures
-   and can manage full Pseudo-Boolean constraints.
+   This version uses watched literals generalized to weights and
+   can manage full Pseudo-Boolean constraints.
    
 **************************************************************/
 									       
@@ -31,7 +31,8 @@ public:
   WeightedClauseID(int i, int w) : id(i), weight(w) {}
 };
 
-/* for each literal we keep a list of clauses that contain that literal */
+/* for each literal we keep a list of clauses that contain (or watch)
+   that literal together with its weight in the clause */
 class PBLitIndex
 {
 public:
@@ -67,17 +68,31 @@ public:
    is performed to compact the database and reclaim memory from
    deleted clauses.
 
-   LITERAL INDEX: PBClauseSet uses a literal index to access
-   subsets of clauses that contain a specific literal.  This is
-   needed for determining unit implications quickly.
-
-   COUNTS: For each
-   clause we maintain two counts, possible, and current.  These
-   counts represent how satisfied the clause is relative to the
-   current partial assignment.  Current represents the current
-   count, and possible tells us the count that would occur if
-   all the remaining unvalued literals were valued favorably for
-   the clause. 
+   WATCHED LITERALS: A constraint sum w_i l_i >= d with largest
+   weight w_max can't propagate anything as long as the literals
+   that aren't false have total weight at least d + w_max.  So each
+   constraint only watches enough literals to cover that much, and
+   keeps a watch slack, the weight of its watched literals that
+   aren't false minus d.  Making a watched literal false lowers the
+   slack by its weight (wind) and unassigning it puts the weight
+   back (unwind).  Both only walk the watch list for that literal.
+   When the slack drops below w_max getImplications looks for more
+   literals to watch.  If it can't find enough, every literal that
+   isn't false is watched, the slack is exact, and any unvalued
+   literal with weight more than the slack is implied.  Watches on
+   false literals are dropped once the slack is covered without them.
+
+   A new constraint watches literals that aren't false first.  If
+   that isn't enough it also watches the false literals valued
+   deepest in the assignment, so backing up will always unassign
+   watched literals before unwatched ones.
+
+   COUNTS: For strengthening we still need to know which constraints
+   become over satisfied.  When strengthening is on, new constraints
+   are also added to a full literal index and we keep a current
+   count for each, the weight of its true literals minus d.  Like
+   the LazyClauseSet the counts are only maintained while
+   strengthening is on.
    
 ***********************************************************************/
 
@@ -91,11 +106,13 @@ protected:
   PoolPBLiteral* m_poolEnd;
   PoolPBLiteral* m_poolEndStorage;
 
-  std::vector<PBLitIndex> m_literalIndex;
+  std::vector<PBLitIndex> m_watchedLitIndex;
+  std::vector<PBLitIndex> m_literalIndex;      // only kept for strengthening
   std::vector<PBClause> m_clauses;
-  std::vector<int> m_possible;
+  std::vector<int> m_watchSlack;
   std::vector<int> m_current;
   std::queue<ClauseID> m_unusedIDs;
+  std::size_t m_firstLearnedID;         // ids below this are never deleted as irrelevant
   const PartialAssignment* m_assignment; // pointer to current assignment
 
   Conflict m_conflict;
@@ -118,17 +135,19 @@ protected:
   inline bool isUNSAT(const PoolPBLiteral&) const;
   inline bool isSAT(const PoolPBLiteral&) const;
 
+  // watched literals
+  void setWatchers(ClauseID, FastClause&);
+  inline void watch(ClauseID, PoolPBLiteral&);
+  int getPossible(ClauseID) const;
+  void removeDeleted(std::vector<WeightedClauseID>&);
+
   // maintain counts
   void computeCounts(ClauseID);
-  inline void incPossible(Literal);
-  inline void decPossible(Literal);
-  inline void incCurrent(Literal);
   inline void incCurrent(Literal,StackOfLists&);
   inline void decCurrent(Literal);
 
   std::size_t getNumberConstraints() { return m_clauses.size() - m_unusedIDs.size(); }
   inline bool betterClause(ClauseID,ClauseID,int) const;
-  inline bool isUnit(ClauseID id) const;
   inline void deleteClause(int) ;
 public:
 
@@ -152,6 +171,7 @@ public:
   //*********************** WRITE ********************************
   
   ClauseID addClause(FastClause &atoms);
+  void markPermanent(ClauseID id) { m_clauses[id].markPermanent(); }
   void removeClause(int);
   void deleteIrrelevantClauses();
 
@@ -187,6 +207,7 @@ inline void PBClauseSet::setInitialClauseCount()
     m_statistics.addedClauseCount -
     m_statistics.deletedClauseCount;
   m_statistics.initialClauseCount = count;
+  m_firstLearnedID = m_clauses.size();   // preprocessing may have left holes below it
   m_statistics.addedClauseCount = 0;
   m_statistics.deletedClauseCount = 0;
 }
@@ -214,6 +235,7 @@ inline void PBClauseSet::deleteClause(ClauseID id)
 inline std::size_t PBClauseSet::estimateMemoryUsage() const
 {
   return sizeof(PoolPBLiteral) * (getPoolSize() + getPoolFreeSpace()) +
+    sizeof(PBLitIndex) * m_watchedLitIndex.capacity() +
     sizeof(PBLitIndex) * m_literalIndex.capacity() +
     sizeof(PBClause) * m_clauses.capacity() +
     sizeof(int) * m_unusedIDs.size();
@@ -275,17 +297,6 @@ inline bool PBClauseSet::betterClause(ClauseID id1, ClauseID outerID,int conflic
   else return false;
 }
 
-inline void PBClauseSet::incPossible(Literal l)
-{
-  int atom = l.getAtom();
-  bool sign = l.getSign();
-  std::vector<WeightedClauseID>::iterator it = m_literalIndex[atom].getPBLitIndex(sign).begin();
-  std::vector<WeightedClauseID>::iterator end = m_literalIndex[atom].getPBLitIndex(sign).end();
-  for (;it != end; it++) m_possible[(*it).id] += (*it).weight;
-}
-
-
-
 inline void PBClauseSet::decCurrent(Literal l)
 {
   int atom = l.getAtom();
@@ -295,24 +306,6 @@ inline void PBClauseSet::decCurrent(Literal l)
   for (;it != end; it++) m_current[(*it).id] -= (*it).weight;
 }
 
-inline void PBClauseSet::decPossible(Literal l)
-{
-  int atom = l.getAtom();
-  bool sign = l.getSign();
-  std::vector<WeightedClauseID>::iterator it = m_literalIndex[atom].getPBLitIndex(sign).begin();
-  std::vector<WeightedClauseID>::iterator end = m_literalIndex[atom].getPBLitIndex(sign).end();
-  for (;it != end; it++) m_possible[(*it).id] -= (*it).weight;
-}
-
-inline void PBClauseSet::incCurrent(Literal l)
-{
-  int atom = l.getAtom();
-  bool sign = l.getSign();
-  std::vector<WeightedClauseID>::iterator it = m_literalIndex[atom].getPBLitIndex(sign).begin();
-  std::vector<WeightedClauseID>::iterator end = m_literalIndex[atom].getPBLitIndex(sign).end();
-  for (;it != end; it++) m_current[(*it).id] += (*it).weight;
-}
-
 inline void PBClauseSet::incCurrent(Literal l,StackOfLists& overSat)
 {
   int atom = l.getAtom();
@@ -329,38 +322,40 @@ inline void PBClauseSet::incCurrent(Literal l,StackOfLists& overSat)
     }
 }
 
+// l is now true so the watchers of its negation lose weight
 inline void PBClauseSet::wind(Literal l, StackOfLists& overSat)
 {
   if (m_settings.strengthenOn) incCurrent(l,overSat);
-  else incCurrent(l);
-  decPossible(l.getNegation());
+  std::vector<WeightedClauseID>& watched =
+    m_watchedLitIndex[l.getAtom()].getPBLitIndex(!l.getSign());
+  std::vector<WeightedClauseID>::iterator it = watched.begin();
+  std::vector<WeightedClauseID>::iterator end = watched.end();
+  for (;it != end; it++) m_watchSlack[(*it).id] -= (*it).weight;
 }
 
 inline void PBClauseSet::unwind(Literal l)
 {
-  incPossible(l.getNegation());
-  decCurrent(l);
+  std::vector<WeightedClauseID>& watched =
+    m_watchedLitIndex[l.getAtom()].getPBLitIndex(!l.getSign());
+  std::vector<WeightedClauseID>::iterator it = watched.begin();
+  std::vector<WeightedClauseID>::iterator end = watched.end();
+  for (;it != end; it++) m_watchSlack[(*it).id] += (*it).weight;
+  if (m_settings.strengthenOn) decCurrent(l);
 }
 
 
-inline void PBClauseSet::initializeClause(FastClause& c, ClauseID id) const
+inline void PBClauseSet::watch(ClauseID id, PoolPBLiteral& plit)
 {
-  c.initialize(m_clauses[id]);
-  c.setCurrent(m_current[id]);
+  m_watchedLitIndex[plit.getAtom()].getPBLitIndex(plit.getSign()).
+    push_back(WeightedClauseID(id,plit.getWeight()));
+  plit.setWatch(UP);
 }
 
-inline bool PBClauseSet::isUnit(ClauseID id) const
+
+inline void PBClauseSet::initializeClause(FastClause& c, ClauseID id) const
 {
-  // this is probably where the aloul pointer thing should be done
-  if (m_current[id] >= 0) return false;
-  const PBClause &c = m_clauses[id];
-  if (c.getWeight(0) == 1) return m_possible[id] == 0;
-  if (m_possible[id] == m_current[id]) return false;
-  if (c.getWeight(c.size() - 1) > m_possible[id]) return true;
-  for (size_t i=0, size = c.size(); i < size; i++)
-    if (c.getWeight(i) <= m_possible[id]) return false;
-    else if (!m_assignment->isValued(c.getAtom(i))) return true;
-  return false;
+  c.initialize(m_clauses[id]);
+  c.setCurrent(m_current[id]);
 }
 
 
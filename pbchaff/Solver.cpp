@@ -5,8 +5,11 @@
 ***********************************/
 
 #include <fstream>
+#include <sstream>
+#include <climits>
 #include "FastClause.h"
 #include "Solver.h"
+#include "front_end.h"
 #include <algorithm>
 #include <string>
 
@@ -18,31 +21,70 @@ using namespace std;
 
 void Solver::solve()
 {
-  m_clauseSet.setInitialClauseCount();
+  solve(vector<Literal>());
+  if (m_statistics.outcome == SATISFIABLE)
+    m_assignment.printNameForm();
+}
+
+
+int Solver::solve(const vector<Literal>& assumptions)
+{
+  if (!m_initialCheckDone) m_clauseSet.setInitialClauseCount();
   m_timer.initialize();
+  m_solveAssumptions = assumptions;
+  m_failedAssumptions.clear();
   m_statistics.outcome = realSolve();
   m_statistics.runTime = m_timer.getElapsedTime();
-  if (m_statistics.outcome == SATISFIABLE)
-    m_assignment.printNameForm();
+  if (m_proof && m_unsatisfiable)
+    *m_proof << "u >= 1 ;\nc " << ++m_proofConstraints << "\n";
+  return m_statistics.outcome;
 }
 
 
+/* Everything from an earlier call except the level 0 assignments
+   is thrown away before we start.  The initial clause check and
+   failed literal test are only done the first time, after that
+   addConstraint takes care of any new level 0 assignments.
+*/
 int Solver::realSolve()
 {
-  if (!initialClauseCheck()) return UNSATISFIABLE;
-  if (m_settings.failedLiteral)
-    if (!failedLiteralTest()) return UNSATISFIABLE;
-  
+  if (m_unsatisfiable) return UNSATISFIABLE;
+  m_unitList.clear();
+  backjumpToLevel(0);
+
+  if (!m_initialCheckDone)
+    {
+      m_initialCheckDone = true;
+      initializeActivity();
+      m_unsatisfiable = !initialClauseCheck() ||
+	(m_settings.failedLiteral && !failedLiteralTest());
+      if (m_unsatisfiable) return UNSATISFIABLE;
+    }
+
+  Literal assumption;
   while (!m_assignment.isFull())
     {
       runPeriodicFunctions();
-      selectBranchVariable();
+      if (!nextAssumption(assumption)) return UNSATISFIABLE;
+      if (assumption.getAtom() != 0)
+	{
+	  m_unitList.push(assumption,0);
+	  m_statistics.nodeCount++;
+	}
+      else selectBranchVariable();
       while (!unitPropagate())
-		if (!backtrack()) return UNSATISFIABLE; 
+	if (!backtrack())
+	  {
+	    m_unsatisfiable = true;
+	    return UNSATISFIABLE;
+	  }
       if (m_timer.getElapsedTime() > m_settings.timeLimit) return TIME_OUT;
 	  if (zap::global_vars.time_out > 0 && zap::global_vars.time_out < (zap::get_cpu_time()-zap::global_vars.start_time))
 		return TIME_OUT;
     }
+  
+  // the last round of propagation may have falsified an assumption
+  if (!nextAssumption(assumption)) return UNSATISFIABLE;
   return SATISFIABLE;
 
 }
@@ -54,13 +96,20 @@ bool Solver::backtrack()
 {
   zap::global_vars.number_backtracks++;
   m_statistics.backtrackCount++;
-  return learn();
+  bool learned;
+  {
+    zap::PhaseTimer timer(zap::global_vars.phase_time[zap::PHASE_ANALYZE]);
+    learned = learn();
+  }
+  if (learned) zap::check_progress();
+  return learned;
 }
 
 
 
 bool Solver::unitPropagate()
 {
+  zap::SampledPhaseTimer timer(zap::global_vars.phase_time[zap::PHASE_PROPAGATE],m_propagateCalls);
   while (!m_unitList.empty())
     {
       pair<Literal,int> p = m_unitList.pop();
@@ -70,7 +119,7 @@ bool Solver::unitPropagate()
 	  const Conflict& conflict = m_clauseSet.getConflict();
 	  m_conflictAtom = conflict.atom;
 	  m_clauseSet.initializeClause(m_parent1,conflict.reason1);
-	  m_clauseSet.initializeClause(m_parent2,conflict.reason2);
+	  initializeParent2(conflict.reason2,m_conflictAtom);
 	  m_unitList.clear();
 	  return false;
 	}
@@ -95,9 +144,10 @@ void Solver::backjumpToLevel(int level)
       int lv = m_assignment.getDecisionLevel();
       if (lv <= level ) break;
       Literal l = m_assignment.getTop();
+      m_savedPhase[l.getAtom()] = (l.getSign() ? 1 : -1);
       m_assignment.pop();
       m_clauseSet.unwind(l);
-      
+      m_order.insert(l.getAtom());
     }
 }
 
@@ -108,10 +158,305 @@ void Solver::backjumpToAtom(int atom)
     {
       Literal l = m_assignment.getTop();
       if ((int)(l.getAtom()) == atom) break;
+      m_savedPhase[l.getAtom()] = (l.getSign() ? 1 : -1);
       m_assignment.pop();
       m_clauseSet.unwind(l);
+      m_order.insert(l.getAtom());
+    }
+}
+
+
+
+/*************************** INCREMENTAL SOLVING *************************/
+
+
+bool Solver::addClause(const vector<Literal>& lits)
+{
+  m_newConstraint.clear();
+  for (size_t i=0; i < lits.size(); ++i)
+    {
+      int atom = lits[i].getAtom();
+      int value = lits[i].getSign() ? 1 : -1;
+      if (m_newConstraint.contains(atom))
+	{
+	  if (m_newConstraint.getValue(atom) != value) return !m_unsatisfiable;  // a tautology
+	  continue;
+	}
+      m_newConstraint.addAtom(atom,value);
+    }
+  m_newConstraint.setRequired(1);
+  return addConstraint(m_newConstraint);
+}
+
+
+bool Solver::addPBConstraint(const vector<Literal>& lits, const vector<int>& weights, int required)
+{
+  ASSERT(lits.size() == weights.size());
+  m_newConstraint.clear();
+  for (size_t i=0; i < lits.size(); ++i)
+    {
+      if (weights[i] <= 0) fatalError("improper weight in Solver::addPBConstraint");
+      int value = lits[i].getSign() ? weights[i] : -weights[i];
+      if (m_newConstraint.addIfAbsent(lits[i].getAtom(),value))
+	fatalError("atom appears twice in Solver::addPBConstraint");
+    }
+  m_newConstraint.setRequired(required);
+  return addConstraint(m_newConstraint);
+}
+
+
+/* Constraints are added at decision level 0.  Before the first
+   call to solve that's all there is to it.  After that we simplify
+   the constraint against the level 0 assignments, since those will
+   never be undone, and then propagate anything it forces.  Returns
+   false if the constraint set has become UNSAT.
+*/
+bool Solver::addConstraint(FastClause& c)
+{
+  if (m_unsatisfiable) return false;
+  m_unitList.clear();
+  backjumpToLevel(0);
+
+  for (size_t i=0; i < c.size(); ++i)
+    {
+      Literal l = c.getLiteral(i);
+      if (m_assignment.isValued(l.getAtom()))
+	{
+	  int weight = c.getWeight(i);
+	  c.remove(l.getAtom());
+	  --i;
+	  if (!m_assignment.isUnsat(l)) c.incRequired(-weight);
+	}
+    }
+  if (c.getRequired() <= 0) return true;       // already satisfied
+  if (c.sumCoefficients() < c.getRequired())
+    {
+      m_unsatisfiable = true;
+      return false;
+    }
+  
+  c.simplify();
+  ClauseID id = m_clauseSet.addClause(c);
+  m_clauseSet.markPermanent(id);
+  if (!m_initialCheckDone) return true;        // initialClauseCheck will find any units
+
+  // literals whose weight is more than the slack are forced
+  int possible = c.sumCoefficients() - c.getRequired();
+  for (size_t i=0; i < c.size(); ++i)
+    if (c.getWeight(i) > possible) m_unitList.push(c.getLiteral(i),id);
+  
+  if (!unitPropagate()) m_unsatisfiable = true;
+  return !m_unsatisfiable;
+}
+
+
+/* The assumptions are decided before any branch decisions of our
+   own, in order, skipping any that are already satisfied.  Our own
+   decisions only come once all of them are satisfied, so if the
+   assignment falsifies one it follows from the constraints and the
+   assumptions decided before it.  In that case we return false.
+   Otherwise l is the next assumption to decide, or has atom 0 if
+   there isn't one.
+*/
+bool Solver::nextAssumption(Literal& l)
+{
+  l = Literal();
+  for (size_t i=0; i < m_solveAssumptions.size(); ++i)
+    {
+      Literal a = m_solveAssumptions[i];
+      if (!m_assignment.isValued(a.getAtom()))
+	{
+	  l = a;
+	  return true;
+	}
+      if (m_assignment.isUnsat(a))
+	{
+	  analyzeFailedAssumption(a);
+	  return false;
+	}
+    }
+  return true;
+}
+
+
+/* Walk back down the assignment stack from the failed assumption
+   following reasons.  Every decision we reach is an assumption that
+   helped falsify it.  Level 0 assignments follow from the
+   constraints alone so we stop there.
+*/
+void Solver::analyzeFailedAssumption(Literal failed)
+{
+  m_failedAssumptions.clear();
+  m_failedAssumptions.push_back(failed);
+  m_marked.clear();
+  m_marked.addAtom(failed.getAtom(),1);
+
+  for (int i=m_assignment.size() - 1; i >= 0; --i)
+    {
+      int atom = m_assignment.getAtom(i);
+      if (m_assignment.getLevel(atom) == 0) break;
+      if (!m_marked.contains(atom)) continue;
+
+      ClauseID id = m_assignment.getReason(atom);
+      if (id == 0)
+	{
+	  m_failedAssumptions.push_back(Literal(atom,m_assignment.getValue(atom)));
+	  continue;
+	}
       
+      m_clauseSet.initializeClause(m_strengthen1,id);
+      for (size_t j=0; j < m_strengthen1.size(); ++j)
+	{
+	  Literal l = m_strengthen1.getLiteral(j);
+	  if ((int)(l.getAtom()) == atom || !m_assignment.isValued(l.getAtom())) continue;
+	  if (m_strengthen1.isMod2() || m_assignment.isUnsat(l))
+	    m_marked.addIfAbsent(l.getAtom(),1);
+	}
+    }
+}
+
+
+
+/***************************** OPTIMIZATION ******************************/
+
+
+void Solver::setObjective(const vector<Literal>& lits, const vector<int>& weights, int offset)
+{
+  ASSERT(lits.size() == weights.size());
+  for (size_t i=0; i < weights.size(); ++i)
+    if (weights[i] <= 0) fatalError("improper weight in Solver::setObjective");
+  m_objectiveLits = lits;
+  m_objectiveWeights = weights;
+  m_objectiveOffset = offset;
+  m_hasObjective = true;
+}
+
+
+int Solver::optimize()
+{
+  m_haveModel = false;
+  m_lowerBound = m_objectiveOffset;
+  int outcome = lowerBoundWithCores();
+
+  while (outcome == SATISFIABLE && m_bestCost > m_lowerBound)
+    {
+      if (!addObjectiveBound(m_bestCost - 1)) outcome = UNSATISFIABLE;
+      else outcome = solve(vector<Literal>());
+      if (outcome == SATISFIABLE) recordModel();
+    }
+
+  if (m_haveModel)
+    {
+      // UNSAT means nothing beats the best model
+      if (outcome == UNSATISFIABLE || m_bestCost == m_lowerBound)
+	{
+	  m_lowerBound = m_bestCost;
+	  outcome = OPTIMUM_FOUND;
+	}
+      else outcome = SATISFIABLE;
+    }
+  m_statistics.outcome = outcome;
+  return outcome;
+}
+
+
+/* Assume every objective literal is false.  A failed assumption
+   core means at least one literal in it has to be true, so the
+   smallest weight in the core can be added to the lower bound.  The
+   core is added as a clause and its literals stop being assumed, so
+   the next core is disjoint from it.  Stops at the first model.
+*/
+int Solver::lowerBoundWithCores()
+{
+  vector<int> position(m_assignment.getNumberVariables() + 1,-1);
+  vector<Literal> assumptions;
+  for (size_t i=0; i < m_objectiveLits.size(); ++i)
+    {
+      position[m_objectiveLits[i].getAtom()] = i;
+      assumptions.push_back(m_objectiveLits[i].getNegation());
+    }
+
+  vector<Literal> core;
+  while (1)
+    {
+      int outcome = solve(assumptions);
+      if (outcome == SATISFIABLE) recordModel();
+      if (outcome != UNSATISFIABLE || m_failedAssumptions.empty()) return outcome;
+
+      int least = INT_MAX;
+      core.clear();
+      for (size_t i=0; i < m_failedAssumptions.size(); ++i)
+	{
+	  int j = position[m_failedAssumptions[i].getAtom()];
+	  least = min(least,m_objectiveWeights[j]);
+	  core.push_back(m_objectiveLits[j]);
+	  position[m_objectiveLits[j].getAtom()] = -1;
+	}
+      m_lowerBound += least;
+      cout << "c  lower bound " << m_lowerBound << " after "
+	   << zap::get_cpu_time() - zap::global_vars.start_time << " s" << endl;
+
+      size_t kept = 0;
+      for (size_t i=0; i < assumptions.size(); ++i)
+	if (position[assumptions[i].getAtom()] >= 0) assumptions[kept++] = assumptions[i];
+      assumptions.resize(kept);
+      if (!addClause(core)) return UNSATISFIABLE;
+    }
+}
+
+
+/* cost <= bound is the same as the negated objective literals
+   having total weight at least sum of weights - (bound - offset).
+   Every bound is tighter than the one before so there's no need
+   to take the old ones out.
+*/
+bool Solver::addObjectiveBound(int bound)
+{
+  int total = 0;
+  vector<Literal> negated;
+  for (size_t i=0; i < m_objectiveLits.size(); ++i)
+    {
+      total += m_objectiveWeights[i];
+      negated.push_back(m_objectiveLits[i].getNegation());
+    }
+  return addPBConstraint(negated,m_objectiveWeights,total - (bound - m_objectiveOffset));
+}
+
+
+int Solver::objectiveValue() const
+{
+  int cost = m_objectiveOffset;
+  for (size_t i=0; i < m_objectiveLits.size(); ++i)
+    if (!m_assignment.isUnsat(m_objectiveLits[i])) cost += m_objectiveWeights[i];
+  return cost;
+}
+
+
+void Solver::recordModel()
+{
+  int cost = objectiveValue();
+  if (m_haveModel && cost >= m_bestCost) return;
+  m_haveModel = true;
+  m_bestCost = cost;
+  m_bestModel.resize(m_assignment.getNumberVariables() + 1);
+  for (size_t i=1; i < m_bestModel.size(); ++i)
+    m_bestModel[i] = m_assignment.getValue(i);
+  if (!satisfiesInput(m_bestModel)) fatalError("the model doesn't satisfy the input in Solver::recordModel");
+  cout << "c  solution of cost " << cost << " after "
+       << zap::get_cpu_time() - zap::global_vars.start_time << " s" << endl;
+  cout << "o " << cost << endl;
+}
+
+
+// atoms no constraint mentions never got a name and are left out
+void Solver::printBestModel(ostream& os)
+{
+  for (size_t i=1; i < m_bestModel.size(); ++i)
+    {
+      string name = m_assignment.lookup(i);
+      if (name != "unknown") os << (m_bestModel[i] ? "" : "-") << name << " ";
     }
+  os << endl;
 }
 
 
@@ -129,10 +474,12 @@ bool Solver::learn()
 	{
 	  m_assignment.print();
 	  cout << endl << "Conflict with variable " << m_conflictAtom << endl;
-	  cout << "Reasons for conflict: " << endl << m_parent1 << m_parent2 << endl;
+	  cout << "Reasons for conflict: " << endl << m_parent1;
+	  if (m_binaryParent2) cout << "binary with " << m_binaryLiteral << endl;
+	  else cout << m_parent2 << endl;
 	}
 
-      if (m_parent1.isMod2() && m_parent2.isMod2())
+      if (m_parent1.isMod2() && m_parent2.isMod2() && !m_binaryParent2)
 	{
 	  if (!learnMod2Constraint()) return false;
 	}
@@ -141,7 +488,7 @@ bool Solver::learn()
 	  if (m_parent1.isMod2()) mod2ToDisjunction(m_parent1);
 	  else
 	    {
-	      if (m_parent2.isMod2()) mod2ToDisjunction(m_parent2);
+	      if (m_parent2.isMod2() && !m_binaryParent2) mod2ToDisjunction(m_parent2);
 	    }
 	  
 	  switch(m_settings.learnMethod)
@@ -159,20 +506,26 @@ bool Solver::learn()
 	{
 	  // if the clause is UIP then add to constaint set and we're done
 	  id = m_clauseSet.addClause(m_parent1);
+	  if (m_proof && !m_parent1.isMod2()) logConstraint(m_parent1);
+	  noteConflict();
+	  bumpConstraint(m_parent1);
+	  decayActivity();
 	  break;
 	}
       else
 	{
 	  // prepare to do another round of learn and backup
 	  int reasonID = m_assignment.getReason(m_atom1);
-	  m_clauseSet.initializeClause(m_parent2,reasonID);
 	  m_conflictAtom = m_atom1;
+	  initializeParent2(reasonID,m_conflictAtom);
 	  backjumpToAtom(m_atom1);
 	}
       
     }
 
   // backup to the level where the nogood would become unit
+  zap::global_vars.learned_sizes.add(m_parent1.size());
+  zap::global_vars.backjump_distances.add(m_assignment.getDecisionLevel() - m_level2);
   backjumpToLevel(m_level2);
 
   if (m_parent1.isMod2()) collectUnitPropsMod2(id);
@@ -184,6 +537,18 @@ bool Solver::learn()
 }
 
 
+/* Binary clause reasons are left in the clause set.  learnCardinality
+   resolves on them directly so we don't pay for building m_parent2.
+   The other learning methods get a real FastClause.
+*/
+void Solver::initializeParent2(ClauseID id, int atom)
+{
+  m_binaryParent2 = (!m_parent1.isMod2() && m_settings.learnMethod != 1 &&
+		     m_clauseSet.getBinaryReason(id,atom,m_binaryLiteral));
+  if (!m_binaryParent2) m_clauseSet.initializeClause(m_parent2,id);
+}
+
+
 void Solver::collectUnitProps(ClauseID id)
 {
   // there may be more than one unit propagation so get them all
@@ -231,15 +596,21 @@ void Solver::collectUnitPropsMod2(ClauseID id)
 
 bool Solver::learnCardinality()
 {
-  // determine if we need to weaken a constraint before combining them.
-  int coefficient1 = m_parent1.getValue(m_conflictAtom);
-  int coefficient2 = m_parent2.getValue(m_conflictAtom);
+  bumpActivity(m_conflictAtom);
+  if (m_binaryParent2)
+    m_parent1.resolveBinary(m_conflictAtom,m_binaryLiteral);
+  else
+    {
+      // determine if we need to weaken a constraint before combining them.
+      int coefficient1 = m_parent1.getValue(m_conflictAtom);
+      int coefficient2 = m_parent2.getValue(m_conflictAtom);
   
-  if ((abs(coefficient1) != 1) && (abs(coefficient2) != 1))
-    m_parent1.weakenToCardinality(m_assignment,m_conflictAtom);
+      if ((abs(coefficient1) != 1) && (abs(coefficient2) != 1))
+	m_parent1.weakenToCardinality(m_assignment,m_conflictAtom);
   
-  // generate a new constraint
-  m_parent1.resolve(m_parent2,m_conflictAtom);
+      // generate a new constraint
+      m_parent1.resolve(m_parent2,m_conflictAtom);
+    }
 
   if (m_settings.andrewOpt)
     {
@@ -310,6 +681,7 @@ bool Solver::learnCardinality()
 
 bool Solver::learnPBConstraint()
 {
+  bumpActivity(m_conflictAtom);
   // determine if we need to weaken a constraint before combining them.
   int coefficient1 = m_parent1.getValue(m_conflictAtom);
   int coefficient2 = m_parent2.getValue(m_conflictAtom);
@@ -479,6 +851,7 @@ void Solver::mod2ToDisjunction(FastClause& c)
   
   if (sum % 2 == c.getRequired()) c.increment(m_conflictAtom,-2);
   c.setRequired(1);
+  c.clearMod2();
 }
 
 
@@ -502,7 +875,9 @@ void Solver::strengthenConstraintSet()
       if (m_assumptions.size() == m_settings.strengthenBound)
 	{
 	  m_strengthen1.strengthen(m_assumptions);
+	  m_strengthen1.simplify();   // the clause sets expect the weights sorted
 	  int newID = m_clauseSet.addClause(m_strengthen1);
+	  if (m_proof) logConstraint(m_strengthen1);
 	  m_clauseSet.initializeClause(m_strengthen2,id);
 	  if (m_strengthen1.subsumes(m_strengthen2))
 	    m_clauseSet.removeClause(id);
@@ -565,10 +940,12 @@ void Solver::removeSubsumedClauses(vector<int>& reasonsToCheck, int newID)
 
 
 
+// strengthening derives constraints that unit propagation can't
+// check, so there's none of it when we're writing a proof
 void Solver::preprocess()
 {
   m_timer.initialize();
-  preprocessStrengthen();
+  if (m_proof == NULL) preprocessStrengthen();
   m_statistics.preprocessTime = m_timer.getElapsedTime();
 }
 
@@ -679,58 +1056,88 @@ Literal Solver::getRandomUnvalued()
   return Literal(candidates[(rand() % candidates.size())],coinFlip());
 }
 
-inline bool compare_var_stat(const pair<int,double> & v1, 
-			    const pair<int,double> & v2) 
-{	
-    if (v1.second > v2.second) return true;
-    return false;
+/* VSIDS: every atom has an activity that's bumped when it's resolved
+   away during conflict analysis and when it's in the learned
+   constraint.  Rather than decaying every activity after each
+   conflict we grow the bump, which does the same thing to the order,
+   and scale everything down when the numbers get too big.  The
+   activities start out as the number of times each atom occurs so the
+   first branches look the same as they always have.
+
+   The sign is the saved phase if there is one and otherwise the one
+   that occurs in more constraints, weighted towards recent ones by
+   reduceCounts.
+*/
+
+const double ACTIVITY_LIMIT = 1e100;
+
+
+void Solver::initializeActivity()
+{
+  size_t nv = m_assignment.getNumberVariables();
+  for (size_t i=1; i <= nv; ++i)
+    {
+      m_activity[i] = max(m_clauseSet.getLiteralCount(Literal(i,false)),
+			  m_clauseSet.getLiteralCount(Literal(i,true)));
+      m_order.update(i);
+    }
 }
 
 
-void Solver::updateVsidsCounts()
+void Solver::bumpActivity(int atom)
 {
-  size_t nv = m_assignment.getNumberVariables(); 
-  for (size_t i=1; i <= nv; ++i) {
-    m_vsidsScores[0][i] = m_clauseSet.getLiteralCount(Literal(i,false));
-    m_vsidsScores[1][i] = m_clauseSet.getLiteralCount(Literal(i,true));
-    bool bigger = (m_vsidsScores[1][i] > m_vsidsScores[0][i]);
-    m_sortedScores[i] = make_pair(int(i),(bigger ? m_vsidsScores[1][i] : m_vsidsScores[0][i]));
-  }
-  stable_sort(m_sortedScores.begin(), m_sortedScores.end(), compare_var_stat);
-  m_clauseSet.reduceCounts();
+  if ((m_activity[atom] += m_activityIncrement) > ACTIVITY_LIMIT)
+    {
+      for (size_t i=1, size=m_activity.size(); i < size; ++i)
+	m_activity[i] /= ACTIVITY_LIMIT;
+      m_activityIncrement /= ACTIVITY_LIMIT;
+    }
+  m_order.update(atom);
+}
+
+
+void Solver::bumpConstraint(const FastClause& c)
+{
+  for (size_t i=0, size=c.size(); i < size; ++i)
+    bumpActivity(c.getAtom(i));
+}
+
+
+void Solver::decayActivity()
+{
+  m_activityIncrement /= m_settings.activityDecay;
 }
 
 
 Literal Solver::getVsidsLiteral()
 {
-  size_t size = m_sortedScores.size();
-  int atom = 0;
-  for (size_t i= 0; i < size; ++i)
+  // valued atoms are only thrown out when they get to the top
+  while (m_assignment.isValued(m_order.top())) m_order.removeTop();
+  int atom = m_order.removeTop();
+
+  // reduce the randomness but not below the base value
+  m_settings.randomness--;
+  if (m_settings.randomness < m_settings.baseRandomness)
+    m_settings.randomness = m_settings.baseRandomness;
+
+  int randomness = m_settings.randomness;
+  int freeCount = m_assignment.getNumberFreeVariables();
+  if (randomness >= freeCount)
+    randomness = freeCount - 1;
+  int skip = rand() % (1 + randomness);
+  while (skip > 0)
     {
-      atom = m_sortedScores[i].first;
-      if (!m_assignment.isValued(atom))
-	{ 
-	  // reduce the randomness but not below the base value
-	  m_settings.randomness--;
-	  if (m_settings.randomness < m_settings.baseRandomness)
-	    m_settings.randomness = m_settings.baseRandomness;
-
-	  int randomness = m_settings.randomness;
-	  int freeCount = m_assignment.getNumberFreeVariables();
-	  if (randomness >= freeCount)
-	    randomness = freeCount - 1;
-	  int skip = rand() % (1 + randomness);
-	  int index = i;
-	  while (skip > 0)
-	    {
-	      index++;
-	      atom = m_sortedScores[index].first;
-	      if (!m_assignment.isValued(atom)) skip--;
-	    }
-	  break;
-	}
+      m_skipped.push_back(atom);
+      atom = m_order.removeTop();
+      if (!m_assignment.isValued(atom)) skip--;
     }
-  return Literal(atom,(m_vsidsScores[1][atom] > m_vsidsScores[0][atom]));
+  for (size_t i=0; i < m_skipped.size(); ++i) m_order.insert(m_skipped[i]);
+  m_skipped.clear();
+
+  if (m_settings.phaseSaving && m_savedPhase[atom] != 0)
+    return Literal(atom,m_savedPhase[atom] > 0);
+  return Literal(atom,(m_clauseSet.getLiteralCount(Literal(atom,true)) >
+		       m_clauseSet.getLiteralCount(Literal(atom,false))));
 }
 
 
@@ -740,18 +1147,93 @@ Literal Solver::getVsidsLiteral()
 
 void Solver::restart()
 {
-  if (m_assignment.getDecisionLevel() > 0)
+  m_clauseSet.reduceCounts();
+  m_unitList.clear();
+  backjumpToLevel(0);
+  m_statistics.restartCount++;
+  scheduleRestart();
+}
+
+
+
+/* Restarts are driven by conflicts, not the clock, so a run restarts
+   at the same places on any machine.
+
+   RESTART_LUBY restarts after lubyUnit times the next term of the Luby
+   sequence 1 1 2 1 1 2 4 1 1 2 ... conflicts, like zap does.
+
+   RESTART_LBD keeps a fast and a slow exponential moving average of the
+   number of decision levels in each learned constraint (its LBD) and
+   restarts when the fast one gets 25% above the slow one.  The
+   constraints we're learning are worse than usual so the search has
+   probably wandered somewhere unproductive.  At least LBD_MIN_CONFLICTS
+   conflicts go by between restarts so the fast average means something.
+*/
+
+const long LBD_MIN_CONFLICTS = 50;
+const double LBD_FAST_DECAY = 1.0 / 32;
+const double LBD_SLOW_DECAY = 1.0 / 16384;
+const double LBD_MARGIN = 1.25;
+
+
+long luby(long i)
+{
+  long size = 1, k = 0;   // find the finite subsequence containing i and its size
+  while (size < i + 1)
+    {
+      k++;
+      size = 2 * size + 1;
+    }
+  while (size - 1 != i)
+    {
+      size = (size - 1) >> 1;
+      k--;
+      i = i % size;
+    }
+  return 1L << k;
+}
+
+
+void Solver::scheduleRestart()
+{
+  m_conflictsSinceRestart = 0;
+  m_nextRestart = m_settings.lubyUnit * luby(m_statistics.restartCount);
+}
+
+
+// the LBD of the constraint we just learned is the number of
+// different decision levels among its literals
+void Solver::noteConflict()
+{
+  m_conflictsSinceRestart++;
+  if (m_settings.restartPolicy != RESTART_LBD) return;
+
+  m_stamp++;
+  int lbd = 0;
+  for (size_t i=0, size=m_parent1.size(); i < size; ++i)
     {
-      for (std::size_t i=1, size=m_vsidsScores[0].size(); i<size; ++i)
+      int level = m_assignment.getLevel(m_parent1.getAtom(i));
+      if (m_levelStamps[level] != m_stamp)
 	{
-	  m_vsidsScores[0][i] = 0;
-	  m_vsidsScores[1][i] = 0;
+	  m_levelStamps[level] = m_stamp;
+	  lbd++;
 	}
     }
-  updateVsidsCounts();
-  m_unitList.clear();
-  backjumpToLevel(0);
-  
+  m_lbdFast += LBD_FAST_DECAY * (lbd - m_lbdFast);
+  m_lbdSlow += LBD_SLOW_DECAY * (lbd - m_lbdSlow);
+}
+
+
+bool Solver::timeToRestart() const
+{
+  switch (m_settings.restartPolicy)
+    {
+    case RESTART_LUBY: return m_conflictsSinceRestart >= m_nextRestart;
+    case RESTART_LBD:
+      return (m_conflictsSinceRestart >= LBD_MIN_CONFLICTS &&
+	      m_lbdFast > LBD_MARGIN * m_lbdSlow);
+    default: return false;
+    }
 }
 
 
@@ -763,15 +1245,126 @@ void Solver::initialize(size_t size)
   m_unitList.initialize(size);
   m_parent1.initialize(size);
   m_parent2.initialize(size);
+  m_binaryParent2 = false;
   m_strengthen1.initialize(size);
   m_strengthen2.initialize(size);
   m_assumptions.initialize(size);
-  for (size_t i=0; i < size; i++)
+  m_marked.initialize(size);
+  m_newConstraint.initialize(size);
+  m_unsatisfiable = false;
+  m_initialCheckDone = false;
+  m_objectiveLits.clear();
+  m_objectiveWeights.clear();
+  m_objectiveOffset = 0;
+  m_hasObjective = false;
+  m_lowerBound = 0;
+  m_bestCost = 0;
+  m_haveModel = false;
+  m_savedPhase.assign(size,0);
+  m_levelStamps.assign(size + 1,0);
+  m_stamp = 0;
+  m_lbdFast = 0;
+  m_lbdSlow = 0;
+  m_statistics.restartCount = 0;
+  scheduleRestart();
+  m_activity.assign(size,0.0);
+  m_activityIncrement = 1.0;
+  m_order.initialize(size,&m_activity);
+  for (size_t i=1; i < size; i++) m_order.insert(i);
+  m_proof = NULL;
+  m_proofConstraints = 0;
+  m_numberInputConstraints = 0;
+  m_clausalInput = true;
+  m_propagateCalls = 0;
+}
+
+
+
+// the parsers add the input through here so we know whether we can write a proof
+void Solver::addInputConstraint(FastClause& c)
+{
+  if (c.isMod2() || c.getRequired() != 1) m_clausalInput = false;
+  m_clauseSet.addClause(c);
+}
+
+
+/* We can only certify learned clauses, which the checker confirms by
+   unit propagation.  Learning from cardinality or PB constraints, or
+   learning PB constraints at all, weakens and divides, and the result
+   would need "p" steps.
+*/
+bool Solver::canCertify() const
+{
+  return m_clausalInput && m_settings.learnMethod != 1;
+}
+
+
+/* VeriPB numbers the input constraints 1 to n in the order they
+   appear in the file and each constraint we add gets the next id.
+   Atoms are named the way the input named them, with an x in front
+   of the DIMACS numbers of a CNF file.
+*/
+void Solver::setProof(zap::ProofWriter* proof)
+{
+  if (!canCertify()) fatalError("no proofs for this input or learn method in Solver::setProof");
+  m_proof = proof;
+  m_proofConstraints = m_numberInputConstraints;
+  size_t nv = m_assignment.getNumberVariables();
+  m_proofNames.assign(nv + 1,string());
+  for (size_t i=1; i <= nv; ++i)
+    {
+      string name = m_assignment.lookup(int(i));
+      if (name == "unknown") name = "x" + zap::global_vars.atom_name_map.lookup(i);
+      m_proofNames[i] = name;
+    }
+  *m_proof << "pseudo-Boolean proof version 1.2\nf " << long(m_numberInputConstraints) << "\n";
+}
+
+
+void Solver::logConstraint(const FastClause& c)
+{
+  if (c.getRequired() != 1) fatalError("a learned constraint isn't a clause in Solver::logConstraint");
+  *m_proof << "u";
+  for (size_t i=0, size=c.size(); i < size; ++i)
     {
-      m_sortedScores.push_back(pair<int,double>(0,0.0));
-      m_vsidsScores[0].push_back(0.0);
-      m_vsidsScores[1].push_back(0.0);
+      *m_proof << " " << long(c.getWeight(i)) << (c.getSign(i) ? " " : " ~")
+	       << m_proofNames[c.getAtom(i)];
     }
+  *m_proof << " >= " << long(c.getRequired()) << " ;\n";
+  m_proofConstraints++;
+}
+
+
+
+/* Preprocessing and the clause sets rewrite the constraints, so the
+   model is checked against the .opb file as it was read.  A CNF file
+   isn't kept and any model passes.
+*/
+bool Solver::satisfiesInput(const vector<bool>& model) const
+{
+  size_t begin = 0;
+  for (size_t i=0; i < m_inputRequired.size(); ++i)
+    {
+      int sum = 0;
+      for (size_t j=begin; j < m_inputEnds[i]; ++j)
+	if (model[m_inputLits[j].getAtom()] == m_inputLits[j].getSign()) sum += m_inputWeights[j];
+      if (sum < m_inputRequired[i]) return false;
+      begin = m_inputEnds[i];
+    }
+  return true;
+}
+
+
+// with an objective it's the best model found that gets printed
+void Solver::checkModel() const
+{
+  vector<bool> model(m_assignment.getNumberVariables() + 1,false);
+  if (m_hasObjective) model = m_bestModel;
+  else
+    for (size_t i=1; i < model.size(); ++i)
+      if (m_assignment.isValued(i)) model[i] = m_assignment.getValue(i);
+  if (!satisfiesInput(model)) fatalError("the model doesn't satisfy the input in Solver::checkModel");
+  cout << "c  model checked against the input constraints" << endl;
 }
 
 
@@ -785,22 +1378,12 @@ void Solver::runPeriodicFunctions()
   if (m_statistics.backtrackCount % m_settings.deletionInterval == 0)
     m_clauseSet.deleteIrrelevantClauses();
 
-  if (m_settings.allowRestarts && m_statistics.backtrackCount > m_settings.nextRestartBacktrack)
+  if (m_assignment.getDecisionLevel() > 0 && timeToRestart())
     {
-      m_settings.nextRestartBacktrack += m_settings.restartBacktrackInc;
-      m_settings.restartBacktrackInc += m_settings.restartBacktrackIncInc;
-      float current = m_timer.getElapsedTime();
-      if (current > m_settings.nextRestartTime)
-	{
-	  cout << "restart...... " << endl;
-	  m_settings.nextRestartTime = int(current) + m_settings.restartTimeInc;
-	  m_settings.restartTimeInc += m_settings.restartTimeIncInc;
-	  m_settings.randomness = m_settings.restartRandomness;
-	  restart();
-	}
+      if (m_settings.verbosity) cout << "restart...... " << endl;
+      m_settings.randomness = m_settings.restartRandomness;
+      restart();
     }
-  if (m_statistics.nodeCount % m_settings.vsidsUpdateInterval == 0)
-    updateVsidsCounts();
 }
 
 // works but needs cleaning
@@ -818,16 +1401,8 @@ int Solver::ISAMPwithLearning()
       if (m_assignment.isFull()) return SATISFIABLE;
       else
 	if (!backtrack()) return UNSATISFIABLE;
-      if (m_assignment.getDecisionLevel() > 0)
-	{
-	  for (std::size_t i=1, size=m_vsidsScores[0].size(); i<size; ++i)
-	    {
-	      m_vsidsScores[0][i] = 0;
-	      m_vsidsScores[1][i] = 0;
-	    }
-	  m_unitList.clear();
-	}
-      updateVsidsCounts();
+      if (m_assignment.getDecisionLevel() > 0) m_unitList.clear();
+      m_clauseSet.reduceCounts();
       backjumpToLevel(0);
     }
 }
@@ -840,18 +1415,19 @@ void Solver::load_to_structures(const zap::Cnf& clauses)
 {
   size_t nv = zap::global_vars.atom_name_map.size();
   initialize(nv + 1);
+  m_numberInputConstraints = clauses.number_clauses();
   FastClause a(nv + 1);
 
   m_clauseSet.setStrengthen(true);
   
-  for (size_t i=0; i < clauses.size(); i++) {
+  for (size_t i=0; i < clauses.number_clauses(); i++) {
 	if (clauses[i].size() == 0) continue;
 	a.clear();
 	for (size_t j=0; j < clauses[i].size(); j++) {
 	  a.addIfAbsent(clauses[i][j].variable(),(clauses[i][j].sign() ? 1 : -1));
 	}
 	a.setRequired(1);
-	m_clauseSet.addClause(a);
+	addInputConstraint(a);
   }
 
   m_clauseSet.setInitialClauseCount();
@@ -1038,7 +1614,7 @@ void Solver::parse(const char * filename) {
 		}
 	      b.setRequired(sum - a.getRequired());
 	      b.simplify();
-	      m_clauseSet.addClause(b);
+	      addInputConstraint(b);
 	    }
 	  a.simplify();
 	  int sum = a.sumCoefficients();
@@ -1049,7 +1625,7 @@ void Solver::parse(const char * filename) {
 	      exit(1);
 	    }
 	}
-      m_clauseSet.addClause(a);
+      addInputConstraint(a);
       
       ClauseCount++;
       if (ClauseCount == nc) break;
@@ -1059,6 +1635,66 @@ void Solver::parse(const char * filename) {
 }
 
 
+/* The rest of an objective line "min: +3 x1 -2 ~x2 ... ;" after the
+   'm'.  A negative weight -w on l is the constant -w plus w on the
+   negation of l, so every weight given to setObjective is positive.
+   seen is just used to catch an atom that appears twice.
+*/
+void Solver::parseObjective(const char* text, const char* filename, int lineNumber,
+			    int nv, FastClause& seen)
+{
+  istringstream line(text);
+  string word, variableName;
+  vector<Literal> lits;
+  vector<int> weights;
+  int offset = 0;
+
+  line >> word;   // "in:"
+  seen.clear();
+  while (line >> word && word != ";")
+    {
+      int weight = atoi(word.c_str());
+      if (!(line >> variableName)) break;
+      bool last = (variableName[variableName.size() - 1] == ';');
+      if (last) variableName.erase(variableName.size() - 1);
+      bool sign = true;
+      if (variableName[0] == '~')
+	{
+	  variableName.erase(0,1);
+	  sign = false;
+	}
+      int varID = m_assignment.lookup(variableName);
+      if (varID > nv)
+	{
+	  cout << filename << " : line " << lineNumber << " : " << "atom value "
+	       << variableName << " : " << varID << " greater than number of atoms "
+	       << nv << endl;
+	  exit(1);
+	}
+      if (seen.addIfAbsent(varID,1))
+	{
+	  cout << filename << " : line " << lineNumber << " : "
+	       << "atom identifier " << variableName
+	       << " appears twice in objective " << endl;
+	  exit(1);
+	}
+      if (weight < 0)
+	{
+	  offset += weight;
+	  weight = -weight;
+	  sign = !sign;
+	}
+      if (weight != 0)
+	{
+	  lits.push_back(Literal(varID,sign));
+	  weights.push_back(weight);
+	}
+      if (last) break;
+    }
+  setObjective(lits,weights,offset);
+}
+
+
 void getToken(string &token, string &line, string delimiters)
 {
   string::size_type begIdx = line.find_first_not_of(delimiters);
@@ -1110,6 +1746,7 @@ void Solver::parseOPB(const char * filename) {
     }
 
   initialize(nv + 1);
+  m_numberInputConstraints = nc;
   FastClause a(nv + 1);
   FastClause b(nv + 1);
 
@@ -1120,11 +1757,17 @@ void Solver::parseOPB(const char * filename) {
       exit(1);
     }
     infile >> c;
-    if ((c == '*') || (c == 'm')) {  // skip comments and "min" line... It might work
+    if (c == '*') {  // skip comments
       infile.getline(buffer,5000);
       lineNumber++;
       continue;
     }
+    if (c == 'm') {  // the "min:" line
+      infile.getline(buffer,5000);
+      parseObjective(buffer,filename,lineNumber,nv,b);
+      lineNumber++;
+      continue;
+    }
     else infile.putback(c);
 
     a.clear();
@@ -1177,17 +1820,23 @@ void Solver::parseOPB(const char * filename) {
       }
     } while (1);
 
+    for (size_t i=0; i < a.size(); ++i)
+      {
+	m_inputLits.push_back(a.getLiteral(i));
+	m_inputWeights.push_back(a.getWeight(i));
+      }
+    m_inputEnds.push_back(m_inputLits.size());
+    m_inputRequired.push_back(required);
     a.setRequired(required);
     a.simplify();
     int sum = a.sumCoefficients();
-    if (sum < required)
+    if (sum < a.getRequired())   // simplify may have divided the weights
       {
 	cout << filename << " : line " << lineNumber << " : "
 	     << "UNSAT clause" << endl;
 	exit(1);
       }
-    a.print();
-    m_clauseSet.addClause(a);
+    addInputConstraint(a);
     
     ClauseCount++;
     if (ClauseCount == nc) break;
@@ -12,7 +12,9 @@
 #include "ImplicationList.h"
 #include "ClauseSet.h"
 #include "TimeTracker.h"
+#include "ActivityHeap.h"
 #include "Cnf.h"
+#include "ProofWriter.h"
 
 enum SolutionStatus {
     UNDETERMINED,
@@ -20,7 +22,15 @@ enum SolutionStatus {
     SATISFIABLE,
     TIME_OUT,
     MEMORY_OUT,
-    ABORTED
+    ABORTED,
+    OPTIMUM_FOUND
+};
+
+// when to restart, all of them count conflicts so runs are repeatable
+enum RestartPolicy {
+    RESTART_LUBY,     // after lubyUnit times the next term of the Luby sequence
+    RESTART_LBD,      // when recent learned constraints span more levels than usual
+    RESTART_NONE
 };
 
 // simple struct to hold statistics
@@ -31,6 +41,7 @@ public:
   double runTime;
   double preprocessTime;
   long backtrackCount;
+  long restartCount;
   int outcome;
 
   SolverStatistics() :
@@ -38,6 +49,7 @@ public:
     runTime(0.0),
     preprocessTime(0.0),
     backtrackCount(0),
+    restartCount(0),
     outcome(UNDETERMINED) {}
 };
 
@@ -51,17 +63,13 @@ public:
   std::size_t strengthenBound;
   double timeLimit;
   int deletionInterval;
-  int vsidsUpdateInterval;
+  double activityDecay;
   int randomness;
   int baseRandomness;
-  bool allowRestarts;
-  int nextRestartTime;
-  int restartTimeInc;
-  int restartTimeIncInc;
-  int nextRestartBacktrack;
-  int restartBacktrackInc;
-  int restartBacktrackIncInc;
+  int restartPolicy;
+  int lubyUnit;
   int restartRandomness;
+  bool phaseSaving;
   bool failedLiteral;
   bool andrewOpt;
 
@@ -72,17 +80,13 @@ public:
     strengthenBound(1),
     timeLimit(24 * 3600),
     deletionInterval(5000),
-    vsidsUpdateInterval(256),
+    activityDecay(0.95),
     randomness(0),
     baseRandomness(0),
-    allowRestarts(true),
-    nextRestartTime(50),
-    restartTimeInc(0),
-    restartTimeIncInc(0),
-    nextRestartBacktrack(0),
-    restartBacktrackInc(40000),
-    restartBacktrackIncInc(100),
+    restartPolicy(RESTART_LUBY),
+    lubyUnit(100),
     restartRandomness(0),
+    phaseSaving(true),
     failedLiteral(false),
     andrewOpt(true) {}
 };
@@ -94,6 +98,39 @@ public:
 
   PURPOSE: Main Solver class.
 
+  INCREMENTAL USE: A Solver can be solved more than once.  Clauses
+  and pseudo-Boolean constraints can be added between calls with
+  addClause and addPBConstraint, and solve can be given a vector of
+  assumption literals.  Assumptions are made as the first branch
+  decisions.  If there's no solution under them solve returns
+  UNSATISFIABLE and getFailedAssumptions gives the subset of the
+  assumptions that was used to show it (empty if the constraints
+  are UNSAT on their own).  Learned constraints never depend on the
+  assumptions, so they are kept from one call to the next.
+  Constraints added between calls are marked permanent so the
+  clause sets never delete them as irrelevant.
+
+  OPTIMIZATION: Given an objective with setObjective (parseOPB reads
+  the "min:" line of an .opb file) optimize minimizes it.  First the
+  objective literals are all assumed false and each failed assumption
+  core found raises the lower bound by its smallest weight.  The core's
+  literals are then dropped from the assumptions, so the cores are
+  disjoint and the bound is sound, until a model is found.  Then each
+  model's cost c tightens the objective bound with a new constraint
+  saying the cost is at most c - 1, until that's UNSAT or the cost
+  meets the lower bound.  Each improvement is printed as it is found.
+
+  PROOFS: Given a ProofWriter (setProof) we write a VeriPB style log
+  of an UNSAT answer.  The input constraints are loaded with "f",
+  every learned clause is added as a "u" step, which the checker
+  confirms by unit propagation, and an UNSAT answer ends with the
+  contradiction "u >= 1 ;" and "c".  Cardinality and PB constraints
+  learned by weakening and dividing would need "p" derivations, so
+  only clausal inputs with learn method 0 can be certified (see
+  canCertify), which learns nothing but clauses from them.
+  Deletions aren't logged and preprocessing doesn't strengthen
+  anything.  Only plain solves are certified, not assumptions or
+  optimization.
 
 **************************************************************************/
 class Solver {
@@ -109,6 +146,8 @@ protected:
   // for conflict analysis
   FastClause m_parent1;
   FastClause m_parent2;
+  bool m_binaryParent2;   // m_parent2 is the binary clause m_conflictAtom v m_binaryLiteral
+  Literal m_binaryLiteral;
   int m_conflictAtom;
   int m_atom1;
   int m_atom2;
@@ -119,12 +158,55 @@ protected:
   FastClause m_strengthen1;
   FastClause m_strengthen2;
   AtomValueMap m_assumptions;
+
+  // for incremental solving
+  std::vector<Literal> m_solveAssumptions;
+  std::vector<Literal> m_failedAssumptions;
+  AtomValueMap m_marked;
+  FastClause m_newConstraint;
+  bool m_unsatisfiable;         // UNSAT without any assumptions
+  bool m_initialCheckDone;
+
+  // for optimization (objective is offset + sum of weights of true literals)
+  std::vector<Literal> m_objectiveLits;
+  std::vector<int> m_objectiveWeights;
+  int m_objectiveOffset;
+  bool m_hasObjective;          // a "min:" line with no weights is still an objective
+  int m_lowerBound;
+  int m_bestCost;
+  bool m_haveModel;
+  std::vector<bool> m_bestModel;
   
   // for vsids branching heuristic
-  std::vector<double> m_vsidsScores[2];
-  std::vector<std::pair<int,double> > m_sortedScores;
+  std::vector<double> m_activity;
+  double m_activityIncrement;        // grows by 1/activityDecay each conflict
+  ActivityHeap m_order;              // every unvalued atom and maybe some valued ones
+  std::vector<int> m_skipped;        // atoms passed over by a random branch
+  std::vector<int> m_savedPhase;     // the value each atom had when we last backed over it
+
+  // for restarts
+  long m_conflictsSinceRestart;
+  long m_nextRestart;                // conflicts until the next Luby restart
+  double m_lbdFast;                  // moving averages of the learned constraints' LBD
+  double m_lbdSlow;
+  std::vector<int> m_levelStamps;    // for counting the levels in a constraint
+  int m_stamp;
+
+  // for proof logging
+  zap::ProofWriter* m_proof;
+  long m_proofConstraints;           // VeriPB ids handed out so far
+  int m_numberInputConstraints;
+  bool m_clausalInput;               // no cardinality, PB or parity constraints in the input
+  std::vector<std::string> m_proofNames;
+
+  // the constraints of an .opb file as read, for checking models
+  std::vector<Literal> m_inputLits;
+  std::vector<int> m_inputWeights;
+  std::vector<std::size_t> m_inputEnds;  // constraint i ends at m_inputEnds[i]
+  std::vector<int> m_inputRequired;
 
   TimeTracker m_timer;
+  std::size_t m_propagateCalls;      // so we only time some of them
 
   int realSolve();
   bool unitPropagate();
@@ -132,8 +214,21 @@ protected:
   void backjumpToLevel(int);
   void backjumpToAtom(int);
   
+  // incremental solving
+  bool addConstraint(FastClause&);
+  bool nextAssumption(Literal&);
+  void analyzeFailedAssumption(Literal);
+
+  // optimization
+  int lowerBoundWithCores();
+  bool addObjectiveBound(int);
+  int objectiveValue() const;
+  void recordModel();
+  void parseObjective(const char*, const char*, int, int, FastClause&);
+  
   // conflict analysis
   bool learn();
+  void initializeParent2(ClauseID,int);
   void collectUnitProps(ClauseID);
   void collectUnitPropsMod2(ClauseID);
   bool learnCardinality();
@@ -155,13 +250,21 @@ protected:
   Literal getVsidsLiteral();
   Literal getFirstUnvalued();
   Literal getRandomUnvalued();
-  void updateVsidsCounts();
+  void initializeActivity();
+  void bumpActivity(int);
+  void bumpConstraint(const FastClause&);
+  void decayActivity();
 
   // miscellaneous
   void initialize(std::size_t);
   void runPeriodicFunctions();
+  bool timeToRestart() const;
+  void scheduleRestart();
+  void noteConflict();
   void restart();
   int ISAMPwithLearning();
+  void logConstraint(const FastClause&);
+  void addInputConstraint(FastClause&);
 
 public:
 
@@ -171,6 +274,22 @@ public:
   
   void preprocess();
   void solve();
+
+  // incremental interface
+  void setNumberVariables(std::size_t n) { initialize(n + 1); }
+  bool addClause(const std::vector<Literal>&);
+  bool addPBConstraint(const std::vector<Literal>&, const std::vector<int>&, int);
+  int solve(const std::vector<Literal>& assumptions);
+  const std::vector<Literal>& getFailedAssumptions() const { return m_failedAssumptions; }
+  bool getValue(std::size_t atom) const { return m_assignment.getValue(atom); }
+
+  // optimization
+  void setObjective(const std::vector<Literal>&, const std::vector<int>&, int offset = 0);
+  bool hasObjective() const { return m_hasObjective; }
+  int optimize();
+  int getBestCost() const { return m_bestCost; }
+  int getLowerBound() const { return m_lowerBound; }
+  void printBestModel(std::ostream& os = std::cout);
   
   void setVerbosity(bool b) { m_settings.verbosity = b; }
   void setTimeLimit(int i) { m_settings.timeLimit = (double)(i); }
@@ -178,8 +297,14 @@ public:
   void setLearnMethod(int i) { m_settings.learnMethod = i; }
   void setFailedLiteral(bool b) { m_settings.failedLiteral = b; }
   void setAndrewOpt(bool b) { m_settings.andrewOpt = b; }
+  void setRestartPolicy(int i) { m_settings.restartPolicy = i; }
+  void setPhaseSaving(bool b) { m_settings.phaseSaving = b; }
+  bool canCertify() const;
+  void setProof(zap::ProofWriter*);
 
   void printAssignment() const { m_assignment.printListForm(); }
+  bool satisfiesInput(const std::vector<bool>&) const;
+  void checkModel() const;
   const SolverStatistics& getSolverStatistics() const { return m_statistics; }
   const ClauseSetStatistics& getClauseSetStatistics() { return m_clauseSet.getStatistics();}
 };
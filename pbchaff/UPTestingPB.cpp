@@ -0,0 +1,94 @@
+////////////////////////////   UP TESTING  ///////////////////////////////////////////////////////////////////
+/*
+  pbchaff's implementation of the UPTestingInterface.  DPLL without learning, so we drive the
+  Solver's unit list, assignment and clause set directly and never call learn.  The other value
+  of a branch we back over goes in with UPT_FORCED as its reason.  It mustn't be 0 or the
+  PartialAssignment would count it as a new decision, and since we never analyze a conflict
+  nobody looks at it.
+*/
+#include "UPTestingPB.h"
+#include "Solver.h"
+
+const ClauseID UPT_FORCED = -1;
+
+
+class PBDPLLSolver : public Solver, public virtual zap::UPTestingInterface
+{
+public:
+  PBDPLLSolver(const zap::Cnf& clauses) { load_to_structures(clauses); }
+
+  zap::AnnotatedLiteral upt_local_select_branch();
+  bool                  upt_assignment_is_full();
+  zap::Result           upt_unit_propagate(zap::AnnotatedLiteral l);
+  zap::Result           upt_undo_decision(zap::AnnotatedLiteral& l);
+  zap::Result           upt_preprocess();
+};
+
+
+
+zap::UPTestingInterface* new_pbchaff_dpll(const zap::Cnf& clauses)
+{
+  return new PBDPLLSolver(clauses);
+}
+
+
+
+zap::AnnotatedLiteral PBDPLLSolver::upt_local_select_branch()
+{
+  Literal l = getVsidsLiteral();
+  return zap::AnnotatedLiteral(zap::Literal(l.getAtom(),l.getSign()));
+}
+
+
+bool PBDPLLSolver::upt_assignment_is_full()
+{
+  return m_assignment.isFull();
+}
+
+
+// like Solver::unitPropagate but we count the queue pops the way zap does and we don't
+// set up the conflict for learning
+zap::Result PBDPLLSolver::upt_unit_propagate(zap::AnnotatedLiteral l)
+{
+  if (m_assignment.isValued(l.variable())) return zap::SUCCESS;  // zap's Assignment ignores these too
+  m_unitList.push(Literal(l.variable(),l.sign()),(l.reason().is_branch() ? 0 : UPT_FORCED));
+
+  while (!m_unitList.empty())
+    {
+      std::pair<Literal,int> p = m_unitList.pop();
+      zap::global_vars.queue_pops++;
+      m_assignment.push(p.first,p.second);
+      if (!m_clauseSet.getImplications(p.first,m_unitList))
+	{
+	  m_unitList.clear();
+	  return zap::CONTRADICTION;
+	}
+    }
+  return zap::SUCCESS;
+}
+
+
+// undo the current decision level and pass back the other value of its branch
+zap::Result PBDPLLSolver::upt_undo_decision(zap::AnnotatedLiteral& l)
+{
+  int level = m_assignment.getDecisionLevel();
+  if (level == 0) return zap::FAILURE;
+
+  Literal branch;
+  for (int i = m_assignment.size() - 1; i >= 0; --i)
+    {
+      branch = m_assignment.getLiteral(i);
+      if (m_assignment.getReason(branch.getAtom()) == 0) break;
+    }
+  backjumpToLevel(level - 1);
+  l = zap::AnnotatedLiteral(zap::Literal(branch.getAtom(),!branch.getSign()),zap::Reason(true));  // not a branch, as in zap
+  return zap::SUCCESS;
+}
+
+
+zap::Result PBDPLLSolver::upt_preprocess()
+{
+  m_initialCheckDone = true;
+  initializeActivity();
+  return initialClauseCheck() ? zap::SUCCESS : zap::CONTRADICTION;
+}
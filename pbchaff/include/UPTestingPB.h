@@ -0,0 +1,17 @@
+////////////////////////////   UP TESTING  ///////////////////////////////////////////////////////////////////
+/*
+  pbchaff's side of the UP testing framework (see front_end/include/UPTesting.h).  The pbchaff Solver
+  is hidden behind the UPTestingInterface so other programs can run pbchaff's unit propagation on the
+  same branch decisions as zap's clause sets without seeing pbchaff's own Literal and ClauseSet classes,
+  which would clash with zap's.
+*/
+#ifndef _UP_TESTING_PB_H
+#define _UP_TESTING_PB_H
+
+#include "UPTesting.h"
+#include "Cnf.h"
+
+// a pbchaff Solver loaded with the clauses and ready for upt_dpll.  The caller deletes it.
+zap::UPTestingInterface* new_pbchaff_dpll(const zap::Cnf& clauses);
+
+#endif
@@ -138,8 +138,31 @@ int main(int argc, char *argv[]) {
 //   if (opbFormat) s.parseOPB(filename.data());
 //   else s.parse(filename.data());
 
-  zap::Cnf clauses = zap::read_cnf(argc,argv);
-  s.load_to_structures(clauses);
+  filename = argv[1];
+  opbFormat = (filename.size() > 4 && filename.compare(filename.size() - 4,4,".opb") == 0);
+  if (opbFormat)
+    {
+      zap::read_testing_params(argc,argv);
+      s.parseOPB(filename.c_str());
+    }
+  else
+    {
+      zap::Cnf clauses = zap::read_cnf(argc,argv);
+      s.load_to_structures(clauses);
+    }
+  s.setRestartPolicy(zap::global_vars.restart_policy);   // the flags are read with the input
+  zap::ProofWriter* proof = NULL;
+  if (zap::global_vars.proof_file.size())
+    {
+      if (s.hasObjective()) cout << "c  No proof is written for optimization problems" << endl;
+      else if (!s.canCertify())
+	cout << "c  No proof is written for cardinality, pseudo-Boolean or parity constraints" << endl;
+      else
+	{
+	  proof = new zap::ProofWriter(zap::global_vars.proof_file);
+	  s.setProof(proof);
+	}
+    }
   zap::global_vars.start_time = zap::get_cpu_time();
   
   if (preprocess)
@@ -158,7 +181,9 @@ int main(int argc, char *argv[]) {
 	   << endl << endl << endl;
     }
   
-  s.solve();
+  if (s.hasObjective()) s.optimize();
+  else s.solve();
+  delete proof;   // waits for the last of the proof to be written
 
   zap::global_vars.solution_time = zap::get_cpu_time() - zap::global_vars.start_time;
 
@@ -168,18 +193,31 @@ int main(int argc, char *argv[]) {
   cout << "c  --------------------------------------------" << endl;
   cout << setw(30) << "c  Node count" << setw(15) << stats.nodeCount << endl;
   cout << setw(30) << "c  Backtrack count" << setw(15) << stats.backtrackCount << endl;
+  cout << setw(30) << "c  Restart count" << setw(15) << stats.restartCount << endl;
   cout << setw(30) << "c  Initial Clause Count" << setw(15) << clauseStats.initialClauseCount << endl;
   cout << setw(30) << "c  Added Clauses" << setw(15) << clauseStats.addedClauseCount << endl;
   cout << setw(30) << "c  Deleted Clauses" << setw(15) << clauseStats.deletedClauseCount << endl;
 
   switch (stats.outcome)
   {
+  case OPTIMUM_FOUND:
+	if (displaySolution)
+	{
+	  cout << "v ";
+	  s.printBestModel();
+	}
+	if (opbFormat) s.checkModel();
+	zap::global_vars.result = zap::SAT;
+	cout << "s OPTIMUM FOUND" << endl;
+	break;
   case SATISFIABLE:
 	if (displaySolution)
 	{
 	  cout << "v ";
-	  s.printAssignment();
+	  if (s.hasObjective()) s.printBestModel();   // timed out before proving optimality
+	  else s.printAssignment();
 	}
+	if (opbFormat) s.checkModel();
 	zap::global_vars.result = zap::SAT;
 	cout << "s SATISFIABLE" << endl;
 	break;
@@ -13,7 +13,7 @@
 
 AnnotatedLiteral DPLLSolver::upt_local_select_branch()   // UP testing has a setting that allows the solver to read
 {                                                    // branch decisions from a file.  If this setting is off
-  AnnotatedLiteral l = select_branch(upt_assignment);// then call the method local to this solver called
+  AnnotatedLiteral l = select_branch(upt_assignment,upt_context);// then call the method local to this solver called
   return AnnotatedLiteral(Literal(l.variable(),l.sign()));   // select_branch.
 }
 
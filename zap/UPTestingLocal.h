@@ -5,14 +5,16 @@
 
 */
 #include "UPTesting.h"
+#include "solver.h"
 using namespace zap;
 
 class DPLLSolver : public virtual UPTestingInterface
 {
   Assignment    upt_assignment;
   ClauseSet*    upt_clause_set;
+  SolverContext upt_context;
 public:
-  DPLLSolver(ClauseSet* c) : upt_clause_set(c)
+  DPLLSolver(ClauseSet* c) : upt_clause_set(c), upt_context(LUBY_UNIT,rand())
   { upt_assignment.initialize(upt_clause_set->number_variables(),&upt_clause_set->VSIDS_counts()); }
   
   AnnotatedLiteral upt_local_select_branch();
@@ -0,0 +1,277 @@
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <deque>
+#include <algorithm>
+#include "cubes.h"
+
+
+
+/////////////////////////////////////////   LOOKAHEAD   //////////////////////////////////////////////
+
+
+class MoreOccurrences {
+  const vector<size_t>& m_count;
+public:
+  MoreOccurrences(const vector<size_t>& c) : m_count(c) { }
+  bool operator()(Variable a, Variable b) const { return m_count[a] > m_count[b]; }
+};
+
+
+CubeSplitter::CubeSplitter(Cnf& C) : m_cnf(C), m_refuted(0)
+{
+  vector<size_t> count(C.number_variables()+1,0);
+  for (size_t i=0; i < C.number_clauses(); i++) {
+	const CnfClause c = C[i];
+	for (size_t j=0; j < c.size(); j++) count[c[j].variable()]++;
+  }
+  for (Variable v=1; v <= C.number_variables(); v++) m_candidates.push_back(v);
+  stable_sort(m_candidates.begin(),m_candidates.end(),MoreOccurrences(count));
+}
+
+
+
+// make l a new branch decision and propagate it.  false if we hit a contradiction.  Either way
+// the caller has to undo the decision.
+bool CubeSplitter::decide(Assignment& P, Literal l)
+{
+  P.extend(AnnotatedLiteral(l));
+  return unit_propagate(m_cnf,P) != CONTRADICTION;
+}
+
+
+
+// how many assignments does l force (counting itself)?  false if l is a failed literal
+bool CubeSplitter::probe(Assignment& P, Literal l, size_t& implied)
+{
+  size_t before = P.size();
+  bool ok = decide(P,l);
+  implied = P.size() - before;
+  P.undo_current_decision();
+  return ok;
+}
+
+
+
+void CubeSplitter::split(Assignment& P, vector<Literal>& cube, size_t depth)
+{
+  if (depth == 0 || P.full()) {
+	m_cubes.push_back(cube);
+	return;
+  }
+
+  Literal best;
+  double best_score = -1;
+  size_t tried = 0;
+  for (size_t i=0; i < m_candidates.size() && tried < LOOKAHEAD_CANDIDATES; i++) {
+	Variable v = m_candidates[i];
+	if (P.value(v) != UNKNOWN) continue;
+	++tried;
+
+	size_t pos, neg;
+	bool pos_ok = probe(P,Literal(v,true),pos);
+	bool neg_ok = probe(P,Literal(v,false),neg);
+	if (!pos_ok && !neg_ok) {          // no solutions down here
+	  m_refuted++;
+	  return;
+	}
+	if (!pos_ok || !neg_ok) {          // a failed literal, so the other value is forced
+	  Literal forced(v,pos_ok);
+	  cube.push_back(forced);
+	  if (decide(P,forced)) split(P,cube,depth);
+	  else m_refuted++;
+	  P.undo_current_decision();
+	  cube.pop_back();
+	  return;
+	}
+	
+	double score = (double)pos * neg;
+	if (score > best_score) {
+	  best_score = score;
+	  best = Literal(v,pos >= neg);    // the side that forces more goes first
+	}
+  }
+  
+  if (tried == 0) {
+	m_cubes.push_back(cube);
+	return;
+  }
+
+  Literal branch[2] = { best, best.negate() };
+  for (size_t i=0; i < 2; i++) {
+	cube.push_back(branch[i]);
+	if (decide(P,branch[i])) split(P,cube,depth-1);
+	else m_refuted++;
+	P.undo_current_decision();
+	cube.pop_back();
+  }
+}
+
+
+
+const vector<vector<Literal> >& CubeSplitter::cubes(size_t number_cubes)
+{
+  m_cubes.clear();
+  m_refuted = 0;
+
+  size_t depth = 0;
+  while (((size_t)1 << depth) < number_cubes) ++depth;
+
+  Assignment P(m_cnf.number_variables(),&m_cnf.VSIDS_counts());
+  if (unit_propagate(m_cnf,P) == CONTRADICTION) {
+	m_refuted++;
+	return m_cubes;
+  }
+  vector<Literal> cube;
+  split(P,cube,depth);
+  return m_cubes;
+}
+
+
+
+///////////////////////////////////////////   CONQUER   //////////////////////////////////////////////
+
+/*  The worker threads.  Like the portfolio workers (see portfolio.cpp) they copy the main thread's
+    settings into their own global_vars before they start.  Here each worker's statistics are added
+    into the main thread's when it's done, since they all did a share of the work.
+ */
+
+class CubePool
+{
+  const Cnf&                       m_cnf;
+  const vector<vector<Literal> >&  m_cubes;
+  GlobalVars*                      m_main_vars;
+  vector<std::deque<size_t> >      m_queues;        // indexes into m_cubes, one queue per worker
+  vector<std::mutex>               m_queue_locks;
+  std::atomic<bool>                m_stop;
+  ClauseExchange                   m_exchange;
+  std::mutex                       m_mutex;         // guards the rest of this, and cout
+  std::condition_variable          m_finished;
+  size_t                           m_running;       // workers that haven't finished
+  size_t                           m_number_refuted;
+  bool                             m_satisfiable;
+  vector<bool>                     m_model;         // from the satisfiable cube
+
+  bool next_cube(size_t worker, size_t& cube);
+  void run(size_t worker, unsigned seed);
+
+public:
+  CubePool(const Cnf& C, const vector<vector<Literal> >& cubes, size_t number_threads)
+	: m_cnf(C), m_cubes(cubes), m_main_vars(&global_vars), m_queues(number_threads),
+	  m_queue_locks(number_threads), m_stop(false), m_running(0), m_number_refuted(0),
+	  m_satisfiable(false) { }
+
+  Outcome solve();
+  vector<bool>& model() { return m_model; }
+};
+
+
+
+// the front of our own queue, or failing that the back of somebody else's
+bool CubePool::next_cube(size_t worker, size_t& cube)
+{
+  {
+	std::lock_guard<std::mutex> lock(m_queue_locks[worker]);
+	if (!m_queues[worker].empty()) {
+	  cube = m_queues[worker].front();
+	  m_queues[worker].pop_front();
+	  return true;
+	}
+  }
+  for (size_t i=1; i < m_queues.size(); i++) {
+	size_t victim = (worker + i) % m_queues.size();
+	std::lock_guard<std::mutex> lock(m_queue_locks[victim]);
+	if (!m_queues[victim].empty()) {
+	  cube = m_queues[victim].back();
+	  m_queues[victim].pop_back();
+	  return true;
+	}
+  }
+  return false;
+}
+
+
+
+void CubePool::run(size_t worker, unsigned seed)
+{
+  global_vars.copy_settings(*m_main_vars);     // our counters start from zero
+  global_vars.time_out = 0;                    // the main thread keeps the clock
+  global_vars.start_time = get_cpu_time();
+  global_vars.worker = worker;
+
+  Cnf C(m_cnf);
+  if (global_vars.share_size_bound > 0) C.share_clauses(&m_exchange,worker);
+
+  size_t cube;
+  while (!m_stop && next_cube(worker,cube)) {
+	SolverContext ctx(LUBY_UNIT,seed + cube);
+	ctx.stop = &m_stop;
+	ctx.assumptions = m_cubes[cube];
+	Outcome result = ::solve(C,ctx);
+	
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (result == SAT && !m_satisfiable) {
+	  m_satisfiable = true;
+	  m_model.swap(ctx.model);
+	  m_stop = true;
+	  cout << "// cube " << cube << " is satisfiable" << endl;
+	  m_finished.notify_all();
+	}
+	else if (result == UNSAT) {
+	  ++m_number_refuted;
+	  cout << "// cube " << cube << " refuted (" << m_number_refuted << " of " << m_cubes.size() << ")" << endl;
+	}
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_main_vars->add_statistics(global_vars);
+  --m_running;
+  m_finished.notify_all();
+}
+
+
+
+Outcome CubePool::solve()
+{
+  if (m_cubes.empty()) return UNSAT;   // the lookahead refuted everything
+  
+  for (size_t i=0; i < m_cubes.size(); i++) m_queues[i % m_queues.size()].push_back(i);
+  m_running = m_queues.size();
+
+  unsigned seed = rand();
+  std::vector<std::thread> workers;
+  for (size_t i=0; i < m_queues.size(); i++)
+	workers.push_back(std::thread(&CubePool::run, this, i, seed));
+
+  {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	double time_out = m_main_vars->time_out;
+	if (time_out > 0.0) {
+	  time_out -= get_wall_time() - m_main_vars->start_time;   // the lookahead took some of it
+	  m_finished.wait_for(lock, std::chrono::duration<double>(std::max(time_out,0.0)),
+						  [this] { return m_satisfiable || m_running == 0; });
+	}
+	else
+	  m_finished.wait(lock, [this] { return m_satisfiable || m_running == 0; });
+	m_stop = true;
+  }
+
+  for (size_t i=0; i < workers.size(); i++) workers[i].join();
+  
+  if (m_satisfiable) return SAT;
+  if (m_number_refuted == m_cubes.size()) return UNSAT;
+  return TIME_OUT;
+}
+
+
+
+// global_vars.start_time should be the wall clock time we started the lookahead
+Outcome solve_cubes(const Cnf& C, const vector<vector<Literal> >& cubes, size_t number_threads,
+					vector<bool>& model)
+{
+  CubePool pool(C,cubes,std::max(number_threads,(size_t)1));
+  Outcome result = pool.solve();
+  model.swap(pool.model());
+  return result;
+}
@@ -0,0 +1,52 @@
+#ifndef __CUBES__
+#define __CUBES__
+#include "Cnf.h"
+#include "solver.h"
+
+#define LOOKAHEAD_CANDIDATES  20    // variables we try at each node of the lookahead tree
+
+
+/*  Cube and conquer.  We split the problem into a lot of small subproblems (cubes) and then
+    solve the cubes on a pool of threads.
+
+    A cube is a conjunction of literals, the path to a leaf of a shallow search tree.  We build the
+    tree with lookahead.  At each node we try both values of a handful of the variables that appear
+    in the most clauses, and propagate each one.  We branch on the variable whose two values
+    together force the most other assignments (the product of the two counts, as in march).  If
+    one value of a variable leads straight to a contradiction (a failed literal), the other value
+    is forced and goes into the cube without a branch.  If both values fail, nothing under the node
+    can be a solution and it doesn't produce a cube at all.  The tree stops at the depth that gives
+    about the number of cubes asked for (-k).
+
+    Each worker thread has its own copy of the Cnf and solves one cube after another with the cube
+    as assumptions (see SolverContext), keeping its learned clauses from one cube to the next.
+    Workers also share learned clauses the way the portfolio workers do.  The cubes are dealt out
+    to the workers up front and a worker that runs out steals from the back of somebody else's
+    queue.  Refuted cubes are reported as they finish, and the first satisfiable cube stops
+    everybody.
+ */
+
+class CubeSplitter
+{
+  Cnf&                       m_cnf;
+  vector<Variable>           m_candidates;   // every variable, most frequently occurring first
+  vector<vector<Literal> >   m_cubes;
+  size_t                     m_refuted;      // nodes the lookahead itself proved UNSAT
+
+  bool  probe(Assignment& P, Literal l, size_t& implied);
+  bool  decide(Assignment& P, Literal l);
+  void  split(Assignment& P, vector<Literal>& cube, size_t depth);
+
+public:
+  CubeSplitter(Cnf& C);
+
+  const vector<vector<Literal> >&  cubes(size_t number_cubes);
+  size_t                           number_refuted() const { return m_refuted; }
+};
+
+
+// model is the satisfiable cube's model when the answer is SAT
+Outcome solve_cubes(const Cnf& C, const vector<vector<Literal> >& cubes, size_t number_threads,
+					vector<bool>& model);
+
+#endif
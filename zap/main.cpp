@@ -1,36 +1,165 @@
 #include <iomanip>
+#include <typeinfo>
 #include "UPTesting.h"
 #include "Cnf.h"
 #include "UPTestingLocal.h"
 #include "solver.h"
+#include "portfolio.h"
+#include "cubes.h"
 #include "Converter.h"
+#include "CnfPreprocessor.h"
+#include "CnfRenumbering.h"
 
 using namespace zap;
 
 
+// the threaded solvers copy the clause set for each thread, which we only know how to do for plain Cnfs
+Cnf* plain_cnf(ClauseSet* clauses, const string& mode)
+{
+  if (typeid(*clauses) != typeid(Cnf)) quit(mode + " needs a CNF clause set (-c 0)");
+  return dynamic_cast<Cnf*>(clauses);
+}
+
+
+// preprocessing and renumbering change the clauses, so we make sure the model we hand back solves the input
+void check_model(const Cnf& cnf, const vector<bool>& model)
+{
+  for (size_t i=0; i < cnf.number_clauses(); i++) {
+	const CnfClause c = cnf[i];
+	bool satisfied = false;
+	for (size_t j=0; j < c.size() && !satisfied; j++) satisfied = (model[c[j].variable()] == c[j].sign());
+	if (!satisfied) quit("the model doesn't satisfy input clause " + to_string(i));
+  }
+  cout << "// model checked against the input clauses" << endl;
+}
+
+
+// the solver's model is in the renumbered variables of the simplified problem
+void finish_model(vector<bool>& model, const CnfRenumbering* renumbering,
+				  const CnfPreprocessor* preprocessor, const Cnf* input_cnf)
+{
+  if (renumbering) renumbering->restore_model(model);
+  if (preprocessor) preprocessor->extend_model(model);
+  if (input_cnf) check_model(*input_cnf,model);
+}
+
+
 int main(int argc, char **argv){
    
    cout << "// heidi_sat " << endl;
    if (argc < 2) exit(0);
 
    cout << "// parsing problem " << argv[1] << endl;
-   InputTheory input = parse_input(argc,argv);
-   ClauseSetBuilder builder(input);
-   ClauseSet* clauses = builder.convert_to(global_vars.desired_type);
+   read_testing_params(argc,argv);
+   Cnf dimacs;
+   ClauseSetBuilder* builder = NULL;
+   ClauseSet* clauses = &dimacs;
+   if (use_dimacs_reader(argv[1])) read_dimacs(argv[1],dimacs);
+   else {
+	  InputTheory input = parse_file(argv[1]);
+	  PhaseTimer timer(global_vars.phase_time[PHASE_CONVERT]);
+	  builder = new ClauseSetBuilder(input);
+	  clauses = builder->convert_to(global_vars.desired_type);
+   }
    if (clauses == NULL) quit("Couldn't build PFS clause set");
 
+   ProofWriter* proof = NULL;   // the clause set writes the lemmas, we add the empty clause
+   if (global_vars.proof_file.size()) {
+	  if (global_vars.dpll || global_vars.number_cubes > 0 || global_vars.number_threads > 1)
+		quit("proofs (-p) need the regular sequential solver");
+	  plain_cnf(clauses,"writing a proof (-p)");
+	  proof = new ProofWriter(global_vars.proof_file);
+   }
+
+   // simplify plain CNFs, see CnfPreprocessor.h.  UP testing wants the clauses as they are.
+   Cnf simplified;
+   const Cnf* input_cnf = NULL;
+   CnfPreprocessor* preprocessor = NULL;
+   if (global_vars.preprocess && !global_vars.dpll && typeid(*clauses) == typeid(Cnf)) {
+	  input_cnf = dynamic_cast<Cnf*>(clauses);
+	  preprocessor = new CnfPreprocessor(input_cnf->number_variables(),proof);
+	  preprocessor->add_clauses(*input_cnf);
+	  Result r = preprocessor->simplify();
+	  preprocessor->print_statistics(cout);
+	  if (r == CONTRADICTION) {
+		 if (proof) proof->add(NULL,0);
+		 delete proof;
+		 global_vars.result = UNSAT;
+		 output_solver_stats();
+		 output_result(global_vars.result);
+		 return 0;
+	  }
+	  preprocessor->build(simplified);
+	  clauses = &simplified;
+   }
+
+   // renumber the variables for locality, see CnfRenumbering.h.  Models and proofs use the old numbers.
+   Cnf renumbered;
+   CnfRenumbering* renumbering = NULL;
+   if (global_vars.renumber && typeid(*clauses) == typeid(Cnf)) {
+	  const Cnf* cnf = dynamic_cast<Cnf*>(clauses);
+	  if (!input_cnf) input_cnf = cnf;
+	  renumbering = new CnfRenumbering(*cnf);
+	  renumbering->print_statistics(cout);
+	  if (renumbering->improves()) {
+		 renumbering->rename_atoms();
+		 renumbering->build(*cnf,renumbered);
+		 clauses = &renumbered;
+		 if (proof) proof->map_variables(&renumbering->old_variables());
+	  }
+	  else {
+		 delete renumbering;
+		 renumbering = NULL;
+	  }
+   }
+   if (proof) plain_cnf(clauses,"writing a proof (-p)")->log_proof(proof);
+
    cout << "// solving problem " << argv[1] << endl;
 
    if (global_vars.dpll) {  ///  UP Testing
 	  DPLLSolver solver(clauses);
 	  solver.upt_dpll();
    }
+   else if (global_vars.number_cubes > 0) {  /// cube and conquer
+	  Cnf* cnf = plain_cnf(clauses,"cube and conquer (-k)");
+	  global_vars.start_time = get_wall_time();
+	  CubeSplitter splitter(*cnf);
+	  const vector<vector<Literal> >& cubes = splitter.cubes(global_vars.number_cubes);
+	  cout << "// lookahead: " << cubes.size() << " cubes, " << splitter.number_refuted()
+		   << " refuted during lookahead" << endl;
+	  vector<bool> model;
+	  global_vars.result = solve_cubes(*cnf, cubes, global_vars.number_threads, model);
+	  global_vars.solution_time = get_wall_time() - global_vars.start_time;
+	  if (global_vars.result == SAT) finish_model(model,renumbering,preprocessor,input_cnf);
+	  output_solver_stats();
+	  output_result(global_vars.result);
+   }
+   else if (global_vars.number_threads > 1) {  /// portfolio of solvers on separate threads
+	  Cnf* cnf = plain_cnf(clauses,"portfolio mode (-j)");
+	  size_t winner = 0;
+	  vector<bool> model;
+	  global_vars.start_time = get_wall_time();
+	  global_vars.result = solve_portfolio(*cnf, global_vars.number_threads, winner, model);
+	  global_vars.solution_time = get_wall_time() - global_vars.start_time;
+	  if (global_vars.result == SAT) finish_model(model,renumbering,preprocessor,input_cnf);
+	  if (global_vars.result != TIME_OUT)
+		cout << "// portfolio: worker " << winner << " of " << global_vars.number_threads << " finished first" << endl;
+	  output_solver_stats();
+	  output_result(global_vars.result);
+   }
    else {  /// regular call to solver
 	  global_vars.start_time = get_cpu_time();
-	  global_vars.result = solve(*clauses);
+	  SolverContext ctx(LUBY_UNIT,rand());   // the seed comes from srand (-e on the command line)
+	  global_vars.result = solve(*clauses,ctx);
+	  if (proof && global_vars.result == UNSAT) proof->add(NULL,0);
+	  delete proof;
 	  global_vars.solution_time = get_cpu_time() - global_vars.start_time;
+	  if (global_vars.result == SAT) finish_model(ctx.model,renumbering,preprocessor,input_cnf);
 	  output_solver_stats();
 	  output_result(global_vars.result);
    }
+   delete renumbering;
+   delete preprocessor;
+   delete builder;
 }
 
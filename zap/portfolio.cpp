@@ -0,0 +1,120 @@
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include "portfolio.h"
+
+
+/*  Shared by the main thread and the workers.  global_vars is thread_local, so each worker
+    copies the main thread's settings in before it starts and the winner adds its statistics
+    (and hands its model) back out.  Every worker shares clauses, so the losers add their sharing
+    counters as well.  The main thread doesn't touch its global_vars again until it has joined
+    all of the workers.
+ */
+
+class Portfolio
+{
+  const Cnf&               m_cnf;
+  GlobalVars*              m_main_vars;
+  std::atomic<bool>        m_stop;
+  ClauseExchange           m_exchange;      // learned clauses the workers pass to each other
+  std::mutex               m_mutex;
+  std::condition_variable  m_finished;
+  bool                     m_have_result;
+  Outcome                  m_outcome;
+  size_t                   m_winner;
+  vector<bool>             m_model;         // the winner's, if it found one
+
+  void run(size_t worker, unsigned seed);
+
+public:
+  Portfolio(const Cnf& C) : m_cnf(C), m_main_vars(&global_vars), m_stop(false),
+							m_have_result(false), m_outcome(TIME_OUT), m_winner(0) { }
+
+  Outcome solve(size_t number_threads);
+  size_t winner() const { return m_winner; }
+  vector<bool>& model() { return m_model; }
+};
+
+
+
+SolverContext portfolio_context(size_t worker, unsigned seed)
+{
+  static const size_t luby_units[] = { LUBY_UNIT, 256, 1024, 128, 2048, 64 };
+  static const size_t number_units = sizeof(luby_units) / sizeof(luby_units[0]);
+
+  SolverContext ctx(luby_units[worker % number_units], seed + worker);
+  if (worker == 0) return ctx;
+  ctx.negative_branches = (worker % 2 == 1);
+  ctx.random_branch_rate = 10 * ((worker / 2) % 4);   // 0% to 3% of decisions are random
+  return ctx;
+}
+
+
+
+void Portfolio::run(size_t worker, unsigned seed)
+{
+  global_vars.copy_settings(*m_main_vars);   // our counters start from zero
+  global_vars.time_out = 0;             // the main thread keeps the clock
+  global_vars.start_time = get_cpu_time();
+  global_vars.worker = worker;
+
+  Cnf C(m_cnf);
+  if (global_vars.share_size_bound > 0) C.share_clauses(&m_exchange,worker);
+  SolverContext ctx = portfolio_context(worker, seed);
+  ctx.stop = &m_stop;
+
+  Outcome result = ::solve(C, ctx);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (result == CANCELLED || m_have_result) {
+	m_main_vars->add_sharing_statistics(global_vars);
+	return;
+  }
+  m_have_result = true;
+  m_outcome = result;
+  m_winner = worker;
+  m_model.swap(ctx.model);
+  m_main_vars->add_statistics(global_vars);
+  m_stop = true;
+  m_finished.notify_all();
+}
+
+
+
+Outcome Portfolio::solve(size_t number_threads)
+{
+  unsigned seed = rand();
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < number_threads; i++)
+	workers.push_back(std::thread(&Portfolio::run, this, i, seed));
+
+  {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	double time_out = m_main_vars->time_out;
+	if (time_out > 0.0)
+	  m_finished.wait_for(lock, std::chrono::duration<double>(time_out), [this] { return m_have_result; });
+	else
+	  m_finished.wait(lock, [this] { return m_have_result; });
+
+	if (!m_have_result) {   // nobody finished in time, don't let a late worker claim the result
+	  m_have_result = true;
+	  m_outcome = TIME_OUT;
+	}
+	m_stop = true;
+  }
+
+  for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+  return m_outcome;
+}
+
+
+
+Outcome solve_portfolio(const Cnf& C, size_t number_threads, size_t& winner, vector<bool>& model)
+{
+  Portfolio portfolio(C);
+  Outcome result = portfolio.solve(number_threads);
+  winner = portfolio.winner();
+  model.swap(portfolio.model());
+  return result;
+}
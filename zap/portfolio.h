@@ -0,0 +1,24 @@
+#ifndef __PORTFOLIO__
+#define __PORTFOLIO__
+#include "Cnf.h"
+#include "solver.h"
+
+/*  Portfolio mode.  We run several copies of the solver on the same problem, each on its own
+    thread with its own copy of the clause set.  The copies differ in their random seed, restart
+    schedule and branching settings, so they tend to take quite different routes through the
+    search.  The first one to come back with SAT or UNSAT wins and the rest are told to stop.
+    Worker 0 always runs with the sequential solver's settings.
+
+    The workers also share short learned clauses through a ClauseExchange (see Cnf.h), so a
+    clause one of them pays for in search can prune the others' searches too.  -w and -g on the
+    command line set the size and lbd limits on what gets shared.
+
+    Only plain Cnf clause sets are supported for now.  Pfs and SymRes share state with the
+    converter that built them and can't simply be copied.
+ */
+
+// model is the winner's model when the answer is SAT
+Outcome solve_portfolio(const Cnf& C, size_t number_threads, size_t& winner, vector<bool>& model);
+SolverContext portfolio_context(size_t worker, unsigned seed);
+
+#endif
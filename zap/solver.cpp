@@ -2,7 +2,9 @@
 #include "common.h"
 #include "front_end.h"
 #include "UPTesting.h"
+#include "solver.h"
 #include <cmath>
+#include <cstdlib>
 using namespace zap;
 
 bool debug = false;
@@ -52,26 +54,22 @@ bool debug = false;
     branch decisions.
 */
 
-#define LUBY_UNIT  512
-size_t number_restarts = 0;
-long long unsigned int restart_threshold = LUBY_UNIT;
-
-size_t get_luby(size_t i)
+size_t get_luby(size_t i, size_t unit)
 {
-  if (i==1) return LUBY_UNIT;
+  if (i==1) return unit;
   double k = log2(i+1);
 
-  if (k==round(k)) return (size_t)(pow(2,k-1))*LUBY_UNIT;
+  if (k==round(k)) return (size_t)(pow(2,k-1))*unit;
   else {
     k = (size_t)floor(k);
-    return get_luby(i-(size_t)pow(2,k)+1);
+    return get_luby(i-(size_t)pow(2,k)+1,unit);
   }
 }
 
-void update_restart_parameters()
+void update_restart_parameters(SolverContext& ctx)
 {
-  ++number_restarts;
-  restart_threshold = global_vars.number_branch_decisions + get_luby(number_restarts+1);
+  ++ctx.number_restarts;
+  ctx.restart_threshold = global_vars.number_branch_decisions + get_luby(ctx.number_restarts+1,ctx.luby_unit);
 }
 
 
@@ -80,7 +78,7 @@ void update_restart_parameters()
 
 
 
-AnnotatedLiteral select_branch(Assignment& P)
+AnnotatedLiteral select_branch(Assignment& P, SolverContext& ctx)
 {
   global_vars.number_branch_decisions++;
 
@@ -90,8 +88,12 @@ AnnotatedLiteral select_branch(Assignment& P)
 	P.print_positive();
 	l = P.user_input_literal();
   }
-  else if (global_vars.branching_heuristic_on) l = P.vsids_literal();  // consult global variable to see which heuristic
-  else l = P.random_unvalued_literal();                           // to use.
+  else {
+	bool random = !global_vars.branching_heuristic_on ||      // consult global variable and the context to see
+	  (ctx.random_branch_rate && (unsigned)(rand_r(&ctx.seed) % 1000) < ctx.random_branch_rate);  // which heuristic
+	l = (random ? P.random_unvalued_literal(&ctx.seed) : P.vsids_literal());                      // to use.
+	if (ctx.negative_branches) l = l.negate();
+  }
 
   if (debug) cout <<  "branching on literal " << l << endl;
   
@@ -100,11 +102,31 @@ AnnotatedLiteral select_branch(Assignment& P)
 
 
 
+// Assumptions are made as the first branch decisions, in order, skipping any P already satisfies.
+// Branch decisions of our own only come after all of them, so if P falsifies an assumption it follows
+// from C and the earlier assumptions and there's no solution under the assumptions.
+Result next_assumption(const Assignment& P, const SolverContext& ctx, Literal& a)
+{
+  a = Literal();
+  for (size_t i=0; i < ctx.assumptions.size(); i++) {
+	size_t value = P.value(ctx.assumptions[i].variable());
+	if (value == UNKNOWN) {
+	  a = ctx.assumptions[i];
+	  return SUCCESS;
+	}
+	if (value != (size_t)ctx.assumptions[i].sign()) return FAILURE;
+  }
+  return SUCCESS;
+}
+
+
+
 Result unit_propagate(ClauseSet& C, Assignment& P)
 {
-  if (P.empty()) C.load_unit_literals(P);            // when we start, P is valid and decision minimal with
-                                                     // respect to C, but may not be closed.  Here we compute
-  while (!P.closed()) {                              // the closure.  If we make P invalid we return CONTRADICTION.
+  if (P.empty() && C.load_unit_literals(P) == CONTRADICTION)  // when we start, P is valid and decision minimal
+    return CONTRADICTION;                            // with respect to C (unless C has units x and -x), but
+                                                     // may not be closed.  Here we compute the closure.
+  while (!P.closed()) {                              // If we make P invalid we return CONTRADICTION.
     Literal l = P.pop_unit_list();
     if (C.get_implications(P,l) == CONTRADICTION) 
       return CONTRADICTION;
@@ -122,6 +144,7 @@ Result learn_and_backjump(ClauseSet& C, Assignment& P)
   size_t lits_this_level;
   Literal unit_lit;
   ClauseID c_id = NULL_ID;
+  size_t level = 0;
 
   do {
 	do {
@@ -137,15 +160,20 @@ Result learn_and_backjump(ClauseSet& C, Assignment& P)
 	  if (c.empty()) return FAILURE; 
 	  
 	  size_t merge_size = c.merge_size;               // merging/factoring that occured when generating the clause
-	  AnnotatedLiteral new_lit(unit_lit,Reason(c_id,c));  // the most recently bound literal is unit
+	  AnnotatedLiteral new_lit(unit_lit,Reason(c_id));    // the most recently bound literal is unit
 	  P.extend(new_lit);	  
-	  if (lits_this_level <= 1) C.add_learned_clause(c_id,P);
+	  if (lits_this_level <= 1) {              // c is gone once the clause set has added it
+		level = P.assertion_level(c);
+		global_vars.learned_sizes.add(c.size());
+		C.add_learned_clause(c_id,P);
+	  }
 	  
 	} while (lits_this_level > 1);             // stop when we have a UIP clause
 	
         if (debug) cout << "backjumping " << endl;
 
-	P.backjump(P.assertion_level(C.clause(c_id)));
+	global_vars.backjump_distances.add(P.current_level() - level);
+	P.backjump(level);
   } while (!C.get_symmetric_unit_lits(P,c_id,unit_lit));
   
   if (debug) cout << " done backing up " << endl << P << endl;
@@ -155,37 +183,71 @@ Result learn_and_backjump(ClauseSet& C, Assignment& P)
 
 
 Outcome solve(ClauseSet& C)
+{
+  SolverContext ctx(LUBY_UNIT,rand());   // the seed comes from srand (-e on the command line)
+  return solve(C,ctx);
+}
+
+
+Outcome solve(ClauseSet& C, SolverContext& ctx)
 {
   GlobalVars& gv = global_vars;
   Assignment P(C.number_variables(),&C.VSIDS_counts());  // The empty assignment is trivially valid and minimal
                                                          // but possibly not closed.  We start with UP to close it.
 
   
+  size_t propagations = 0;
   while (!P.full()) {
-    if (unit_propagate(C,P) == CONTRADICTION) {         // At this point P is closed and decision minimal but
-                                                        // invalid.  Learning and backjumping make P valid again.
-      if (learn_and_backjump(C,P) == FAILURE)
+    Result r;
+    {
+      SampledPhaseTimer timer(gv.phase_time[PHASE_PROPAGATE],propagations);
+      r = unit_propagate(C,P);
+    }
+    if (r == CONTRADICTION) {                           // At this point P is closed and decision minimal but
+      Result learned;                                   // invalid.  Learning and backjumping make P valid again.
+      {
+	PhaseTimer timer(gv.phase_time[PHASE_ANALYZE]);
+	learned = learn_and_backjump(C,P);
+      }
+      if (learned == FAILURE)
 	return UNSAT;
+      check_progress();
     } 
     else {
       if (gv.time_out > 0.0 && gv.time_out < (get_cpu_time() - gv.start_time))  
 	return TIME_OUT;
       if (sample_size && gv.number_branch_decisions >= sample_size) return SAMPLE_FINISHED;  
+      if (ctx.stopped()) return CANCELLED;
 
       if (gv.restarts_on) {
-	if (restart_threshold && gv.number_branch_decisions >= restart_threshold) {  // restart
+	if (ctx.restart_threshold && gv.number_branch_decisions >= ctx.restart_threshold) {  // restart
 	  while (P.current_level() > 0) P.undo_current_decision();
-	  update_restart_parameters();
+	  update_restart_parameters(ctx);
 	}
       }
 
-      if (gv.forget_clauses_on)
+      if (P.current_level() == 0) {                     // pick up what the other solvers have learned
+	if (C.import_shared_clauses(P) == CONTRADICTION)    // (portfolio and cube modes)
+	  return UNSAT;
+	if (!P.closed()) continue;                      // propagate any new units before we branch
+      }
+
+      if (gv.forget_clauses_on) {
+	PhaseTimer timer(gv.phase_time[PHASE_REDUCE]);
 	C.reduce_knowledge_base(P);                       // if we've learned more than we can manage, delete some stuff
+      }
       
-      AnnotatedLiteral l = select_branch(P);            // before branching, P is valid, closed and decision_minimal
-      P.extend(l);                                      // in relation to C.
+      Literal a;                                        // before branching, P is valid, closed and decision_minimal
+      if (next_assumption(P,ctx,a) == FAILURE)          // in relation to C.  Any assumptions come before our own
+	return UNSAT;                                   // branch decisions.
+      P.extend(a != Literal() ? AnnotatedLiteral(a) : select_branch(P,ctx));
     }
   }
+  
+  Literal a;
+  if (next_assumption(P,ctx,a) == FAILURE) return UNSAT;  // P can fill up without us deciding an assumption
+  ctx.model.assign(C.number_variables() + 1,false);
+  for (Variable v=1; v <= C.number_variables(); v++) ctx.model[v] = (P.value(v) == 1);
   return SAT;  
 }
 
@@ -1,9 +1,44 @@
 #ifndef __HEIDI_SAT__
 #define __HEIDI_SAT__
+#include <atomic>
+#include "ClauseSet.h"
 using namespace zap;
 
+#define LUBY_UNIT  512
+
+
+/*  Everything that belongs to one run of the solver and isn't part of the clause set or the
+    assignment.  The restart schedule used to live in file-scope globals.  Keeping it here lets
+    several solvers run side by side on different threads (see portfolio.h), each one with its
+    own random seed, restart schedule and branching settings.  The defaults give the plain
+    sequential solver.  With assumptions, solve answers UNSAT when there's no solution that
+    makes all of them true.
+ */
+
+class SolverContext
+{
+public:
+  size_t                    luby_unit;           // restart schedule is luby_unit * luby sequence
+  size_t                    number_restarts;
+  long long unsigned int    restart_threshold;
+  unsigned                  seed;                // for random branch decisions (rand_r)
+  unsigned                  random_branch_rate;  // per thousand decisions made at random
+  bool                      negative_branches;   // branch on the negative literal first
+  const std::atomic<bool>*  stop;                // another solver finished, give up
+  vector<Literal>           assumptions;         // decided first and in order (see cubes.h)
+  vector<bool>              model;               // by variable, what solve found when it answers SAT
+
+  SolverContext(size_t unit = LUBY_UNIT, unsigned s = 0)
+	: luby_unit(unit), number_restarts(0), restart_threshold(unit), seed(s),
+	  random_branch_rate(0), negative_branches(false), stop(NULL) { }
+
+  bool stopped() const { return stop && stop->load(std::memory_order_relaxed); }
+};
+
+
 Outcome solve(ClauseSet& C);
+Outcome solve(ClauseSet& C, SolverContext& ctx);
 Result unit_propagate(ClauseSet& C, Assignment& P);
-AnnotatedLiteral select_branch(Assignment& P);
+AnnotatedLiteral select_branch(Assignment& P, SolverContext& ctx);
 
 #endif
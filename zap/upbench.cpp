@@ -0,0 +1,421 @@
+////////////////////////////   UP BENCHMARK  ///////////////////////////////////////////////////////////////////
+/*
+  upbench runs the UP testing framework (front_end/include/UPTesting.h) over a corpus of instances, for
+  every zap clause set type and for pbchaff, and writes one line of results per instance and solver as
+  CSV or JSON lines.  It's meant for catching unit propagation regressions before a new build goes out.
+
+  Every solver has to answer the same unit propagation queries or the numbers don't mean anything, so
+  the branch decisions come from a file.  The first time we see an instance we record them with the
+  plain CNF solver into <instance>.branches (or into the -b directory) and from then on every solver,
+  and every later build, replays that file.  Delete the file to record a new one.
+
+  Each run happens in a child process of its own.  The UP testing framework keeps its state in globals
+  and some clause sets can't handle some inputs (they quit), so this keeps one run from disturbing the
+  next and lets us report a failed run instead of dying with it.  The child does exactly what
+  zapsat -d or pbchaff would do and sends what it measured over the sample back through a pipe.
+
+  We report the median of the repetitions for queue pops per second and clause touches per second and
+  the minimum, median, 90th percentile and maximum wall clock time of the sample.  The hardware
+  counters (see PerfCounters.h) are from the median run and are left empty where we couldn't get them.
+
+  A small corpus made by the generators can be built with the upbench_corpus target
+  (see generators/CMakeLists.txt).
+*/
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <signal.h>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "UPTesting.h"
+#include "UPTestingLocal.h"
+#include "UPTestingPB.h"
+#include "Cnf.h"
+#include "Converter.h"
+
+using namespace zap;
+
+
+
+// what one child measured, sent back to the parent as raw bytes
+struct UPSample
+{
+  int                 outcome;
+  long unsigned       trials;
+  long long unsigned  queue_pops;
+  long long unsigned  clauses_touched;
+  long long unsigned  literals_touched;
+  double              cpu_time;
+  double              wall_time;
+  bool                have_counter[NUMBER_PERF_EVENTS];
+  long long unsigned  counter[NUMBER_PERF_EVENTS];
+};
+
+
+struct BenchSolver
+{
+  string         name;
+  ClauseSetType  type;       // NOT_SPECIFIED for pbchaff
+};
+
+
+struct BenchSettings
+{
+  long unsigned   trials;
+  size_t          repeats;
+  unsigned        timeout;    // seconds for one run, 0 for none
+  int             seed;
+  string          branch_dir;
+  bool            json;
+
+  BenchSettings() : trials(10000), repeats(5), timeout(0), seed(0), json(false) { }
+};
+
+
+const BenchSolver all_solvers[] = {
+  { "cnf",     CNF },
+  { "pfs",     PFS },
+  { "symres",  SYMRES },
+  { "hybrid",  HYBRID },
+  { "pbchaff", NOT_SPECIFIED }
+};
+const size_t number_solvers = sizeof(all_solvers) / sizeof(all_solvers[0]);
+
+
+
+void usage()
+{
+  cerr << "usage: upbench [options] <instance> ..." << endl
+	   << setw(20) << left << "     -z #" << "branch decisions in each run (default 10000)" << endl
+	   << setw(20) << left << "     -r #" << "runs of each solver on each instance (default 5)" << endl
+	   << setw(20) << left << "     -c <list>"
+	   << "solvers, comma separated from cnf,pfs,symres,hybrid,pbchaff (default all of them)" << endl
+	   << setw(20) << left << "     -b <dir>" << "where the branch files go (default next to the instances)" << endl
+	   << setw(20) << left << "     -e #" << "random seed for recording branch decisions" << endl
+	   << setw(20) << left << "     -t #" << "seconds before we give up on a run (default no limit)" << endl
+	   << setw(20) << left << "     -j" << "write JSON lines instead of CSV" << endl
+	   << setw(20) << left << "     -o <file>" << "write the results here instead of standard output" << endl;
+  exit(1);
+}
+
+
+
+string branch_file(const string& instance, const BenchSettings& settings)
+{
+  if (settings.branch_dir.empty()) return instance + ".branches";
+  size_t slash = instance.find_last_of('/');
+  string base = (slash == string::npos ? instance : instance.substr(slash + 1));
+  return settings.branch_dir + "/" + base + ".branches";
+}
+
+
+
+/////////////////////////////////////  ONE RUN IN A CHILD PROCESS  ///////////////////////////////////////
+
+
+// Runs in the child.  We hand read_testing_params the same flags zapsat -d would get, so the
+// branch files and the sample are set up exactly the way they are for a single run.
+void run_child(const string& instance, const BenchSolver& solver, const string& branches, bool record,
+			   const BenchSettings& settings, int out)
+{
+  int null = open("/dev/null",O_WRONLY);   // the solvers talk a lot on cout
+  if (null >= 0) dup2(null,STDOUT_FILENO);
+  if (settings.timeout) alarm(settings.timeout);
+
+  ostringstream trials, type, seed;
+  trials << settings.trials;
+  type << (solver.type == NOT_SPECIFIED ? CNF : solver.type);
+  seed << settings.seed;
+  vector<string> args;
+  args.push_back("upbench");
+  args.push_back(instance);
+  args.push_back("-d");
+  args.push_back("-z"); args.push_back(trials.str());
+  args.push_back("-c"); args.push_back(type.str());
+  args.push_back("-e"); args.push_back(seed.str());
+  args.push_back(record ? "-o" : "-i"); args.push_back(branches);
+  vector<char*> argv;
+  for (size_t i=0; i < args.size(); i++) argv.push_back(const_cast<char*>(args[i].c_str()));
+  argv.push_back(NULL);
+  int argc = (int)args.size();
+
+  UPTestingInterface* tester = NULL;
+  ClauseSetBuilder* builder = NULL;
+  Cnf dimacs;
+  if (solver.type == NOT_SPECIFIED) {
+	dimacs = read_cnf(argc,&argv[0]);
+	tester = new_pbchaff_dpll(dimacs);
+  }
+  else {
+	read_testing_params(argc,&argv[0]);
+	ClauseSet* clauses = &dimacs;
+	if (use_dimacs_reader(instance)) read_dimacs(instance,dimacs);
+	else {
+	  builder = new ClauseSetBuilder(parse_file(instance));
+	  clauses = builder->convert_to(solver.type);
+	}
+	if (clauses == NULL) quit("couldn't build the clause set");
+	tester = new DPLLSolver(clauses);
+  }
+
+  UPSample sample;
+  memset(&sample,0,sizeof(sample));
+  sample.outcome = tester->upt_dpll();
+  sample.trials = trial_count;
+  sample.queue_pops = global_vars.queue_pops;
+  sample.clauses_touched = global_vars.clauses_touched;
+  sample.literals_touched = global_vars.literals_touched;
+  sample.cpu_time = sample_finish_time - sample_start_time;
+  sample.wall_time = sample_finish_wall - sample_start_wall;
+  for (size_t i=0; i < NUMBER_PERF_EVENTS; i++) {
+	sample.have_counter[i] = sample_counters.available((PerfEvent)i);
+	sample.counter[i] = sample_counters.count((PerfEvent)i);
+  }
+  if (write(out,&sample,sizeof(sample)) != (ssize_t)sizeof(sample)) _exit(1);
+  _exit(0);   // skip the destructors, the parent has what it needs
+}
+
+
+
+// false if the run failed: the child quit, crashed, timed out or ran out of branch decisions
+bool run(const string& instance, const BenchSolver& solver, const string& branches, bool record,
+		 const BenchSettings& settings, UPSample& sample)
+{
+  int fds[2];
+  if (pipe(fds) != 0) quit("upbench: can't make a pipe");
+  cout << flush;
+  pid_t child = fork();
+  if (child < 0) quit("upbench: can't fork");
+  if (child == 0) {
+	close(fds[0]);
+	run_child(instance,solver,branches,record,settings,fds[1]);
+  }
+  close(fds[1]);
+
+  size_t got = 0;
+  char* buffer = (char*)&sample;
+  while (got < sizeof(sample)) {
+	ssize_t n = read(fds[0],buffer + got,sizeof(sample) - got);
+	if (n <= 0) break;
+	got += n;
+  }
+  close(fds[0]);
+  int status = 0;
+  waitpid(child,&status,0);
+  return got == sizeof(sample) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+
+
+/////////////////////////////////////  REPORTING  ///////////////////////////////////////////////////////
+
+
+// nearest rank, v is sorted
+double percentile(const vector<double>& v, double p)
+{
+  size_t rank = (size_t)ceil(p * v.size());
+  if (rank > 0) rank--;
+  return v[min(rank,v.size() - 1)];
+}
+
+
+const char* outcome_name(int outcome)
+{
+  switch (outcome) {
+  case UNSAT:            return "UNSAT";
+  case SAT:              return "SAT";
+  case SAMPLE_FINISHED:  return "SAMPLE_FINISHED";
+  case TIME_OUT:         return "TIME_OUT";
+  default:               return "UNKNOWN";
+  }
+}
+
+
+void write_header(ostream& os, const BenchSettings& settings)
+{
+  if (settings.json) return;
+  os << "instance,solver,status,outcome,trials,runs,queue_pops,clauses_touched,literals_touched,"
+	 << "pops_per_sec,touches_per_sec,wall_min,wall_p50,wall_p90,wall_max,cpu_p50";
+  for (size_t i=0; i < NUMBER_PERF_EVENTS; i++) os << ',' << PerfCounters::name((PerfEvent)i);
+  os << endl;
+}
+
+
+// the string fields are file names and solver names.  We escape quotes and backslashes for JSON
+// and quote CSV fields that have commas.
+string quoted(const string& s, bool json)
+{
+  if (!json && s.find_first_of(",\"") == string::npos) return s;
+  string answer = "\"";
+  for (size_t i=0; i < s.size(); i++) {
+	if (s[i] == '"') answer += (json ? "\\\"" : "\"\"");
+	else if (json && s[i] == '\\') answer += "\\\\";
+	else answer += s[i];
+  }
+  return answer + "\"";
+}
+
+
+// samples are the runs that worked, failed counts the ones that didn't
+void write_result(ostream& os, const string& instance, const BenchSolver& solver,
+				  vector<UPSample>& samples, size_t failed, const BenchSettings& settings)
+{
+  bool json = settings.json;
+  string status = (samples.empty() ? "failed" : (failed ? "partial" : "ok"));
+  vector<double> wall, cpu;
+  for (size_t i=0; i < samples.size(); i++) {
+	wall.push_back(samples[i].wall_time);
+	cpu.push_back(samples[i].cpu_time);
+  }
+  sort(wall.begin(),wall.end());
+  sort(cpu.begin(),cpu.end());
+
+  const UPSample* median = NULL;    // the run with the median wall clock time
+  for (size_t i=0; i < samples.size(); i++)
+	if (samples[i].wall_time == percentile(wall,0.5)) median = &samples[i];
+
+  ostringstream line;
+  line << setprecision(6);
+  if (json) line << "{\"instance\":" << quoted(instance,true) << ",\"solver\":" << quoted(solver.name,true)
+				 << ",\"status\":\"" << status << "\"";
+  else line << quoted(instance,false) << ',' << solver.name << ',' << status;
+
+  if (median == NULL) {
+	if (json) line << ",\"runs\":0}";
+	else {
+	  line << ",,,0";
+	  for (size_t i=0; i < 10 + NUMBER_PERF_EVENTS; i++) line << ',';
+	}
+	os << line.str() << endl;
+	return;
+  }
+
+  double p50 = percentile(wall,0.5);
+  double pops_per_sec = (p50 > 0 ? median->queue_pops / p50 : 0.0);
+  double touches_per_sec = (p50 > 0 ? median->clauses_touched / p50 : 0.0);
+  if (json) {
+	line << ",\"outcome\":\"" << outcome_name(median->outcome) << "\""
+		 << ",\"trials\":" << median->trials
+		 << ",\"runs\":" << samples.size()
+		 << ",\"queue_pops\":" << median->queue_pops
+		 << ",\"clauses_touched\":" << median->clauses_touched
+		 << ",\"literals_touched\":" << median->literals_touched
+		 << ",\"pops_per_sec\":" << pops_per_sec
+		 << ",\"touches_per_sec\":" << touches_per_sec
+		 << ",\"wall_min\":" << wall.front()
+		 << ",\"wall_p50\":" << p50
+		 << ",\"wall_p90\":" << percentile(wall,0.9)
+		 << ",\"wall_max\":" << wall.back()
+		 << ",\"cpu_p50\":" << percentile(cpu,0.5);
+	for (size_t i=0; i < NUMBER_PERF_EVENTS; i++) {
+	  line << ",\"" << PerfCounters::name((PerfEvent)i) << "\":";
+	  if (median->have_counter[i]) line << median->counter[i];
+	  else line << "null";
+	}
+	line << "}";
+  }
+  else {
+	line << ',' << outcome_name(median->outcome) << ',' << median->trials << ',' << samples.size()
+		 << ',' << median->queue_pops << ',' << median->clauses_touched << ',' << median->literals_touched
+		 << ',' << pops_per_sec << ',' << touches_per_sec
+		 << ',' << wall.front() << ',' << p50 << ',' << percentile(wall,0.9) << ',' << wall.back()
+		 << ',' << percentile(cpu,0.5);
+	for (size_t i=0; i < NUMBER_PERF_EVENTS; i++) {
+	  line << ',';
+	  if (median->have_counter[i]) line << median->counter[i];
+	}
+  }
+  os << line.str() << endl;
+}
+
+
+
+/////////////////////////////////////  MAIN  ////////////////////////////////////////////////////////////
+
+
+vector<BenchSolver> parse_solvers(const string& list)
+{
+  vector<BenchSolver> answer;
+  stringstream ss(list);
+  string name;
+  while (getline(ss,name,',')) {
+	size_t i = 0;
+	while (i < number_solvers && all_solvers[i].name != name) i++;
+	if (i == number_solvers) {
+	  cerr << "upbench: unknown solver " << name << endl;
+	  usage();
+	}
+	answer.push_back(all_solvers[i]);
+  }
+  return answer;
+}
+
+
+
+int main(int argc, char **argv)
+{
+  BenchSettings settings;
+  vector<BenchSolver> solvers(all_solvers,all_solvers + number_solvers);
+  vector<string> instances;
+  string output_file;
+
+  for (int i=1; i < argc; i++) {
+	if (argv[i][0] != '-') {
+	  instances.push_back(argv[i]);
+	  continue;
+	}
+	if (argv[i][1] != 'j' && i + 1 >= argc) usage();
+	switch (argv[i][1]) {
+	case 'z' : settings.trials = atoi(argv[++i]); break;
+	case 'r' : settings.repeats = atoi(argv[++i]); break;
+	case 'c' : solvers = parse_solvers(argv[++i]); break;
+	case 'b' : settings.branch_dir = argv[++i]; break;
+	case 'e' : settings.seed = atoi(argv[++i]); break;
+	case 't' : settings.timeout = atoi(argv[++i]); break;
+	case 'j' : settings.json = true; break;
+	case 'o' : output_file = argv[++i]; break;
+	default: usage();
+	}
+  }
+  if (instances.empty() || settings.trials == 0 || settings.repeats == 0) usage();
+
+  ofstream file;
+  if (output_file.size()) {
+	file.open(output_file.c_str());
+	if (!file) quit("upbench: can't write " + output_file);
+  }
+  ostream& os = (output_file.size() ? file : cout);
+  write_header(os,settings);
+
+  for (size_t i=0; i < instances.size(); i++) {
+	const string& instance = instances[i];
+	string branches = branch_file(instance,settings);
+	if (!ifstream(branches.c_str())) {
+	  UPSample ignored;
+	  cerr << "// recording branch decisions for " << instance << " in " << branches << endl;
+	  if (!run(instance,all_solvers[0],branches,true,settings,ignored)) {
+		cerr << "upbench: couldn't record branch decisions for " << instance << endl;
+		unlink(branches.c_str());
+		continue;
+	  }
+	}
+
+	for (size_t j=0; j < solvers.size(); j++) {
+	  if (solvers[j].type != CNF && solvers[j].type != NOT_SPECIFIED && use_dimacs_reader(instance))
+		continue;   // a dimacs file only makes a CNF
+	  vector<UPSample> samples;
+	  size_t failed = 0;
+	  for (size_t k=0; k < settings.repeats; k++) {
+		UPSample sample;
+		if (run(instance,solvers[j],branches,false,settings,sample)) samples.push_back(sample);
+		else failed++;
+	  }
+	  write_result(os,instance,solvers[j],samples,failed,settings);
+	}
+  }
+  return 0;
+}